@@ -42,6 +42,8 @@
 #include <SWAlign.h>
 #include <FSAlign.h>
 #include <SubMatrix.h>
+#include <ScoreTypePolicy.h>
+#include <Instrumentation.h>
 #include <AGPFunction.h>
 #include <VGPFunction.h>
 #include <VGPFunction2.h>
@@ -106,6 +108,12 @@ sShowHelp() {
             << "\n   [-n <int>]        \t Number of suboptimal alignments (default = 1)"
             << "\n   [-p <double>]     \t Penalty multiplier for suboptimal alignments (default = 1.00)"
             << "\n   [-a <double>]     \t Penalty subtractor for suboptimal alignments (default = 1.00)"
+            << "\n   [--st <0|...|4>]  \t Score type of the alignment matrices (default = 0, i.e. double)"
+            << "\n                     \t --st=0: double (default)."
+            << "\n                     \t --st=1: float."
+            << "\n                     \t --st=2: int32, scores are rounded to integers."
+            << "\n                     \t --st=3: int16, scores are rounded to integers."
+            << "\n                     \t --st=4: narrowest type giving the same alignment as double."
             << "\n"
             << "\n   [-m <name>]       \t Name of substitution matrix file (default = blosum62.dat)"
             << "\n   [-M <name>]       \t Name of structural substitution matrix file (default = secid.dat)"
@@ -142,6 +150,7 @@ sShowHelp() {
             << "\n   [--cStr <double>] \t Coefficient for structural alignment (default = 0.20)"
             << "\n"
             << "\n   [--verbose]       \t Verbose mode"
+            << "\n   [--stats <name>]  \t Write timers and counters as JSON at exit (needs make instrument=1)"
             << "\n" << endl;
 }
 
@@ -149,6 +158,7 @@ int
 main(int argc, char **argv) {
     string inputFileName, pro1FileName, pro2FileName, outputFileName, matrixFileName, matrixStrFileName;
     string secFileName, psi1FileName, psi2FileName, prof1FileName, prof2FileName, pdbFileName, chainID;
+    string statsFileName;
     string seq1Name, seq2Name, seq1, seq2, sec1, sec2;
     double downs, downa, ups, upa;
     double suboptPenaltyMul, suboptPenaltyAdd;
@@ -156,6 +166,7 @@ main(int argc, char **argv) {
     double weightHelix, weightStrand, weightBuried, weightStraight, weightSpace;
     double cSeq, cStr;
     unsigned int weightingScheme, scoringFunction, suboptNum, gapFunction, extensionType, structure;
+    unsigned int scoreType;
     bool fasta, global, local, freeshift, verbose;
     struct tm* newtime;
     time_t t;
@@ -189,6 +200,7 @@ main(int argc, char **argv) {
     getArg("n", suboptNum, argc, argv, 1);
     getArg("p", suboptPenaltyMul, argc, argv, 1.00);
     getArg("a", suboptPenaltyAdd, argc, argv, 1.00);
+    getArg("-st", scoreType, argc, argv, 0);
 
     getArg("m", matrixFileName, argc, argv, "blosum62.dat");
     getArg("M", matrixStrFileName, argc, argv, "secid.dat");
@@ -215,6 +227,13 @@ main(int argc, char **argv) {
     getArg("-cStr", cStr, argc, argv, 0.20);
 
     verbose = getArg("-verbose", argc, argv);
+    getArg("-stats", statsFileName, argc, argv, "!");
+
+    if (statsFileName != "!") {
+        if (!Instrumentation::isEnabled())
+            cout << "Warning: subali was built without instrumentation (make instrument=1)." << endl;
+        Instrumentation::dumpAtExit(statsFileName);
+    }
 
 
     // --------------------------------------------------
@@ -536,19 +555,46 @@ main(int argc, char **argv) {
     // 4. Calculate alignments
     // --------------------------------------------------
 
+    ScoreTypePolicy::ScoreType st;
+    switch (scoreType) {
+        case 1:
+            st = ScoreTypePolicy::FLOAT32;
+            break;
+        case 2:
+            st = ScoreTypePolicy::INT32;
+            break;
+        case 3:
+            st = ScoreTypePolicy::INT16;
+            break;
+        case 4:
+            // Suboptimal penalties are rounded on integer matrices
+            if ((pro1FileName == "!") && (str == 0) && (gapFunction == 0) &&
+                    ((suboptNum <= 1) || ((suboptPenaltyMul == 1.00) &&
+                    (suboptPenaltyAdd == floor(suboptPenaltyAdd)))))
+                st = ScoreTypePolicy::select(sub, cSeq, openGapPenalty,
+                    extensionGapPenalty, seq1.size(), seq2.size(), true);
+            else
+                st = ScoreTypePolicy::FLOAT64;
+            break;
+        default:
+            st = ScoreTypePolicy::FLOAT64;
+            break;
+    }
+    cout << "switch score type: " << ScoreTypePolicy::getName(st) << "\n";
+
     Align *a;
 
     if (global) {
         cout << "\nSuboptimal Needleman-Wunsch alignments:\n" << endl;
-        a = new NWAlign(ad, gf, ss);
+        a = ScoreTypePolicy::newAlign<NWAlignT>(st, ad, gf, ss);
     } else
         if (local) {
         cout << "\nSuboptimal Smith-Waterman alignments:\n" << endl;
-        a = new SWAlign(ad, gf, ss);
+        a = ScoreTypePolicy::newAlign<SWAlignT>(st, ad, gf, ss);
     } else {
         cout << "\nSuboptimal free-shift alignments:\n" << endl;
         try {
-            a = new FSAlign(ad, gf, ss);
+            a = ScoreTypePolicy::newAlign<FSAlignT>(st, ad, gf, ss);
         } catch (const char* a) {
             cout << "FSAlign error!\n";
         }
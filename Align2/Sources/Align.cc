@@ -29,20 +29,18 @@ namespace Victor { namespace Align2{
     // CONSTRUCTORS:
 
     Align::Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss) : ad(ad),
-    gf(gf), ss(ss), F((ad->getSequence(1)).size() + 1),
-    B((ad->getSequence(1)).size() + 1), n((ad->getSequence(1)).size()),
-    m((ad->getSequence(2)).size()), res1Pos(), res2Pos() {
-        //cout<<"building align objA\n";
-        vector<double> frow(m + 1, 0);
+    gf(gf), ss(ss), B((ad->getSequence(1)).size() + 1),
+    n((ad->getSequence(1)).size()), m((ad->getSequence(2)).size()), res1Pos(),
+    res2Pos() {
         vector<Traceback> brow(m + 1);
-        //cout<<"building align objB\n";
-        for (unsigned int i = 0; i < F.size(); ++i) {
-            F[i] = frow;
+        for (unsigned int i = 0; i < B.size(); ++i)
             B[i] = brow;
-        }
-        //cout<<"building align objC\n";
+        ALIGN2_COUNT(BYTES_ALLOCATED, (n + 1) * (m + 1) * sizeof (Traceback));
         setPenalties(0.98, 0.00);
-        //cout<<"building align objD\n";
+
+        // Structural scores are reused by every pass over the matrix
+        if (ss->str != 0)
+            ss->str->precompute(n, m);
     }
 
     Align::Align(const Align &orig) {
@@ -80,6 +78,7 @@ namespace Victor { namespace Align2{
 
     vector<string>
     Align::getMatch() const {
+        ALIGN2_TIMER(TRACEBACK);
         string res1, res2;
         res1Pos.clear();
         res2Pos.clear();
@@ -106,6 +105,7 @@ namespace Victor { namespace Align2{
             }
 
             ad->calculateMatch(i, tb.i, j, tb.j);
+            ALIGN2_COUNT(TRACEBACK_STEPS, 1);
 
             i = tb.i;
             j = tb.j;
@@ -237,14 +237,6 @@ namespace Victor { namespace Align2{
         gf = orig.gf->newCopy();
         ss = orig.ss->newCopy();
 
-        F.clear();
-        for (unsigned int i = 0; i < orig.F.size(); i++) {
-            vector<double> *tmp = new vector<double>;
-            for (unsigned int j = 0; j < orig.F[i].size(); j++)
-                tmp->push_back(orig.F[i][j]);
-            F.push_back(*tmp);
-        }
-
         B.clear();
         for (unsigned int i = 0; i < orig.B.size(); i++) {
             vector<Traceback> *tmp = new vector<Traceback>;
@@ -273,9 +265,8 @@ namespace Victor { namespace Align2{
  */
      void
     Align::recalculateMatrix() {
-        for (unsigned int i = 0; i < F.size(); i++)
-            for (unsigned int j = 0; j < F[i].size(); j++)
-                F[i][j] = -999;
+        ALIGN2_COUNT(MATRIX_RECALCULATIONS, 1);
+        pResetMatrix();
 
         for (unsigned int i = 0; i < B.size(); i++)
             for (unsigned int j = 0; j < B[i].size(); j++) {
@@ -292,4 +283,55 @@ namespace Victor { namespace Align2{
         pCalculateMatrix(true);
     }
 
+
+    // -----------------------------------------------------------------------------
+    //                                   AlignT
+    // -----------------------------------------------------------------------------
+
+    // CONSTRUCTORS:
+
+    template <class T>
+    AlignT<T>::AlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
+    : Align(ad, gf, ss), F(n + 1, vector<T>(m + 1, 0)) {
+        ALIGN2_COUNT(BYTES_ALLOCATED, (n + 1) * (m + 1) * sizeof (T));
+    }
+
+    template <class T>
+    AlignT<T>::AlignT(const AlignT &orig) : Align(orig), F(orig.F) {
+    }
+
+    template <class T>
+    AlignT<T>::~AlignT() {
+    }
+
+
+    // MODIFIERS:
+    /**
+     * 
+     * @param orig
+     */
+    template <class T>
+    void
+    AlignT<T>::copy(const AlignT &orig) {
+        Align::copy(orig);
+        F = orig.F;
+    }
+
+
+    // HELPERS:
+
+    template <class T>
+    void
+    AlignT<T>::pResetMatrix() {
+        for (unsigned int i = 0; i < F.size(); i++)
+            for (unsigned int j = 0; j < F[i].size(); j++)
+                F[i][j] = -999;
+    }
+
+    // Explicit instantiations for the supported score types.
+    template class AlignT<short>;
+    template class AlignT<int>;
+    template class AlignT<float>;
+    template class AlignT<double>;
+
 }} // namespace
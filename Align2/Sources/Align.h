@@ -21,7 +21,9 @@
 #include <Alignment.h>
 #include <AlignmentData.h>
 #include <GapFunction.h>
+#include <Instrumentation.h>
 #include <IoTools.h>
+#include <ScoreTraits.h>
 #include <ScoringScheme.h>
 #include <Traceback.h>
 #include <algorithm>
@@ -44,6 +46,9 @@ namespace Victor { namespace Align2{
      *    originally based
      *                  on the Java implementation from Peter Sestoft.
      *                  http://www.dina.dk/~sestoft
+     *
+     *    The score matrix itself is held by AlignT, which is parametrized
+     *    on the scalar type of the DP cells.
      **/
     class Align {
     public:
@@ -88,7 +93,7 @@ namespace Victor { namespace Align2{
         virtual Traceback next(const Traceback &tb) const;
 
         /// Return alignment score.
-        virtual double getScore() const;
+        virtual double getScore() const = 0;
 
         /// Return alignment scores of an ensemble of suboptimal alignments.
         virtual vector<double> getMultiMatchScore(unsigned int num = 10);
@@ -135,9 +140,6 @@ namespace Victor { namespace Align2{
         /// Set penalties for suboptimal alignments.
         void setPenalties(double mul, double add);
 
-        /// Modify matrix during suboptimal alignment generation.
-        void pModifyMatrix(int i, int j);
-
         /// Recalculate the alignment matrix.
         virtual void recalculateMatrix();
 
@@ -157,7 +159,6 @@ namespace Victor { namespace Align2{
         AlignmentData *ad; ///< Pointer to AlignmentData.
         GapFunction *gf; ///< Pointer to GapFunction.
         ScoringScheme *ss; ///< Pointer to ScoringScheme.
-        vector< vector<double> > F; ///< Score matrix.
         vector< vector<Traceback> > B; ///< Traceback matrix.
         Traceback B0; ///< Starting point of the traceback.
         unsigned int n; ///< Length of target sequence.
@@ -170,6 +171,71 @@ namespace Victor { namespace Align2{
 
     protected:
 
+        /// Reset the score matrix before recalculation.
+        virtual void pResetMatrix() = 0;
+
+
+    private:
+
+    };
+
+    /** @brief  Alignment with a score matrix of scalar type T.
+     * 
+     *    T is one of short, int, float or double (see ScoreTraits).
+     *    Integer types give exact traceback decisions for integer
+     *    substitution matrices and gap penalties, float halves the memory
+     *    of the matrix. ScoreTypePolicy selects the narrowest safe type.
+     **/
+    template <class T>
+    class AlignT : public Align {
+    public:
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        AlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+
+        /// Copy constructor.
+        AlignT(const AlignT &orig);
+
+        /// Destructor.
+        virtual ~AlignT();
+
+
+        // PREDICATES:
+
+        /// Return alignment score.
+        virtual double getScore() const;
+
+
+        // MODIFIERS:
+
+        /// Copy orig object to this object ("deep copy").
+        virtual void copy(const AlignT &orig);
+
+        /// Modify matrix during suboptimal alignment generation.
+        void pModifyMatrix(int i, int j);
+
+
+        // HELPERS:
+
+        /// Return open gap penalty for template position p as type T.
+        T pOpenPenalty(int p);
+
+        /// Return extension gap penalty for template position p as type T.
+        T pExtensionPenalty(int p);
+
+
+        // ATTRIBUTES:
+
+        vector< vector<T> > F; ///< Score matrix.
+
+
+    protected:
+
+        /// Reset the score matrix before recalculation.
+        virtual void pResetMatrix();
+
 
     private:
 
@@ -205,12 +271,6 @@ namespace Victor { namespace Align2{
         return Traceback::getInvalidTraceback();
     }
 
-    inline double
-    Align::getScore() const {
-        return F[B0.i][B0.j];
-    }
-
-
     // MODIFIERS:
     /**
      *  
@@ -223,14 +283,45 @@ namespace Victor { namespace Align2{
         penaltyMul = mul;
         penaltyAdd = add;
     }
+
+    // -----------------------------------------------------------------------------
+    //                                   AlignT
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    template <class T>
+    inline double
+    AlignT<T>::getScore() const {
+        return static_cast<double> (F[B0.i][B0.j]);
+    }
+
+
+    // MODIFIERS:
     /**
      *  
      * @param i
      * @param j
      */
+    template <class T>
     inline void
-    Align::pModifyMatrix(int i, int j) {
-        F[i][j] = penaltyMul * F[i][j] - penaltyAdd;
+    AlignT<T>::pModifyMatrix(int i, int j) {
+        F[i][j] = ScoreTraits<T>::fromDouble(penaltyMul * F[i][j] - penaltyAdd);
+    }
+
+
+    // HELPERS:
+
+    template <class T>
+    inline T
+    AlignT<T>::pOpenPenalty(int p) {
+        return ScoreTraits<T>::fromDouble(gf->getOpenPenalty(p));
+    }
+
+    template <class T>
+    inline T
+    AlignT<T>::pExtensionPenalty(int p) {
+        return ScoreTraits<T>::fromDouble(gf->getExtensionPenalty(p));
     }
 
 }} // namespace
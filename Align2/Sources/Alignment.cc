@@ -23,6 +23,7 @@
 
 #include <Alignment.h>
 #include <AlignmentBase.h>
+#include <Instrumentation.h>
 #include <IoTools.h>
 #include <stringtools.h>
 #include <String2Number.h>
@@ -196,6 +197,7 @@ namespace Victor { namespace Align2{
  */
     void
     Alignment::loadFasta(istream &input) {
+        ALIGN2_TIMER(IO);
         string tmp;
         tmp = readLine(input);
         if (tmp[0] != '>')
@@ -347,6 +349,7 @@ namespace Victor { namespace Align2{
 
     void
     Alignment::loadCE(istream &input) {
+        ALIGN2_TIMER(IO);
         PRINT_NAME;
 
         loadCEHeader(input);
@@ -355,6 +358,7 @@ namespace Victor { namespace Align2{
 
     vector< vector<int> >
     Alignment::loadMap(istream &is) {
+        ALIGN2_TIMER(IO);
         vector< vector<int> > mapFile;
         //	mapFile.reserve(2);
         vector<int> str_pos;
@@ -474,6 +478,7 @@ namespace Victor { namespace Align2{
 
     void
     Alignment::loadPsiBlastMode4(istream& input) {
+        ALIGN2_TIMER(IO);
         // clear existing info
         targetName = "";
         unsigned int StateResult = 0;
@@ -0,0 +1,370 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Bounded per-query top-K store of all-vs-all alignment
+//                  results, with a binary columnar file format.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <AlignmentCollector.h>
+#include <algorithm>
+
+namespace Victor { namespace Align2{
+
+    // CONSTRUCTORS:
+    /**
+     * 
+     * @param k
+     */
+    AlignmentCollector::AlignmentCollector(unsigned int k) : k(k), num(0),
+    top() {
+        if (k == 0)
+            ERROR("AlignmentCollector: K must be at least 1.", exception);
+    }
+
+    AlignmentCollector::AlignmentCollector(const AlignmentCollector &orig) {
+        copy(orig);
+    }
+
+    AlignmentCollector::~AlignmentCollector() {
+    }
+
+
+    // OPERATORS:
+
+    AlignmentCollector&
+            AlignmentCollector::operator =(const AlignmentCollector &orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+
+    // PREDICATES:
+    /**
+     * 
+     * @param query
+     * @return 
+     */
+    vector<AlignmentCollector::Record>
+    AlignmentCollector::getTop(unsigned int query) const {
+        if (query >= top.size())
+            return vector<Record > ();
+
+        vector<Record> res = top[query];
+        sort(res.begin(), res.end(), pBetter);
+        return res;
+    }
+    /**
+     * Records are written by query, best first.
+     * @param os
+     */
+    void
+    AlignmentCollector::write(ostream &os) const {
+        vector<unsigned int> query, target, queryStart, targetStart, opEnd, ops;
+        vector<double> score, zScore, identity;
+
+        for (unsigned int q = 0; q < top.size(); q++) {
+            vector<Record> rec = getTop(q);
+            for (unsigned int i = 0; i < rec.size(); i++) {
+                query.push_back(rec[i].query);
+                target.push_back(rec[i].target);
+                queryStart.push_back(rec[i].queryStart);
+                targetStart.push_back(rec[i].targetStart);
+                score.push_back(rec[i].score);
+                zScore.push_back(rec[i].zScore);
+                identity.push_back(rec[i].identity);
+                ops.insert(ops.end(), rec[i].ops.begin(), rec[i].ops.end());
+                opEnd.push_back(ops.size());
+            }
+        }
+
+        unsigned int header[4] = {MAGIC, VERSION, query.size(), ops.size()};
+        os.write(reinterpret_cast<const char *> (header), sizeof (header));
+
+        if (!query.empty()) {
+            unsigned int n = query.size();
+            os.write(reinterpret_cast<const char *> (&query[0]), n * sizeof (unsigned int));
+            os.write(reinterpret_cast<const char *> (&target[0]), n * sizeof (unsigned int));
+            os.write(reinterpret_cast<const char *> (&queryStart[0]), n * sizeof (unsigned int));
+            os.write(reinterpret_cast<const char *> (&targetStart[0]), n * sizeof (unsigned int));
+            os.write(reinterpret_cast<const char *> (&score[0]), n * sizeof (double));
+            os.write(reinterpret_cast<const char *> (&zScore[0]), n * sizeof (double));
+            os.write(reinterpret_cast<const char *> (&identity[0]), n * sizeof (double));
+            os.write(reinterpret_cast<const char *> (&opEnd[0]), n * sizeof (unsigned int));
+        }
+        if (!ops.empty())
+            os.write(reinterpret_cast<const char *> (&ops[0]),
+                ops.size() * sizeof (unsigned int));
+
+        if (!os)
+            ERROR("AlignmentCollector::write() Error writing records.", exception);
+    }
+    /**
+     * 
+     * @param res1
+     * @param res2
+     * @return 
+     */
+    vector<unsigned int>
+    AlignmentCollector::encodeOps(const string &res1, const string &res2) {
+        if (res1.size() != res2.size())
+            ERROR("AlignmentCollector::encodeOps() Aligned sequences differ in length.", exception);
+
+        vector<unsigned int> ops;
+        unsigned int run = 0;
+        Op last = MATCH;
+
+        for (unsigned int i = 0; i < res1.size(); i++) {
+            Op op = MATCH;
+            if (res1[i] == '-')
+                op = DELETION;
+            else
+                if (res2[i] == '-')
+                op = INSERTION;
+
+            if ((run > 0) && (op != last)) {
+                ops.push_back((run << OP_BITS) | last);
+                run = 0;
+            }
+            last = op;
+            run++;
+        }
+
+        if (run > 0)
+            ops.push_back((run << OP_BITS) | last);
+
+        return ops;
+    }
+    /**
+     * 
+     * @param ops
+     * @param seq1 Ungapped target residues covered by the alignment.
+     * @param seq2 Ungapped template residues covered by the alignment.
+     * @return 
+     */
+    vector<string>
+    AlignmentCollector::decodeOps(const vector<unsigned int> &ops,
+            const string &seq1, const string &seq2) {
+        vector<string> res(2);
+        unsigned int p1 = 0, p2 = 0;
+
+        for (unsigned int i = 0; i < ops.size(); i++) {
+            unsigned int run = ops[i] >> OP_BITS;
+            unsigned int op = ops[i] & OP_MASK;
+
+            for (unsigned int j = 0; j < run; j++) {
+                if ((op != DELETION) && (p1 >= seq1.size()))
+                    ERROR("AlignmentCollector::decodeOps() Target sequence too short.", exception);
+                if ((op != INSERTION) && (p2 >= seq2.size()))
+                    ERROR("AlignmentCollector::decodeOps() Template sequence too short.", exception);
+
+                res[0] += (op == DELETION) ? '-' : seq1[p1++];
+                res[1] += (op == INSERTION) ? '-' : seq2[p2++];
+            }
+        }
+
+        return res;
+    }
+    /**
+     * 
+     * @param r
+     * @param query Full target sequence.
+     * @param target Full template sequence.
+     * @return 
+     */
+    vector<string>
+    AlignmentCollector::decode(const Record &r, const string &query,
+            const string &target) {
+        if ((r.queryStart > query.size()) || (r.targetStart > target.size()))
+            ERROR("AlignmentCollector::decode() Start beyond the end of a sequence.", exception);
+
+        return decodeOps(r.ops, query.substr(r.queryStart),
+                target.substr(r.targetStart));
+    }
+    /**
+     * 
+     * @param res1
+     * @param res2
+     * @return 
+     */
+    double
+    AlignmentCollector::getIdentity(const string &res1, const string &res2) {
+        unsigned int aligned = 0, identical = 0;
+
+        for (unsigned int i = 0; (i < res1.size()) && (i < res2.size()); i++)
+            if ((res1[i] != '-') && (res2[i] != '-')) {
+                aligned++;
+                if (res1[i] == res2[i])
+                    identical++;
+            }
+
+        if (aligned == 0)
+            return 0.00;
+        return static_cast<double> (identical) / aligned;
+    }
+
+
+    // MODIFIERS:
+    /**
+     * 
+     * @param orig
+     */
+    void
+    AlignmentCollector::copy(const AlignmentCollector &orig) {
+        k = orig.k;
+        num = orig.num;
+        top = orig.top;
+    }
+    /**
+     * 
+     * @param r
+     * @return 
+     */
+    bool
+    AlignmentCollector::add(const Record &r) {
+        if (r.query >= top.size())
+            top.resize(r.query + 1);
+
+        vector<Record> &heap = top[r.query];
+
+        if (heap.size() < k) {
+            heap.push_back(r);
+            push_heap(heap.begin(), heap.end(), pBetter);
+            num++;
+            return true;
+        }
+
+        if (!pBetter(r, heap.front()))
+            return false;
+
+        pop_heap(heap.begin(), heap.end(), pBetter);
+        heap.back() = r;
+        push_heap(heap.begin(), heap.end(), pBetter);
+        return true;
+    }
+    /**
+     * Only the compact record is stored: align may be destroyed afterwards.
+     * @param query
+     * @param target
+     * @param align
+     * @param zScore
+     * @return 
+     */
+    bool
+    AlignmentCollector::add(unsigned int query, unsigned int target,
+            const Align &align, double zScore) {
+        vector<string> match = align.getMatch();
+
+        Record r;
+        r.query = query;
+        r.target = target;
+        r.queryStart = pStart(align.res1Pos);
+        r.targetStart = pStart(align.res2Pos);
+        r.score = align.getScore();
+        r.zScore = zScore;
+        r.identity = getIdentity(match[0], match[1]);
+        r.ops = encodeOps(match[0], match[1]);
+
+        return add(r);
+    }
+    /**
+     * 
+     * @param is
+     */
+    void
+    AlignmentCollector::read(istream &is) {
+        unsigned int header[4];
+        is.read(reinterpret_cast<char *> (header), sizeof (header));
+        if (!is || (header[0] != MAGIC))
+            ERROR("AlignmentCollector::read() Not an alignment collector file.", exception);
+        if (header[1] != VERSION)
+            ERROR("AlignmentCollector::read() Unsupported file version.", exception);
+
+        unsigned int n = header[2];
+        vector<unsigned int> query(n), target(n), queryStart(n), targetStart(n),
+                opEnd(n), ops(header[3]);
+        vector<double> score(n), zScore(n), identity(n);
+
+        if (n > 0) {
+            is.read(reinterpret_cast<char *> (&query[0]), n * sizeof (unsigned int));
+            is.read(reinterpret_cast<char *> (&target[0]), n * sizeof (unsigned int));
+            is.read(reinterpret_cast<char *> (&queryStart[0]), n * sizeof (unsigned int));
+            is.read(reinterpret_cast<char *> (&targetStart[0]), n * sizeof (unsigned int));
+            is.read(reinterpret_cast<char *> (&score[0]), n * sizeof (double));
+            is.read(reinterpret_cast<char *> (&zScore[0]), n * sizeof (double));
+            is.read(reinterpret_cast<char *> (&identity[0]), n * sizeof (double));
+            is.read(reinterpret_cast<char *> (&opEnd[0]), n * sizeof (unsigned int));
+        }
+        if (!ops.empty())
+            is.read(reinterpret_cast<char *> (&ops[0]), ops.size() * sizeof (unsigned int));
+
+        if (!is)
+            ERROR("AlignmentCollector::read() Truncated file.", exception);
+
+        unsigned int start = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            if ((opEnd[i] < start) || (opEnd[i] > ops.size()))
+                ERROR("AlignmentCollector::read() Corrupt operation offsets.", exception);
+
+            Record r;
+            r.query = query[i];
+            r.target = target[i];
+            r.queryStart = queryStart[i];
+            r.targetStart = targetStart[i];
+            r.score = score[i];
+            r.zScore = zScore[i];
+            r.identity = identity[i];
+            r.ops.assign(ops.begin() + start, ops.begin() + opEnd[i]);
+            add(r);
+            start = opEnd[i];
+        }
+    }
+
+    void
+    AlignmentCollector::clear() {
+        top.clear();
+        num = 0;
+    }
+
+
+    // HELPERS:
+
+    bool
+    AlignmentCollector::pBetter(const Record &r1, const Record &r2) {
+        if (r1.score != r2.score)
+            return r1.score > r2.score;
+        return r1.target < r2.target;
+    }
+    /**
+     * Residues of a sequence before the alignment, from the positions set
+     * by Align::getMatch() (-1 for gaps).
+     * @param pos
+     * @return 
+     */
+    unsigned int
+    AlignmentCollector::pStart(const vector<int> &pos) {
+        for (unsigned int i = 0; i < pos.size(); i++)
+            if (pos[i] >= 0)
+                return pos[i];
+        return 0;
+    }
+
+}} // namespace
@@ -0,0 +1,187 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __AlignmentCollector_H__
+#define __AlignmentCollector_H__
+
+#include <Align.h>
+#include <Debug.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Bounded per-query top-K store of all-vs-all alignment results.
+     * 
+     *    Each result is kept as a compact Record (ids, scores, identity and
+     *    the alignment as run-length operations), so the Align producing it,
+     *    with its F and B matrices, can be released right after the pair is
+     *    aligned. Only the K best scoring records of each query are kept.
+     *
+     *    The start positions of the alignment in both sequences are kept
+     *    with the operations, so local and free-shift alignments can be
+     *    rebuilt from a record and the full sequences.
+     *
+     *    write() stores the records as a binary columnar file: a header of
+     *    four 32 bit words (MAGIC, VERSION, record count, operation count)
+     *    followed by the query, target, queryStart, targetStart, score,
+     *    zScore, identity, opEnd and ops columns in host byte order. Fixed width columns can be merged
+     *    and sorted externally; read() merges a file into the collector.
+     **/
+    class AlignmentCollector {
+    public:
+
+        /// Alignment operations.
+
+        enum Op {
+            MATCH = 0, ///< Residue in both sequences.
+            INSERTION = 1, ///< Residue in target only.
+            DELETION = 2 ///< Residue in template only.
+        };
+
+        /// File format and operation layout.
+
+        enum {
+            OP_BITS = 2, ///< Low bits of a run holding the Op.
+            OP_MASK = 3, ///< Mask of the Op in a run.
+            MAGIC = 0x31434156, ///< "VAC1" in little-endian order.
+            VERSION = 2 ///< File format version.
+        };
+
+        /// Compact alignment result.
+
+        struct Record {
+            unsigned int query; ///< Query (target sequence) id.
+            unsigned int target; ///< Template id.
+            unsigned int queryStart; ///< Target residues before the alignment.
+            unsigned int targetStart; ///< Template residues before the alignment.
+            double score; ///< Alignment score.
+            double zScore; ///< Z-score, 0 if not computed.
+            double identity; ///< Identical residues over aligned columns.
+            vector<unsigned int> ops; ///< Runs as (length << OP_BITS) | Op.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        AlignmentCollector(unsigned int k = 10);
+
+        /// Copy constructor.
+        AlignmentCollector(const AlignmentCollector &orig);
+
+        /// Destructor.
+        virtual ~AlignmentCollector();
+
+
+        // OPERATORS:
+
+        /// Assignment operator.
+        AlignmentCollector& operator =(const AlignmentCollector &orig);
+
+
+        // PREDICATES:
+
+        /// Return the number of records kept per query.
+        unsigned int getK() const;
+
+        /// Return the number of records kept.
+        unsigned int size() const;
+
+        /// Return the records of query, best first.
+        vector<Record> getTop(unsigned int query) const;
+
+        /// Write all records as a binary columnar file.
+        void write(ostream &os) const;
+
+        /// Return the run-length operations of an aligned pair.
+        static vector<unsigned int> encodeOps(const string &res1,
+                const string &res2);
+
+        /// Return the aligned pair of seq1 and seq2 described by ops.
+        static vector<string> decodeOps(const vector<unsigned int> &ops,
+                const string &seq1, const string &seq2);
+
+        /// Return the aligned pair of r, given the full query and template.
+        static vector<string> decode(const Record &r, const string &query,
+                const string &target);
+
+        /// Return identical residues over columns without gaps.
+        static double getIdentity(const string &res1, const string &res2);
+
+
+        // MODIFIERS:
+
+        /// Copy orig object to this object ("deep copy").
+        virtual void copy(const AlignmentCollector &orig);
+
+        /// Add r, return true if it is among the K best of its query.
+        bool add(const Record &r);
+
+        /// Add the current best alignment of align.
+        bool add(unsigned int query, unsigned int target, const Align &align,
+                double zScore = 0.00);
+
+        /// Merge the records of a file written by write().
+        void read(istream &is);
+
+        /// Remove all records.
+        void clear();
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Return true if r1 ranks before r2 (heaps keep the worst on top).
+        static bool pBetter(const Record &r1, const Record &r2);
+
+        /// Return the first aligned position of a sequence.
+        static unsigned int pStart(const vector<int> &pos);
+
+
+        // ATTRIBUTES:
+
+        unsigned int k; ///< Records kept per query.
+        unsigned int num; ///< Records kept.
+        vector< vector<Record> > top; ///< Heap of records of each query.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                             AlignmentCollector
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    AlignmentCollector::getK() const {
+        return k;
+    }
+
+    inline unsigned int
+    AlignmentCollector::size() const {
+        return num;
+    }
+
+}} // namespace
+
+#endif
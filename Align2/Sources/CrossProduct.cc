@@ -86,8 +86,9 @@ namespace Victor { namespace Align2{
             double tmp = 0.00;
 
             for (AminoAcidCode amino2 = ALA; amino2 <= TYR; amino2++)
-                tmp += sub->score[aminoAcidOneLetterTranslator(amino1)]
-                [aminoAcidOneLetterTranslator(amino2)] *
+                tmp += sub->getScore(
+                EncodedSequence::encode(aminoAcidOneLetterTranslator(amino1)),
+                EncodedSequence::encode(aminoAcidOneLetterTranslator(amino2))) *
                 pro2->getAminoFrequencyFromCode(amino2, (j - 1));
 
             s += (pro1->getAminoFrequencyFromCode(amino1, (i - 1)) * tmp);
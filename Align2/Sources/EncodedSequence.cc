@@ -0,0 +1,86 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Sequence stored as one byte residue codes.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <EncodedSequence.h>
+
+namespace Victor { namespace Align2{
+
+    // CONSTRUCTORS:
+
+    EncodedSequence::EncodedSequence() : residues() {
+    }
+    /**
+     * 
+     * @param s
+     */
+    EncodedSequence::EncodedSequence(const string &s) : residues() {
+        setSequence(s);
+    }
+
+    EncodedSequence::EncodedSequence(const EncodedSequence &orig) {
+        copy(orig);
+    }
+
+    EncodedSequence::~EncodedSequence() {
+    }
+
+
+    // OPERATORS:
+
+    EncodedSequence&
+            EncodedSequence::operator =(const EncodedSequence &orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+
+    // PREDICATES:
+
+    string
+    EncodedSequence::toString() const {
+        string s(residues.size(), ' ');
+        for (unsigned int i = 0; i < residues.size(); i++)
+            s[i] = decode(residues[i]);
+        return s;
+    }
+
+
+    // MODIFIERS:
+
+    void
+    EncodedSequence::copy(const EncodedSequence &orig) {
+        residues = orig.residues;
+    }
+    /**
+     * 
+     * @param s
+     */
+    void
+    EncodedSequence::setSequence(const string &s) {
+        residues.resize(s.size());
+        for (unsigned int i = 0; i < s.size(); i++)
+            residues[i] = encode(s[i]);
+    }
+
+}} // namespace
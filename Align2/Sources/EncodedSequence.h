@@ -0,0 +1,194 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __EncodedSequence_H__
+#define __EncodedSequence_H__
+
+#include <Debug.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Sequence stored as one byte residue codes.
+     * 
+     *    The low five bits hold the residue code (letters A-Z are 1-26,
+     *    '*' is 27, 0 is any other character), the high bit marks a gap.
+     *    Codes index dense ALPHABET_SIZE x ALPHABET_SIZE tables, see
+     *    Substitution::getScore(). Letters are case-insensitive, as in
+     *    Substitution::buildscore(). Conversion from and to string is meant
+     *    for I/O boundaries only.
+     * 
+     *    Codes take one byte per residue, as a string does, so encoding
+     *    saves no memory; it only spares the scoring schemes the per-lookup
+     *    character translation. AlignmentData, AlignmentBase and Profile
+     *    keep their sequences as strings; ScoringS2S encodes them once when
+     *    it is constructed.
+     **/
+    class EncodedSequence {
+    public:
+
+        /// Residue code.
+        typedef unsigned char Residue;
+
+        /// Layout of residue codes.
+
+        enum {
+            ALPHABET_SIZE = 32, ///< Number of distinct codes.
+            CODE_MASK = 0x1F, ///< Bits holding the code.
+            GAP_BIT = 0x80, ///< Bit marking a gap.
+            UNKNOWN_CODE = 0, ///< Code of characters outside the alphabet.
+            STOP_CODE = 27, ///< Code of '*'.
+            GAP_CODE = 31 ///< Code of '-' and '.', without the gap bit.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        EncodedSequence();
+
+        /// Constructor encoding string s.
+        EncodedSequence(const string &s);
+
+        /// Copy constructor.
+        EncodedSequence(const EncodedSequence &orig);
+
+        /// Destructor.
+        virtual ~EncodedSequence();
+
+
+        // OPERATORS:
+
+        /// Assignment operator.
+        EncodedSequence& operator =(const EncodedSequence &orig);
+
+        /// Return the residue at position p.
+        Residue operator [](unsigned int p) const;
+
+
+        // PREDICATES:
+
+        /// Return the number of residues.
+        unsigned int size() const;
+
+        /// Return the sequence as a string.
+        string toString() const;
+
+        /// Return code of character c.
+        static Residue encode(char c);
+
+        /// Return character of code r.
+        static char decode(Residue r);
+
+        /// Return index of r in dense tables.
+        static unsigned int index(Residue r);
+
+        /// Return true if r is a gap.
+        static bool isGap(Residue r);
+
+
+        // MODIFIERS:
+
+        /// Copy orig object to this object ("deep copy").
+        virtual void copy(const EncodedSequence &orig);
+
+        /// Replace the sequence with the encoding of s.
+        void setSequence(const string &s);
+
+        /// Reverse the sequence in place.
+        void reverse();
+
+
+    protected:
+
+
+    private:
+
+        // ATTRIBUTES:
+
+        vector<Residue> residues; ///< Residue codes.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               EncodedSequence
+    // -----------------------------------------------------------------------------
+
+    // OPERATORS:
+
+    inline EncodedSequence::Residue
+    EncodedSequence::operator [](unsigned int p) const {
+        return residues[p];
+    }
+
+
+    // PREDICATES:
+
+    inline unsigned int
+    EncodedSequence::size() const {
+        return residues.size();
+    }
+
+    inline EncodedSequence::Residue
+    EncodedSequence::encode(char c) {
+        if ((c >= 'A') && (c <= 'Z'))
+            return static_cast<Residue> (c - 'A' + 1);
+        if ((c >= 'a') && (c <= 'z'))
+            return static_cast<Residue> (c - 'a' + 1);
+        if (c == '*')
+            return STOP_CODE;
+        if ((c == '-') || (c == '.'))
+            return GAP_BIT | GAP_CODE;
+        return UNKNOWN_CODE;
+    }
+
+    inline char
+    EncodedSequence::decode(Residue r) {
+        if (isGap(r) || (index(r) == GAP_CODE))
+            return '-';
+        unsigned int code = index(r);
+        if ((code >= 1) && (code <= 26))
+            return static_cast<char> ('A' + code - 1);
+        if (code == STOP_CODE)
+            return '*';
+        return '?';
+    }
+
+    inline unsigned int
+    EncodedSequence::index(Residue r) {
+        return r & CODE_MASK;
+    }
+
+    inline bool
+    EncodedSequence::isGap(Residue r) {
+        return (r & GAP_BIT) != 0;
+    }
+
+
+    // MODIFIERS:
+
+    inline void
+    EncodedSequence::reverse() {
+        std::reverse(residues.begin(), residues.end());
+    }
+
+}} // namespace
+
+#endif
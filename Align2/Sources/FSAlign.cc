@@ -30,8 +30,9 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    FSAlign::FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    template <class T>
+    FSAlignT<T>::FSAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
+    : AlignT<T>(ad, gf, ss) {
         cout << "inizio creazione FSAlign\n";
         pCalculateMatrix(true);
         cout << "fine creazione FSAlign\n";
@@ -44,19 +45,22 @@ namespace Victor { namespace Align2{
      * @param v1
      * @param v2
      */
-    FSAlign::FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+    template <class T>
+    FSAlignT<T>::FSAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
             const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+    : AlignT<T>(ad, gf, ss) {
         pCalculateMatrix(v1, v2, true);
     }
     /**
      *  
      * @param orig
      */
-    FSAlign::FSAlign(const FSAlign &orig) : Align(orig) {
+    template <class T>
+    FSAlignT<T>::FSAlignT(const FSAlignT &orig) : AlignT<T>(orig) {
     }
 
-    FSAlign::~FSAlign() {
+    template <class T>
+    FSAlignT<T>::~FSAlignT() {
     }
 
 
@@ -66,8 +70,9 @@ namespace Victor { namespace Align2{
      * @param orig
      * @return 
      */
-    FSAlign&
-            FSAlign::operator =(const FSAlign &orig) {
+    template <class T>
+    FSAlignT<T>&
+            FSAlignT<T>::operator =(const FSAlignT &orig) {
         if (&orig != this)
             copy(orig);
         POSTCOND((orig == *this), exception);
@@ -79,8 +84,12 @@ namespace Victor { namespace Align2{
     /**
      *  
      */
+    template <class T>
     void
-    FSAlign::getMultiMatch() {
+    FSAlignT<T>::getMultiMatch() {
+        ALIGN2_TIMER(SUBOPTIMAL);
+        ALIGN2_COUNT(MATRIX_RECALCULATIONS, 1);
+
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -92,6 +101,7 @@ namespace Victor { namespace Align2{
             i = tb.i;
             j = tb.j;
             pModifyMatrix(i, j);
+            ALIGN2_COUNT(TRACEBACK_STEPS, 1);
             tb = next(tb);
         }
 
@@ -105,14 +115,16 @@ namespace Victor { namespace Align2{
      *  
      * @param orig
      */
+    template <class T>
     void
-    FSAlign::copy(const FSAlign &orig) {
-        Align::copy(orig);
+    FSAlignT<T>::copy(const FSAlignT &orig) {
+        AlignT<T>::copy(orig);
     }
 
-    FSAlign*
-    FSAlign::newCopy() {
-        FSAlign *tmp = new FSAlign(*this);
+    template <class T>
+    FSAlignT<T>*
+    FSAlignT<T>::newCopy() {
+        FSAlignT *tmp = new FSAlignT(*this);
         return tmp;
     }
 
@@ -122,8 +134,12 @@ namespace Victor { namespace Align2{
      *  
      * @param update
      */
+    template <class T>
     void
-    FSAlign::pCalculateMatrix(bool update) {
+    FSAlignT<T>::pCalculateMatrix(bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         if (update)
             F[0][0] = 0;
 
@@ -141,41 +157,41 @@ namespace Victor { namespace Align2{
         //cout<<"pCalculateMatrixA\n";
         for (int i = 1; i <= static_cast<int> (n); i++)
             for (int j = 1; j <= static_cast<int> (m); j++) { //cout<<"punto 0, i:"<<i<<" j:"<<j<<"\n";
-                double s = ss->scoring(i, j);
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j));
                 //cout<<"punto1\n";
-                double extI, extJ;
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
                     if (B[i - 1][j].j == (j - 1))
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(z, extI), extJ);
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, z))
+                if (ScoreTraits<T>::equals(val, z))
                     B[i][j] = Traceback(i - 1, j - 1);
                 else
-                    if (EQUALS(val, extJ))
+                    if (ScoreTraits<T>::equals(val, extJ))
                     B[i][j] = Traceback(i, j - 1);
                 else
-                    if (EQUALS(val, extI))
+                    if (ScoreTraits<T>::equals(val, extI))
                     B[i][j] = Traceback(i - 1, j);
                 else
                     ERROR("Error in FSAlign: FS 1", exception);
@@ -210,9 +226,13 @@ namespace Victor { namespace Align2{
      * @param v2
      * @param update
      */
+    template <class T>
     void
-    FSAlign::pCalculateMatrix(const vector<unsigned int> &v1,
+    FSAlignT<T>::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
@@ -241,42 +261,42 @@ namespace Victor { namespace Align2{
                 else
                     minL = v2[j - 1];
 
-                double s = ss->scoring(i, j) * minL;
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j) * minL);
                 // end SSEA variant code
 
-                double extI, extJ;
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
                     if (B[i - 1][j].j == (j - 1))
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(z, extI), extJ);
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, z))
+                if (ScoreTraits<T>::equals(val, z))
                     B[i][j] = Traceback(i - 1, j - 1);
                 else
-                    if (EQUALS(val, extJ))
+                    if (ScoreTraits<T>::equals(val, extJ))
                     B[i][j] = Traceback(i, j - 1);
                 else
-                    if (EQUALS(val, extI))
+                    if (ScoreTraits<T>::equals(val, extI))
                     B[i][j] = Traceback(i - 1, j);
                 else
                     ERROR("Error in FSAlign: FS 1", exception);
@@ -303,4 +323,10 @@ namespace Victor { namespace Align2{
         B0 = Traceback(maxI, maxJ);
     }
 
+    // Explicit instantiations for the supported score types.
+    template class FSAlignT<short>;
+    template class FSAlignT<int>;
+    template class FSAlignT<float>;
+    template class FSAlignT<double>;
+
 }} // namespace
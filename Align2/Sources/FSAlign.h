@@ -27,29 +27,43 @@ namespace Victor { namespace Align2{
      *   
 
      **/
-    class FSAlign : public Align {
+    template <class T = double>
+    class FSAlignT : public AlignT<T> {
     public:
 
+        using AlignT<T>::ad;
+        using AlignT<T>::gf;
+        using AlignT<T>::ss;
+        using AlignT<T>::F;
+        using AlignT<T>::B;
+        using AlignT<T>::B0;
+        using AlignT<T>::n;
+        using AlignT<T>::m;
+        using AlignT<T>::next;
+        using AlignT<T>::pModifyMatrix;
+        using AlignT<T>::pOpenPenalty;
+        using AlignT<T>::pExtensionPenalty;
+
         // CONSTRUCTORS:
 
         /// Default constructor.
-        FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        FSAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
 
         /// Constructor with weighted alignment positions.
-        FSAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+        FSAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
                 const vector<unsigned int> &v1, const vector<unsigned int> &v2);
 
         /// Copy constructor.
-        FSAlign(const FSAlign &orig);
+        FSAlignT(const FSAlignT &orig);
 
         /// Destructor.
-        virtual ~FSAlign();
+        virtual ~FSAlignT();
 
 
         // OPERATORS:
 
         /// Assignment operator.
-        FSAlign& operator =(const FSAlign &orig);
+        FSAlignT& operator =(const FSAlignT &orig);
 
 
         // PREDICATES:
@@ -61,10 +75,10 @@ namespace Victor { namespace Align2{
         // MODIFIERS:
 
         /// Copy orig object to this object ("deep copy").
-        virtual void copy(const FSAlign &orig);
+        virtual void copy(const FSAlignT &orig);
 
         /// Construct a new "deep copy" of this object.
-        virtual FSAlign* newCopy();
+        virtual FSAlignT* newCopy();
 
 
         // HELPERS:
@@ -84,6 +98,9 @@ namespace Victor { namespace Align2{
 
     };
 
+    /// Free-shift alignment on a double score matrix.
+    typedef FSAlignT<double> FSAlign;
+
 }} // namespace
 
 #endif
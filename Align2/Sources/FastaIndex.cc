@@ -0,0 +1,390 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Memory mapped FASTA file with a faidx style index.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <FastaIndex.h>
+#include <ThreadPool.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Victor { namespace Align2{
+
+    /// Blocks of records visited by forEachParallel(), one visitor per worker.
+
+    class FastaLoop : public ThreadPool::Loop {
+    public:
+
+        FastaLoop(const FastaIndex &index,
+                const vector<FastaIndex::RecordVisitor*> &visitors,
+                unsigned int blockSize) : index(index), visitors(visitors),
+        blockSize(blockSize) {
+        }
+
+        virtual void run(unsigned int b, unsigned int worker) {
+            unsigned int first = b * blockSize;
+            index.forEach(*visitors[worker], first,
+                    (index.size() - first > blockSize) ? first + blockSize : index.size());
+        }
+
+    private:
+        const FastaIndex &index;
+        const vector<FastaIndex::RecordVisitor*> &visitors;
+        unsigned int blockSize;
+    };
+
+    static bool
+    sIsBlank(char c) {
+        return (c == ' ') || (c == '\t') || (c == '\r');
+    }
+
+    // -----------------------------------------------------------------------------
+    //                          FastaIndex::SequenceView
+    // -----------------------------------------------------------------------------
+
+    /**
+     * Lines are copied whole, skipping the end of line bytes.
+     * @param p first position
+     * @param n number of residues, cut at the end of the sequence
+     * @return 
+     */
+    string
+    FastaIndex::SequenceView::substr(unsigned long p, unsigned long n) const {
+        if (p > length)
+            ERROR("FastaIndex::SequenceView::substr() Position out of range.", exception);
+        if (n > length - p)
+            n = length - p;
+
+        string res;
+        res.reserve(n);
+        while (n > 0) {
+            unsigned long k = min(n, lineBases - p % lineBases);
+            res.append(start + p + (p / lineBases) * (lineWidth - lineBases), k);
+            p += k;
+            n -= k;
+        }
+        return res;
+    }
+
+    string
+    FastaIndex::SequenceView::toString() const {
+        return substr(0, length);
+    }
+
+    // -----------------------------------------------------------------------------
+    //                                 FastaIndex
+    // -----------------------------------------------------------------------------
+
+    // CONSTRUCTORS:
+    /**
+     * 
+     * @param fileName
+     */
+    FastaIndex::FastaIndex(const string &fileName) : fileName(fileName),
+    data(NULL), fileSize(0), mapped(false), records(), byName() {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            ERROR("FastaIndex: cannot open " + fileName, exception);
+        struct stat st;
+        if (fstat(fd, &st) == 0)
+            fileSize = st.st_size;
+        if (fileSize > 0) {
+            void *p = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char *> (p);
+                mapped = true;
+            }
+        }
+        close(fd);
+
+        if (!mapped) { // not mappable: read a copy
+            ifstream in(fileName.c_str(), ios::binary);
+            string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            fileSize = contents.size();
+            char *copy = new char[fileSize + 1];
+            memcpy(copy, contents.data(), fileSize);
+            data = copy;
+        }
+
+        // an index older than the FASTA file is ignored
+        string indexName = fileName + ".fai";
+        struct stat indexSt;
+        bool indexed = false;
+        if ((stat(indexName.c_str(), &indexSt) == 0)
+                && (indexSt.st_mtime >= st.st_mtime)) {
+            ifstream indexFile(indexName.c_str());
+            indexed = pReadIndex(indexFile);
+        }
+        if (!indexed)
+            pScan();
+        pSortNames();
+    }
+
+    FastaIndex::~FastaIndex() {
+        if (mapped)
+            munmap(const_cast<char *> (data), fileSize);
+        else
+            delete[] data;
+    }
+
+
+    // PREDICATES:
+    /**
+     * Duplicated names are resolved to the first record in the file.
+     * @param name
+     * @return 
+     */
+    unsigned int
+    FastaIndex::find(const string &name) const {
+        unsigned int lo = 0, hi = byName.size();
+        while (lo < hi) {
+            unsigned int mid = lo + (hi - lo) / 2;
+            if (records[byName[mid]].name < name)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if ((lo < byName.size()) && (records[byName[lo]].name == name))
+            return byName[lo];
+        return size();
+    }
+    /**
+     * 
+     * @param id
+     * @return 
+     */
+    FastaIndex::SequenceView
+    FastaIndex::getSequence(unsigned int id) const {
+        const Record &rec = getRecord(id);
+        return SequenceView(data + rec.offset, rec.length, rec.lineBases,
+                rec.lineWidth);
+    }
+    /**
+     * 
+     * @param name
+     * @return 
+     */
+    FastaIndex::SequenceView
+    FastaIndex::getSequence(const string &name) const {
+        unsigned int id = find(name);
+        if (id == size())
+            ERROR("FastaIndex: no sequence " + name + " in " + fileName, exception);
+        return getSequence(id);
+    }
+    /**
+     * 
+     * @param visitor
+     * @param first
+     * @param last
+     */
+    void
+    FastaIndex::forEach(RecordVisitor &visitor, unsigned int first,
+            unsigned int last) const {
+        if (last > size())
+            last = size();
+        for (unsigned int id = first; id < last; id++)
+            visitor.visit(id, records[id], getSequence(id));
+    }
+    /**
+     * Each thread takes blocks of blockSize consecutive records in turn 
+     * and visits them with its own visitor, so visitors need no locking.
+     * @param visitors
+     * @param blockSize
+     */
+    void
+    FastaIndex::forEachParallel(const vector<RecordVisitor*> &visitors,
+            unsigned int blockSize) const {
+        if (visitors.empty())
+            ERROR("FastaIndex::forEachParallel() No visitors.", exception);
+
+        if (blockSize == 0)
+            blockSize = 1;
+        FastaLoop loop(*this, visitors, blockSize);
+        ThreadPool::forEach(size() / blockSize + (size() % blockSize != 0), loop,
+                visitors.size());
+    }
+    /**
+     * Shards are consecutive and hold about the same number of residues.
+     * @param shard
+     * @param shards
+     * @param first first record of the shard
+     * @param last one past the last record of the shard
+     */
+    void
+    FastaIndex::getShard(unsigned int shard, unsigned int shards,
+            unsigned int &first, unsigned int &last) const {
+        if (shard >= shards)
+            ERROR("FastaIndex::getShard() Shard out of range.", exception);
+
+        unsigned long total = 0;
+        for (unsigned int id = 0; id < size(); id++)
+            total += records[id].length;
+        unsigned long begin = total / shards * shard + total % shards * shard / shards;
+        unsigned long end = total / shards * (shard + 1)
+                + total % shards * (shard + 1) / shards;
+
+        // a record belongs to the shard where its first residue falls
+        first = last = size();
+        unsigned long residues = 0;
+        for (unsigned int id = 0; id < size(); id++) {
+            if ((first == size()) && (residues >= begin))
+                first = id;
+            if ((shard + 1 < shards) && (residues >= end)) {
+                last = id;
+                break;
+            }
+            residues += records[id].length;
+        }
+        if (first > last)
+            first = last;
+    }
+    /**
+     * 
+     * @param os
+     */
+    void
+    FastaIndex::writeIndex(ostream &os) const {
+        for (unsigned int id = 0; id < size(); id++)
+            os << records[id].name << '\t' << records[id].length << '\t'
+                << records[id].offset << '\t' << records[id].lineBases << '\t'
+                << records[id].lineWidth << '\n';
+        if (!os)
+            ERROR("FastaIndex::writeIndex() Error writing index.", exception);
+    }
+    /**
+     * 
+     * @param fileName
+     */
+    void
+    FastaIndex::buildIndex(const string &fileName) {
+        FastaIndex index(fileName);
+        ofstream out((fileName + ".fai").c_str());
+        if (!out)
+            ERROR("FastaIndex: cannot write " + fileName + ".fai", exception);
+        index.writeIndex(out);
+    }
+
+
+    // HELPERS:
+    /**
+     * Full lines of a record must have the same length, only the last one
+     * can be shorter, as in faidx.
+     */
+    void
+    FastaIndex::pScan() {
+        records.clear();
+        bool lastLine = false; // short or blank line seen in this record
+        unsigned long pos = 0;
+        while (pos < fileSize) {
+            const char *nl = static_cast<const char *> (memchr(data + pos, '\n',
+                    fileSize - pos));
+            unsigned long end = (nl != NULL) ? nl - data : fileSize;
+            unsigned long width = end - pos + ((nl != NULL) ? 1 : 0);
+            unsigned long len = end - pos;
+            if ((len > 0) && (data[end - 1] == '\r'))
+                len--;
+
+            if ((len > 0) && (data[pos] == '>')) {
+                Record rec;
+                unsigned long nameEnd = pos + 1;
+                while ((nameEnd < end) && !sIsBlank(data[nameEnd]))
+                    nameEnd++;
+                rec.name.assign(data + pos + 1, nameEnd - pos - 1);
+                rec.length = 0;
+                rec.offset = pos + width;
+                rec.lineBases = rec.lineWidth = 0;
+                records.push_back(rec);
+                lastLine = false;
+            } else if (len > 0) {
+                if (records.empty())
+                    ERROR("FastaIndex: " + fileName + " does not start with a FASTA header.",
+                        exception);
+                Record &rec = records.back();
+                if (rec.lineBases == 0) {
+                    rec.lineBases = len;
+                    rec.lineWidth = width;
+                } else if (lastLine || (len > rec.lineBases)
+                        || ((len == rec.lineBases) && (nl != NULL)
+                        && (width != rec.lineWidth)))
+                    ERROR("FastaIndex: different line length in sequence "
+                        + rec.name + " of " + fileName, exception);
+                if (len < rec.lineBases)
+                    lastLine = true;
+                rec.length += len;
+            } else
+                lastLine = true;
+
+            pos = end + 1;
+        }
+    }
+    /**
+     * 
+     * @param is
+     * @return 
+     */
+    bool
+    FastaIndex::pReadIndex(istream &is) {
+        records.clear();
+        Record rec;
+        while (is >> rec.name >> rec.length >> rec.offset >> rec.lineBases
+                >> rec.lineWidth) {
+            unsigned long bytes = 0;
+            if (rec.length > 0) {
+                if ((rec.lineBases == 0) || (rec.lineWidth < rec.lineBases))
+                    return false;
+                bytes = (rec.length - 1) / rec.lineBases * rec.lineWidth
+                        + (rec.length - 1) % rec.lineBases + 1;
+            }
+            if ((rec.offset > fileSize) || (bytes > fileSize - rec.offset))
+                return false;
+            records.push_back(rec);
+        }
+        return is.eof();
+    }
+
+    /// Orders record ids by name, then by position in the file.
+
+    struct FastaNameLess {
+        const vector<FastaIndex::Record> *records;
+
+        bool operator()(unsigned int a, unsigned int b) const {
+            return (*records)[a].name < (*records)[b].name;
+        }
+    };
+
+    void
+    FastaIndex::pSortNames() {
+        byName.resize(records.size());
+        for (unsigned int id = 0; id < records.size(); id++)
+            byName[id] = id;
+        FastaNameLess less;
+        less.records = &records;
+        stable_sort(byName.begin(), byName.end(), less);
+    }
+
+}} // namespace
@@ -0,0 +1,244 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __FastaIndex_H__
+#define __FastaIndex_H__
+
+#include <Debug.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Random access to the records of a (large) FASTA file.
+     * 
+     *    The file is memory mapped and described by an index holding, for
+     *    each record, its name, length, offset of the first residue, and
+     *    residues and bytes per line. The index has the layout of a faidx
+     *    ".fai" file: it is read from fileName.fai if that is not older than
+     *    the FASTA file, otherwise it is built with a single scan of the map.
+     *    buildIndex() writes it next to the FASTA file.
+     *
+     *    Sequences are returned as SequenceView objects pointing into the
+     *    map, so nothing is copied until toString() or substr() is called.
+     *    Views are valid as long as the FastaIndex exists. All predicates
+     *    are read-only, so any number of threads can query one index;
+     *    forEachParallel() hands out blocks of records to one visitor per
+     *    thread, and getShard() splits the records into ranges of similar
+     *    size for jobs distributed over several processes.
+     **/
+    class FastaIndex {
+    public:
+
+        /// Index entry of a record, with the fields of a faidx line.
+
+        struct Record {
+            string name; ///< Header up to the first blank.
+            unsigned long length; ///< Number of residues.
+            unsigned long offset; ///< File offset of the first residue.
+            unsigned int lineBases; ///< Residues per full line.
+            unsigned int lineWidth; ///< Bytes per full line, end of line included.
+        };
+
+        /// Residues of a record, read in place from the mapped file.
+
+        class SequenceView {
+        public:
+            /// Default constructor (empty sequence).
+            SequenceView();
+
+            /// View of length residues starting at data.
+            SequenceView(const char *data, unsigned long length,
+                    unsigned int lineBases, unsigned int lineWidth);
+
+            /// Return the number of residues.
+            unsigned long size() const;
+
+            /// Return the residue at position p.
+            char operator [](unsigned long p) const;
+
+            /// Return true if the residues are stored on a single line.
+            bool isContiguous() const;
+
+            /// Return the first residue (all of them if isContiguous()).
+            const char* data() const;
+
+            /// Return n residues from position p as a string.
+            string substr(unsigned long p, unsigned long n) const;
+
+            /// Return the sequence as a string.
+            string toString() const;
+
+        private:
+            const char *start; ///< First residue.
+            unsigned long length; ///< Number of residues.
+            unsigned int lineBases; ///< Residues per full line.
+            unsigned int lineWidth; ///< Bytes per full line.
+        };
+
+        /// Callback of forEach() and forEachParallel().
+
+        class RecordVisitor {
+        public:
+            virtual ~RecordVisitor() {
+            }
+
+            /// Called with the index id of each record visited.
+            virtual void visit(unsigned int id, const Record &rec,
+                    const SequenceView &seq) = 0;
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Map fileName and read or build its index.
+        FastaIndex(const string &fileName);
+
+        /// Destructor.
+        virtual ~FastaIndex();
+
+
+        // PREDICATES:
+
+        /// Return the name of the FASTA file.
+        string getFileName() const;
+
+        /// Return the number of records.
+        unsigned int size() const;
+
+        /// Return the index entry of record id.
+        const Record& getRecord(unsigned int id) const;
+
+        /// Return the id of the record called name, size() if missing.
+        unsigned int find(const string &name) const;
+
+        /// Return the residues of record id.
+        SequenceView getSequence(unsigned int id) const;
+
+        /// Return the residues of the record called name.
+        SequenceView getSequence(const string &name) const;
+
+        /// Visit records first to last - 1 in order.
+        void forEach(RecordVisitor &visitor, unsigned int first,
+                unsigned int last) const;
+
+        /// Visit all records with visitors.size() threads, one per visitor.
+        void forEachParallel(const vector<RecordVisitor*> &visitors,
+                unsigned int blockSize = 1024) const;
+
+        /// Return in first, last the records of shard (of shards) by residues.
+        void getShard(unsigned int shard, unsigned int shards,
+                unsigned int &first, unsigned int &last) const;
+
+        /// Write the index in faidx format.
+        void writeIndex(ostream &os) const;
+
+        /// Build the index of fileName and write it to fileName.fai.
+        static void buildIndex(const string &fileName);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Scan the mapped file for records.
+        void pScan();
+
+        /// Read an index written by writeIndex(), false if it is unusable.
+        bool pReadIndex(istream &is);
+
+        /// Sort record ids by name for find().
+        void pSortNames();
+
+        /// Not copyable: the object owns the map.
+        FastaIndex(const FastaIndex &orig);
+        FastaIndex& operator =(const FastaIndex &orig);
+
+
+        // ATTRIBUTES:
+
+        string fileName; ///< FASTA file.
+        const char *data; ///< Mapped (or copied) file contents.
+        unsigned long fileSize; ///< Bytes in data.
+        bool mapped; ///< True if data is a map, false if a copy.
+        vector<Record> records; ///< Index entries in file order.
+        vector<unsigned int> byName; ///< Record ids sorted by name.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                                 FastaIndex
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline
+    FastaIndex::SequenceView::SequenceView() : start(NULL), length(0),
+    lineBases(1), lineWidth(1) {
+    }
+
+    inline
+    FastaIndex::SequenceView::SequenceView(const char *data, unsigned long length,
+            unsigned int lineBases, unsigned int lineWidth) : start(data),
+    length(length), lineBases(lineBases > 0 ? lineBases : 1),
+    lineWidth(lineBases > 0 ? lineWidth : 1) {
+    }
+
+    inline unsigned long
+    FastaIndex::SequenceView::size() const {
+        return length;
+    }
+
+    inline char
+    FastaIndex::SequenceView::operator [](unsigned long p) const {
+        return start[p + (p / lineBases) * (lineWidth - lineBases)];
+    }
+
+    inline bool
+    FastaIndex::SequenceView::isContiguous() const {
+        return length <= lineBases;
+    }
+
+    inline const char*
+    FastaIndex::SequenceView::data() const {
+        return start;
+    }
+
+    inline string
+    FastaIndex::getFileName() const {
+        return fileName;
+    }
+
+    inline unsigned int
+    FastaIndex::size() const {
+        return records.size();
+    }
+
+    inline const FastaIndex::Record&
+    FastaIndex::getRecord(unsigned int id) const {
+        PRECOND(id < records.size(), exception);
+        return records[id];
+    }
+
+}} // namespace
+
+#endif
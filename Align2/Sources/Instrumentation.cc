@@ -0,0 +1,219 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Per-phase timers and counters of the alignment hot paths.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <Instrumentation.h>
+#include <fstream>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace Victor { namespace Align2{
+
+    __thread Instrumentation::Record *Instrumentation::record = 0;
+
+    // Records of all threads, kept after the threads exit.
+    static vector<Instrumentation::Record*> records;
+    static pthread_mutex_t recordsMutex = PTHREAD_MUTEX_INITIALIZER;
+    static string exitFileName;
+
+
+    // -----------------------------------------------------------------------------
+    //                            Instrumentation::Timer
+    // -----------------------------------------------------------------------------
+
+    Instrumentation::Timer::Timer(Phase p) : phase(p), start(now()) {
+    }
+
+    Instrumentation::Timer::~Timer() {
+        addTime(phase, now() - start);
+    }
+
+
+    // -----------------------------------------------------------------------------
+    //                               Instrumentation
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    bool
+    Instrumentation::isEnabled() {
+#ifdef ALIGN2_INSTRUMENT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    string
+    Instrumentation::getPhaseName(Phase p) {
+        switch (p) {
+            case DP_FILL:
+                return "dp_fill";
+            case TRACEBACK:
+                return "traceback";
+            case SUBOPTIMAL:
+                return "suboptimal";
+            case PROFILE:
+                return "profile";
+            case IO:
+                return "io";
+            default:
+                ERROR("Instrumentation::getPhaseName() Invalid phase.", exception);
+        }
+        return "";
+    }
+
+    string
+    Instrumentation::getCounterName(Counter c) {
+        switch (c) {
+            case CELLS:
+                return "cells";
+            case TRACEBACK_STEPS:
+                return "traceback_steps";
+            case MATRIX_RECALCULATIONS:
+                return "matrix_recalculations";
+            case BYTES_ALLOCATED:
+                return "bytes_allocated";
+            default:
+                ERROR("Instrumentation::getCounterName() Invalid counter.", exception);
+        }
+        return "";
+    }
+
+    double
+    Instrumentation::now() {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1E-9;
+    }
+    /**
+     * Output contains the sum over all threads followed by each thread.
+     * @param os
+     */
+    void
+    Instrumentation::dump(ostream &os) {
+        pthread_mutex_lock(&recordsMutex);
+
+        Record total;
+        memset(&total, 0, sizeof (Record));
+        for (unsigned int t = 0; t < records.size(); t++) {
+            for (unsigned int p = 0; p < PHASE_NUMBER; p++) {
+                total.calls[p] += records[t]->calls[p];
+                total.seconds[p] += records[t]->seconds[p];
+            }
+            for (unsigned int c = 0; c < COUNTER_NUMBER; c++)
+                total.counters[c] += records[t]->counters[c];
+        }
+
+        os << "{\n"
+                << "  \"enabled\": " << (isEnabled() ? "true" : "false") << ",\n"
+                << "  \"threads\": " << records.size() << ",\n"
+                << "  \"total\": ";
+        pWriteRecord(os, total, "  ");
+        os << ",\n  \"perThread\": [";
+        for (unsigned int t = 0; t < records.size(); t++) {
+            os << ((t == 0) ? "\n    " : ",\n    ");
+            pWriteRecord(os, *records[t], "    ");
+        }
+        os << (records.empty() ? "]\n}" : "\n  ]\n}") << endl;
+
+        pthread_mutex_unlock(&recordsMutex);
+    }
+
+
+    // MODIFIERS:
+
+    void
+    Instrumentation::addTime(Phase p, double seconds) {
+        Record *r = pGetRecord();
+        r->calls[p]++;
+        r->seconds[p] += seconds;
+    }
+
+    void
+    Instrumentation::reset() {
+        pthread_mutex_lock(&recordsMutex);
+        for (unsigned int t = 0; t < records.size(); t++)
+            memset(records[t], 0, sizeof (Record));
+        pthread_mutex_unlock(&recordsMutex);
+    }
+    /**
+     * 
+     * @param fileName
+     */
+    void
+    Instrumentation::dumpAtExit(const string &fileName) {
+        if (exitFileName.empty())
+            atexit(pDumpAtExit);
+        exitFileName = fileName;
+    }
+
+
+    // HELPERS:
+
+    Instrumentation::Record*
+    Instrumentation::pNewRecord() {
+        Record *r = new Record;
+        memset(r, 0, sizeof (Record));
+
+        pthread_mutex_lock(&recordsMutex);
+        records.push_back(r);
+        pthread_mutex_unlock(&recordsMutex);
+
+        return r;
+    }
+
+    void
+    Instrumentation::pWriteRecord(ostream &os, const Record &r,
+            const string &indent) {
+        os << "{\n" << indent << "  \"phases\": {";
+        for (unsigned int p = 0; p < PHASE_NUMBER; p++)
+            os << ((p == 0) ? "\n" : ",\n") << indent << "    \""
+                << getPhaseName(static_cast<Phase> (p)) << "\": {\"calls\": "
+                << r.calls[p] << ", \"seconds\": " << r.seconds[p] << "}";
+        os << "\n" << indent << "  },\n" << indent << "  \"counters\": {";
+        for (unsigned int c = 0; c < COUNTER_NUMBER; c++)
+            os << ((c == 0) ? "\n" : ",\n") << indent << "    \""
+                << getCounterName(static_cast<Counter> (c)) << "\": "
+                << r.counters[c];
+        os << "\n" << indent << "  }\n" << indent << "}";
+    }
+
+    void
+    Instrumentation::pDumpAtExit() {
+        if (exitFileName == "-") {
+            dump(cerr);
+            return;
+        }
+
+        ofstream out(exitFileName.c_str());
+        if (!out)
+            cerr << "Warning: cannot write instrumentation to " << exitFileName
+                << endl;
+        else
+            dump(out);
+    }
+
+}} // namespace
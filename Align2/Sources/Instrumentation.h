@@ -0,0 +1,173 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __Instrumentation_H__
+#define __Instrumentation_H__
+
+#include <Debug.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Per-phase timers and counters of the alignment hot paths.
+     * 
+     *    Records live in thread-local storage, one per thread, and are
+     *    merged only when dumped as JSON. The ALIGN2_TIMER and ALIGN2_COUNT
+     *    macros compile to nothing unless ALIGN2_INSTRUMENT is defined
+     *    (make instrument=1). Phase timers are inclusive: a traceback
+     *    started inside a suboptimal recomputation is timed by both.
+     **/
+    class Instrumentation {
+    public:
+
+        /// Timed phases.
+
+        enum Phase {
+            DP_FILL, ///< Filling of F and B.
+            TRACEBACK, ///< Walk of B from B0.
+            SUBOPTIMAL, ///< Suboptimal alignment recomputation.
+            PROFILE, ///< Profile construction.
+            IO, ///< Loading of alignment files.
+            PHASE_NUMBER
+        };
+
+        /// Counted events.
+
+        enum Counter {
+            CELLS, ///< Matrix cells computed.
+            TRACEBACK_STEPS, ///< Traceback steps taken.
+            MATRIX_RECALCULATIONS, ///< Full matrix recalculations.
+            BYTES_ALLOCATED, ///< Bytes allocated for F and B.
+            COUNTER_NUMBER
+        };
+
+        /// Values recorded by one thread.
+
+        struct Record {
+            unsigned long calls[PHASE_NUMBER]; ///< Times each phase was entered.
+            double seconds[PHASE_NUMBER]; ///< Time spent in each phase.
+            unsigned long counters[COUNTER_NUMBER]; ///< Counter values.
+        };
+
+        /// Scope timer adding its lifetime to a phase.
+
+        class Timer {
+        public:
+            Timer(Phase p);
+            ~Timer();
+        private:
+            Phase phase; ///< Timed phase.
+            double start; ///< Start time in seconds.
+        };
+
+
+        // PREDICATES:
+
+        /// Return true if compiled with ALIGN2_INSTRUMENT.
+        static bool isEnabled();
+
+        /// Return the JSON name of phase p.
+        static string getPhaseName(Phase p);
+
+        /// Return the JSON name of counter c.
+        static string getCounterName(Counter c);
+
+        /// Return a monotonic time in seconds.
+        static double now();
+
+        /// Write the records of all threads as JSON.
+        static void dump(ostream &os);
+
+
+        // MODIFIERS:
+
+        /// Add n to counter c of the calling thread.
+        static void count(Counter c, unsigned long n = 1);
+
+        /// Add a call lasting seconds to phase p of the calling thread.
+        static void addTime(Phase p, double seconds);
+
+        /// Clear the records of all threads.
+        static void reset();
+
+        /// Dump as JSON to fileName ("-" for stderr) when the process exits.
+        static void dumpAtExit(const string &fileName);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Return the record of the calling thread.
+        static Record* pGetRecord();
+
+        /// Allocate and register a record for the calling thread.
+        static Record* pNewRecord();
+
+        /// Write one record as a JSON object.
+        static void pWriteRecord(ostream &os, const Record &r,
+                const string &indent);
+
+        /// atexit() handler.
+        static void pDumpAtExit();
+
+
+        // ATTRIBUTES:
+
+        static __thread Record *record; ///< Record of the calling thread.
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               Instrumentation
+    // -----------------------------------------------------------------------------
+
+    // MODIFIERS:
+
+    inline void
+    Instrumentation::count(Counter c, unsigned long n) {
+        pGetRecord()->counters[c] += n;
+    }
+
+
+    // HELPERS:
+
+    inline Instrumentation::Record*
+    Instrumentation::pGetRecord() {
+        if (record == 0)
+            record = pNewRecord();
+        return record;
+    }
+
+}} // namespace
+
+#ifdef ALIGN2_INSTRUMENT
+#define ALIGN2_TIMER(p) \
+    Victor::Align2::Instrumentation::Timer _align2_timer_(Victor::Align2::Instrumentation::p)
+#define ALIGN2_COUNT(c, n) \
+    Victor::Align2::Instrumentation::count(Victor::Align2::Instrumentation::c, (n))
+#else
+#define ALIGN2_TIMER(p)
+#define ALIGN2_COUNT(c, n)
+#endif
+
+#endif
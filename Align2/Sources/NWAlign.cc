@@ -31,8 +31,9 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    NWAlign::NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    template <class T>
+    NWAlignT<T>::NWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
+    : AlignT<T>(ad, gf, ss) {
         pCalculateMatrix(true);
     }
     /**
@@ -43,16 +44,19 @@ namespace Victor { namespace Align2{
      * @param v1
      * @param v2
      */
-    NWAlign::NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+    template <class T>
+    NWAlignT<T>::NWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
             const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+    : AlignT<T>(ad, gf, ss) {
         pCalculateMatrix(v1, v2, true);
     }
 
-    NWAlign::NWAlign(const NWAlign &orig) : Align(orig) {
+    template <class T>
+    NWAlignT<T>::NWAlignT(const NWAlignT &orig) : AlignT<T>(orig) {
     }
 
-    NWAlign::~NWAlign() {
+    template <class T>
+    NWAlignT<T>::~NWAlignT() {
     }
 
 
@@ -62,8 +66,9 @@ namespace Victor { namespace Align2{
      * @param orig
      * @return 
      */
-    NWAlign&
-            NWAlign::operator =(const NWAlign &orig) {
+    template <class T>
+    NWAlignT<T>&
+            NWAlignT<T>::operator =(const NWAlignT &orig) {
         if (&orig != this)
             copy(orig);
         POSTCOND((orig == *this), exception);
@@ -75,8 +80,12 @@ namespace Victor { namespace Align2{
     /**
      * 
      */
+    template <class T>
     void
-    NWAlign::getMultiMatch() {
+    NWAlignT<T>::getMultiMatch() {
+        ALIGN2_TIMER(SUBOPTIMAL);
+        ALIGN2_COUNT(MATRIX_RECALCULATIONS, 1);
+
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -88,6 +97,7 @@ namespace Victor { namespace Align2{
             i = tb.i;
             j = tb.j;
             pModifyMatrix(i, j);
+            ALIGN2_COUNT(TRACEBACK_STEPS, 1);
             tb = next(tb);
         }
 
@@ -98,17 +108,19 @@ namespace Victor { namespace Align2{
 
     // MODIFIERS:
 
+    template <class T>
     void
-    NWAlign::copy(const NWAlign &orig) {
-        Align::copy(orig);
+    NWAlignT<T>::copy(const NWAlignT &orig) {
+        AlignT<T>::copy(orig);
     }
     /**
      * 
      * @return 
      */
-    NWAlign*
-    NWAlign::newCopy() {
-        NWAlign *tmp = new NWAlign(*this);
+    template <class T>
+    NWAlignT<T>*
+    NWAlignT<T>::newCopy() {
+        NWAlignT *tmp = new NWAlignT(*this);
         return tmp;
     }
 
@@ -118,61 +130,65 @@ namespace Victor { namespace Align2{
      * 
      * @param update
      */
+    template <class T>
     void
-    NWAlign::pCalculateMatrix(bool update) {
+    NWAlignT<T>::pCalculateMatrix(bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         if (update)
             F[0][0] = 0;
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = -gf->getOpenPenalty(0) -
-                gf->getExtensionPenalty(0) * (i - 1);
+                F[i][0] = ScoreTraits<T>::fromDouble(-gf->getOpenPenalty(0) -
+                        gf->getExtensionPenalty(0) * (i - 1));
             B[i][0] = Traceback(i - 1, 0);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = -gf->getOpenPenalty(j) -
-                gf->getExtensionPenalty(j) * (j - 1);
+                F[0][j] = ScoreTraits<T>::fromDouble(-gf->getOpenPenalty(j) -
+                        gf->getExtensionPenalty(j) * (j - 1));
             B[0][j] = Traceback(0, j - 1);
         }
 
         for (int i = 1; i <= static_cast<int> (n); i++)
             for (int j = 1; j <= static_cast<int> (m); j++) {
-                double s = ss->scoring(i, j);
-                double extI, extJ;
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j));
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
                         if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(z, extI), extJ);
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, z))
+                if (ScoreTraits<T>::equals(val, z))
                     B[i][j] = Traceback(i - 1, j - 1);
                 else
-                    if (EQUALS(val, extJ))
+                    if (ScoreTraits<T>::equals(val, extJ))
                     B[i][j] = Traceback(i, j - 1);
                 else
-                    if (EQUALS(val, extI))
+                    if (ScoreTraits<T>::equals(val, extI))
                     B[i][j] = Traceback(i - 1, j);
                 else
                     ERROR("Error in NWAlign: NW 1", exception);
@@ -189,9 +205,13 @@ namespace Victor { namespace Align2{
      * @param v2
      * @param update
      */
+    template <class T>
     void
-    NWAlign::pCalculateMatrix(const vector<unsigned int> &v1,
+    NWAlignT<T>::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
@@ -202,15 +222,15 @@ namespace Victor { namespace Align2{
 
         for (int i = 1; i <= static_cast<int> (n); i++) {
             if (update)
-                F[i][0] = -gf->getOpenPenalty(0) -
-                gf->getExtensionPenalty(0) * (i - 1);
+                F[i][0] = ScoreTraits<T>::fromDouble(-gf->getOpenPenalty(0) -
+                        gf->getExtensionPenalty(0) * (i - 1));
             B[i][0] = Traceback(i - 1, 0);
         }
 
         for (int j = 1; j <= static_cast<int> (m); j++) {
             if (update)
-                F[0][j] = -gf->getOpenPenalty(j) -
-                gf->getExtensionPenalty(j) * (j - 1);
+                F[0][j] = ScoreTraits<T>::fromDouble(-gf->getOpenPenalty(j) -
+                        gf->getExtensionPenalty(j) * (j - 1));
             B[0][j] = Traceback(0, j - 1);
         }
 
@@ -222,42 +242,42 @@ namespace Victor { namespace Align2{
                 else
                     minL = v2[j - 1];
 
-                double s = ss->scoring(i, j) * minL;
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j) * minL);
                 // end SSEA variant code
 
-                double extI, extJ;
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
                         if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(z, extI), extJ);
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, z))
+                if (ScoreTraits<T>::equals(val, z))
                     B[i][j] = Traceback(i - 1, j - 1);
                 else
-                    if (EQUALS(val, extJ))
+                    if (ScoreTraits<T>::equals(val, extJ))
                     B[i][j] = Traceback(i, j - 1);
                 else
-                    if (EQUALS(val, extI))
+                    if (ScoreTraits<T>::equals(val, extI))
                     B[i][j] = Traceback(i - 1, j);
                 else
                     ERROR("Error in NWAlign: NW 1", exception);
@@ -266,4 +286,10 @@ namespace Victor { namespace Align2{
         B0 = Traceback(n, m);
     }
 
+    // Explicit instantiations for the supported score types.
+    template class NWAlignT<short>;
+    template class NWAlignT<int>;
+    template class NWAlignT<float>;
+    template class NWAlignT<double>;
+
 }} // namespace
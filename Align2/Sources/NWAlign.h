@@ -26,29 +26,43 @@ namespace Victor { namespace Align2{
      *   
 
      **/
-    class NWAlign : public Align {
+    template <class T = double>
+    class NWAlignT : public AlignT<T> {
     public:
 
+        using AlignT<T>::ad;
+        using AlignT<T>::gf;
+        using AlignT<T>::ss;
+        using AlignT<T>::F;
+        using AlignT<T>::B;
+        using AlignT<T>::B0;
+        using AlignT<T>::n;
+        using AlignT<T>::m;
+        using AlignT<T>::next;
+        using AlignT<T>::pModifyMatrix;
+        using AlignT<T>::pOpenPenalty;
+        using AlignT<T>::pExtensionPenalty;
+
         // CONSTRUCTORS:
 
         /// Default constructor.
-        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        NWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
 
         /// Constructor with weighted alignment positions.
-        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+        NWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
                 const vector<unsigned int> &v1, const vector<unsigned int> &v2);
 
         /// Copy constructor.
-        NWAlign(const NWAlign &orig);
+        NWAlignT(const NWAlignT &orig);
 
         /// Destructor.
-        virtual ~NWAlign();
+        virtual ~NWAlignT();
 
 
         // OPERATORS:
 
         /// Assignment operator.
-        NWAlign& operator =(const NWAlign &orig);
+        NWAlignT& operator =(const NWAlignT &orig);
 
 
         // PREDICATES:
@@ -60,10 +74,10 @@ namespace Victor { namespace Align2{
         // MODIFIERS:
 
         /// Copy orig object to this object ("deep copy").
-        virtual void copy(const NWAlign &orig);
+        virtual void copy(const NWAlignT &orig);
 
         /// Construct a new "deep copy" of this object.
-        virtual NWAlign* newCopy();
+        virtual NWAlignT* newCopy();
 
 
         // HELPERS:
@@ -83,6 +97,9 @@ namespace Victor { namespace Align2{
 
     };
 
+    /// Needleman-Wunsch alignment on a double score matrix.
+    typedef NWAlignT<double> NWAlign;
+
 }} // namespace
 
 #endif
@@ -27,29 +27,43 @@ namespace Victor { namespace Align2{
      *   
 
      **/
-    class NWAlignNoTermGaps : public Align {
+    template <class T = double>
+    class NWAlignNoTermGapsT : public AlignT<T> {
     public:
 
+        using AlignT<T>::ad;
+        using AlignT<T>::gf;
+        using AlignT<T>::ss;
+        using AlignT<T>::F;
+        using AlignT<T>::B;
+        using AlignT<T>::B0;
+        using AlignT<T>::n;
+        using AlignT<T>::m;
+        using AlignT<T>::next;
+        using AlignT<T>::pModifyMatrix;
+        using AlignT<T>::pOpenPenalty;
+        using AlignT<T>::pExtensionPenalty;
+
         // CONSTRUCTORS:
 
         /// Default constructor.
-        NWAlignNoTermGaps(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        NWAlignNoTermGapsT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
 
         /// Constructor with weighted alignment positions.
-        NWAlignNoTermGaps(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+        NWAlignNoTermGapsT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
                 const vector<unsigned int> &v1, const vector<unsigned int> &v2);
 
         /// Copy constructor.
-        NWAlignNoTermGaps(const NWAlignNoTermGaps &orig);
+        NWAlignNoTermGapsT(const NWAlignNoTermGapsT &orig);
 
         /// Destructor.
-        virtual ~NWAlignNoTermGaps();
+        virtual ~NWAlignNoTermGapsT();
 
 
         // OPERATORS:
 
         /// Assignment operator.
-        NWAlignNoTermGaps& operator =(const NWAlignNoTermGaps &orig);
+        NWAlignNoTermGapsT& operator =(const NWAlignNoTermGapsT &orig);
 
 
         // PREDICATES:
@@ -61,10 +75,10 @@ namespace Victor { namespace Align2{
         // MODIFIERS:
 
         /// Copy orig object to this object ("deep copy").
-        virtual void copy(const NWAlignNoTermGaps &orig);
+        virtual void copy(const NWAlignNoTermGapsT &orig);
 
         /// Construct a new "deep copy" of this object.
-        virtual NWAlignNoTermGaps* newCopy();
+        virtual NWAlignNoTermGapsT* newCopy();
 
 
         // HELPERS:
@@ -84,6 +98,9 @@ namespace Victor { namespace Align2{
 
     };
 
+    /// Needleman-Wunsch (no terminal gaps) alignment on a double score matrix.
+    typedef NWAlignNoTermGapsT<double> NWAlignNoTermGaps;
+
 }} // namespace
 
 #endif
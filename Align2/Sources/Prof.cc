@@ -79,7 +79,8 @@ namespace Victor { namespace Align2{
         char mixTarget = phd1->getProfMixSSBE(ssTarget, beTarget);
         char mixTemplate = phd2->getProfMixSSBE(ssTemplate, beTemplate);
 
-        return cPrf * subStr->score[mixTarget][mixTemplate];
+        return cPrf * subStr->getScore(EncodedSequence::encode(mixTarget),
+                EncodedSequence::encode(mixTemplate));
     }
 
 
@@ -20,6 +20,7 @@
 //
 // -----------------x-----------------------------------------------------------
 
+#include <Instrumentation.h>
 #include <Profile.h>
 #include <ctime>
 namespace Victor { namespace Align2{
@@ -85,6 +86,7 @@ namespace Victor { namespace Align2{
      */
     void
     Profile::setProfile(Alignment &ali) {
+        ALIGN2_TIMER(PROFILE);
         struct tm* newtime;
         time_t t;
         pResetData();
@@ -102,6 +104,7 @@ namespace Victor { namespace Align2{
      */
     void
     Profile::setProfile(Alignment &ali, istream &is) {
+        ALIGN2_TIMER(PROFILE);
         pResetData();
         cout << "ali:  " << ali.getTarget();
         seqLen = ali.getTarget().size();
@@ -32,28 +32,33 @@ namespace Victor { namespace Align2{
      * @param gf
      * @param ss
      */
-    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    template <class T>
+    SWAlignT<T>::SWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
+    : AlignT<T>(ad, gf, ss) {
         pCalculateMatrix(true);
     }
 
-    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+    template <class T>
+    SWAlignT<T>::SWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
             const vector<unsigned int> &v1, const vector<unsigned int> &v2)
-    : Align(ad, gf, ss) {
+    : AlignT<T>(ad, gf, ss) {
         pCalculateMatrix(v1, v2, true);
     }
 
-    SWAlign::SWAlign(const SWAlign &orig) : Align(orig) {
+    template <class T>
+    SWAlignT<T>::SWAlignT(const SWAlignT &orig) : AlignT<T>(orig) {
     }
 
-    SWAlign::~SWAlign() {
+    template <class T>
+    SWAlignT<T>::~SWAlignT() {
     }
 
 
     // OPERATORS:
 
-    SWAlign&
-            SWAlign::operator =(const SWAlign &orig) {
+    template <class T>
+    SWAlignT<T>&
+            SWAlignT<T>::operator =(const SWAlignT &orig) {
         if (&orig != this)
             copy(orig);
         POSTCOND((orig == *this), exception);
@@ -65,8 +70,12 @@ namespace Victor { namespace Align2{
     /**
      * 
      */
+    template <class T>
     void
-    SWAlign::getMultiMatch() {
+    SWAlignT<T>::getMultiMatch() {
+        ALIGN2_TIMER(SUBOPTIMAL);
+        ALIGN2_COUNT(MATRIX_RECALCULATIONS, 1);
+
         Traceback tb = B0;
         int i = tb.i;
         int j = tb.j;
@@ -78,6 +87,7 @@ namespace Victor { namespace Align2{
             i = tb.i;
             j = tb.j;
             pModifyMatrix(i, j);
+            ALIGN2_COUNT(TRACEBACK_STEPS, 1);
             tb = next(tb);
         }
 
@@ -88,17 +98,19 @@ namespace Victor { namespace Align2{
 
     // MODIFIERS:
 
+    template <class T>
     void
-    SWAlign::copy(const SWAlign &orig) {
-        Align::copy(orig);
+    SWAlignT<T>::copy(const SWAlignT &orig) {
+        AlignT<T>::copy(orig);
     }
     /**
      * 
      * @return 
      */
-    SWAlign*
-    SWAlign::newCopy() {
-        SWAlign *tmp = new SWAlign(*this);
+    template <class T>
+    SWAlignT<T>*
+    SWAlignT<T>::newCopy() {
+        SWAlignT *tmp = new SWAlignT(*this);
         return tmp;
     }
 
@@ -108,52 +120,56 @@ namespace Victor { namespace Align2{
      * 
      * @param update
      */
+    template <class T>
     void
-    SWAlign::pCalculateMatrix(bool update) {
+    SWAlignT<T>::pCalculateMatrix(bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         int maxi = n;
         int maxj = m;
         double maxval = INT_MIN;
 
         for (int i = 1; i <= static_cast<int> (n); i++)
             for (int j = 1; j <= static_cast<int> (m); j++) {
-                double s = ss->scoring(i, j);
-                double extI, extJ;
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j));
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
                         if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(max(z, extI), extJ), 0.00);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(max(z, extI), extJ), static_cast<T> (0));
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, 0))
+                if (ScoreTraits<T>::equals(val, 0))
                     B[i][j] = Traceback::getInvalidTraceback();
                 else
                     if (val > 0) {
-                    if (EQUALS(val, z))
+                    if (ScoreTraits<T>::equals(val, z))
                         B[i][j] = Traceback(i - 1, j - 1);
                     else
-                        if (EQUALS(val, extJ))
+                        if (ScoreTraits<T>::equals(val, extJ))
                         B[i][j] = Traceback(i, j - 1);
                     else
-                        if (EQUALS(val, extI))
+                        if (ScoreTraits<T>::equals(val, extI))
                         B[i][j] = Traceback(i - 1, j);
                     else
                         ERROR("Error in SWAlign: SW 1", exception);
@@ -178,9 +194,13 @@ namespace Victor { namespace Align2{
      * @param v2
      * @param update
      */
+    template <class T>
     void
-    SWAlign::pCalculateMatrix(const vector<unsigned int> &v1,
+    SWAlignT<T>::pCalculateMatrix(const vector<unsigned int> &v1,
             const vector<unsigned int> &v2, bool update) {
+        ALIGN2_TIMER(DP_FILL);
+        ALIGN2_COUNT(CELLS, n * m);
+
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
         unsigned int minL = 0;
@@ -198,46 +218,46 @@ namespace Victor { namespace Align2{
                 else
                     minL = v2[j - 1];
 
-                double s = ss->scoring(i, j) * minL;
+                T s = ScoreTraits<T>::fromDouble(ss->scoring(i, j) * minL);
                 // end SSEA variant
 
-                double extI, extJ;
+                T extI, extJ;
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
+                        extI = F[i - 1][j] - pExtensionPenalty(j);
                     else
                         if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                        extI = F[i - 1][j] - pOpenPenalty(j);
                 } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
+                    extI = F[i - 1][j] - pOpenPenalty(j);
 
                 if ((i != 1) && (j != 1)) {
                     if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
+                        extJ = F[i][j - 1] - pExtensionPenalty(j);
                     else
                         if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                        extJ = F[i][j - 1] - pOpenPenalty(j);
                 } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
+                    extJ = F[i][j - 1] - pOpenPenalty(j);
 
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(max(z, extI), extJ), 0.00);
+                T z = F[i - 1][j - 1] + s;
+                T val = max(max(max(z, extI), extJ), static_cast<T> (0));
 
                 if (update)
                     F[i][j] = val;
 
-                if (EQUALS(val, 0))
+                if (ScoreTraits<T>::equals(val, 0))
                     B[i][j] = Traceback::getInvalidTraceback();
                 else
                     if (val > 0) {
-                    if (EQUALS(val, z))
+                    if (ScoreTraits<T>::equals(val, z))
                         B[i][j] = Traceback(i - 1, j - 1);
                     else
-                        if (EQUALS(val, extJ))
+                        if (ScoreTraits<T>::equals(val, extJ))
                         B[i][j] = Traceback(i, j - 1);
                     else
-                        if (EQUALS(val, extI))
+                        if (ScoreTraits<T>::equals(val, extI))
                         B[i][j] = Traceback(i - 1, j);
                     else
                         ERROR("Error in SWAlign: SW 1", exception);
@@ -254,4 +274,10 @@ namespace Victor { namespace Align2{
             }
     }
 
+    // Explicit instantiations for the supported score types.
+    template class SWAlignT<short>;
+    template class SWAlignT<int>;
+    template class SWAlignT<float>;
+    template class SWAlignT<double>;
+
 }} // namespace
@@ -27,29 +27,43 @@ namespace Victor { namespace Align2{
      *   
 
      **/
-    class SWAlign : public Align {
+    template <class T = double>
+    class SWAlignT : public AlignT<T> {
     public:
 
+        using AlignT<T>::ad;
+        using AlignT<T>::gf;
+        using AlignT<T>::ss;
+        using AlignT<T>::F;
+        using AlignT<T>::B;
+        using AlignT<T>::B0;
+        using AlignT<T>::n;
+        using AlignT<T>::m;
+        using AlignT<T>::next;
+        using AlignT<T>::pModifyMatrix;
+        using AlignT<T>::pOpenPenalty;
+        using AlignT<T>::pExtensionPenalty;
+
         // CONSTRUCTORS:
 
         /// Default constructor.
-        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        SWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
 
         /// Constructor with weighted alignment positions.
-        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+        SWAlignT(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
                 const vector<unsigned int> &v1, const vector<unsigned int> &v2);
 
         /// Copy constructor.
-        SWAlign(const SWAlign &orig);
+        SWAlignT(const SWAlignT &orig);
 
         /// Destructor.
-        virtual ~SWAlign();
+        virtual ~SWAlignT();
 
 
         // OPERATORS:
 
         /// Assignment operator.
-        SWAlign& operator =(const SWAlign &orig);
+        SWAlignT& operator =(const SWAlignT &orig);
 
 
         // PREDICATES:
@@ -61,10 +75,10 @@ namespace Victor { namespace Align2{
         // MODIFIERS:
 
         /// Copy orig object to this object ("deep copy").
-        virtual void copy(const SWAlign &orig);
+        virtual void copy(const SWAlignT &orig);
 
         /// Construct a new "deep copy" of this object.
-        virtual SWAlign* newCopy();
+        virtual SWAlignT* newCopy();
 
 
         // HELPERS:
@@ -84,6 +98,9 @@ namespace Victor { namespace Align2{
 
     };
 
+    /// Smith-Waterman alignment on a double score matrix.
+    typedef SWAlignT<double> SWAlign;
+
 }} // namespace
 
 #endif
@@ -0,0 +1,116 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __ScoreTraits_H__
+#define __ScoreTraits_H__
+
+#include <limits>
+#include <math.h>
+#include <string>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Numeric properties of the scalar types usable for DP matrices.
+     * 
+     *    Integer types compare exactly and round incoming scores, floating
+     *    point types compare within a tolerance matching their precision.
+     **/
+    template <class T>
+    struct ScoreTraits {
+    };
+
+    template <>
+    struct ScoreTraits<short> {
+
+        /// Convert a score to the matrix type.
+        static short fromDouble(double x) {
+            return static_cast<short> (floor(x + 0.5));
+        }
+
+        /// Return true if a and b represent the same score.
+        static bool equals(short a, short b) {
+            return a == b;
+        }
+
+        /// Name of the type, as used in messages.
+        static std::string getName() {
+            return "int16";
+        }
+    };
+
+    template <>
+    struct ScoreTraits<int> {
+
+        /// Convert a score to the matrix type.
+        static int fromDouble(double x) {
+            return static_cast<int> (floor(x + 0.5));
+        }
+
+        /// Return true if a and b represent the same score.
+        static bool equals(int a, int b) {
+            return a == b;
+        }
+
+        /// Name of the type, as used in messages.
+        static std::string getName() {
+            return "int32";
+        }
+    };
+
+    template <>
+    struct ScoreTraits<float> {
+
+        /// Convert a score to the matrix type.
+        static float fromDouble(double x) {
+            return static_cast<float> (x);
+        }
+
+        /// Return true if a and b represent the same score.
+        static bool equals(float a, float b) {
+            float scale = fabs(a) > 1.0f ? fabs(a) : 1.0f;
+            return fabs(a - b) < 4 * std::numeric_limits<float>::epsilon() * scale;
+        }
+
+        /// Name of the type, as used in messages.
+        static std::string getName() {
+            return "float";
+        }
+    };
+
+    template <>
+    struct ScoreTraits<double> {
+
+        /// Convert a score to the matrix type.
+        static double fromDouble(double x) {
+            return x;
+        }
+
+        /// Return true if a and b represent the same score.
+        static bool equals(double a, double b) {
+            return fabs(a - b) < 1E-8;
+        }
+
+        /// Name of the type, as used in messages.
+        static std::string getName() {
+            return "double";
+        }
+    };
+
+}} // namespace
+
+#endif
@@ -0,0 +1,118 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Select the scalar type of the DP matrices from score
+//                  ranges.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <ScoreTypePolicy.h>
+
+namespace Victor { namespace Align2{
+
+    // PREDICATES:
+    /**
+     * 
+     * @param minScore lowest substitution score
+     * @param maxScore highest substitution score
+     * @param maxPenalty highest open or extension gap penalty
+     * @param n length of target sequence
+     * @param m length of template sequence
+     * @param integral true if all scores and penalties are integral
+     * @param allowFloat true if float precision is acceptable
+     * @return 
+     */
+    ScoreTypePolicy::ScoreType
+    ScoreTypePolicy::select(double minScore, double maxScore, double maxPenalty,
+            unsigned int n, unsigned int m, bool integral, bool allowFloat) {
+        double step = max(max(fabs(minScore), fabs(maxScore)), fabs(maxPenalty));
+        // Every path has at most n + m steps, recalculateMatrix() resets to -999.
+        double bound = step * (n + m + 1) + 999;
+
+        if (integral) {
+            if (bound < numeric_limits<short>::max())
+                return INT16;
+            if (bound < numeric_limits<int>::max())
+                return INT32;
+        }
+
+        // Keep float only where it still resolves differences of 1E-2.
+        if (allowFloat && (bound < 1E5))
+            return FLOAT32;
+
+        return FLOAT64;
+    }
+    /**
+     * 
+     * @param sub substitution matrix
+     * @param cSeq coefficient for sequence alignment
+     * @param openPenalty open gap penalty
+     * @param extensionPenalty extension gap penalty
+     * @param n length of target sequence
+     * @param m length of template sequence
+     * @param allowFloat true if float precision is acceptable
+     * @return 
+     */
+    ScoreTypePolicy::ScoreType
+    ScoreTypePolicy::select(const Substitution &sub, double cSeq,
+            double openPenalty, double extensionPenalty, unsigned int n,
+            unsigned int m, bool allowFloat) {
+        double minScore = 0.00;
+        double maxScore = 0.00;
+        bool integral = pIsIntegral(cSeq) && pIsIntegral(openPenalty) &&
+                pIsIntegral(extensionPenalty);
+
+        for (unsigned int i = 0; i < EncodedSequence::ALPHABET_SIZE; i++)
+            for (unsigned int j = 0; j < EncodedSequence::ALPHABET_SIZE; j++) {
+                double s = cSeq * sub.getScore(i, j);
+                minScore = min(minScore, s);
+                maxScore = max(maxScore, s);
+            }
+
+        return select(minScore, maxScore, max(openPenalty, extensionPenalty),
+                n, m, integral, allowFloat);
+    }
+    /**
+     * 
+     * @param t
+     * @return 
+     */
+    string
+    ScoreTypePolicy::getName(ScoreType t) {
+        switch (t) {
+            case INT16:
+                return ScoreTraits<short>::getName();
+            case INT32:
+                return ScoreTraits<int>::getName();
+            case FLOAT32:
+                return ScoreTraits<float>::getName();
+            default:
+                return ScoreTraits<double>::getName();
+        }
+    }
+
+
+    // HELPERS:
+
+    bool
+    ScoreTypePolicy::pIsIntegral(double x) {
+        return (fabs(x - floor(x + 0.5)) < 1E-8);
+    }
+
+}} // namespace
@@ -0,0 +1,101 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __ScoreTypePolicy_H__
+#define __ScoreTypePolicy_H__
+
+#include <Align.h>
+#include <Substitution.h>
+#include <string>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Select the scalar type of the DP matrices from score ranges.
+     * 
+     *    Integer types are chosen only when every score and gap penalty is
+     *    integral, so that they give the same alignment as double. The
+     *    bound on the matrix values accounts for the longest possible path
+     *    through the matrix and for the reset value used by
+     *    Align::recalculateMatrix().
+     **/
+    class ScoreTypePolicy {
+    public:
+
+        /// Scalar types available for the DP matrices.
+
+        enum ScoreType {
+            INT16, INT32, FLOAT32, FLOAT64
+        };
+
+
+        // PREDICATES:
+
+        /// Return the narrowest type holding every reachable matrix value.
+        static ScoreType select(double minScore, double maxScore,
+                double maxPenalty, unsigned int n, unsigned int m,
+                bool integral, bool allowFloat = false);
+
+        /// Return the narrowest type for a sequence to sequence alignment.
+        static ScoreType select(const Substitution &sub, double cSeq,
+                double openPenalty, double extensionPenalty, unsigned int n,
+                unsigned int m, bool allowFloat = false);
+
+        /// Return the name of t.
+        static string getName(ScoreType t);
+
+        /// Construct an alignment of kind A with score matrix of type t.
+        template <template <class> class A>
+        static Align* newAlign(ScoreType t, AlignmentData *ad, GapFunction *gf,
+                ScoringScheme *ss);
+
+
+    protected:
+
+
+    private:
+
+        /// Return true if x has no fractional part.
+        static bool pIsIntegral(double x);
+
+    };
+
+    // -----------------------------------------------------------------------------
+    //                               ScoreTypePolicy
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    template <template <class> class A>
+    inline Align*
+    ScoreTypePolicy::newAlign(ScoreType t, AlignmentData *ad, GapFunction *gf,
+            ScoringScheme *ss) {
+        switch (t) {
+            case INT16:
+                return new A<short>(ad, gf, ss);
+            case INT32:
+                return new A<int>(ad, gf, ss);
+            case FLOAT32:
+                return new A<float>(ad, gf, ss);
+            default:
+                return new A<double>(ad, gf, ss);
+        }
+    }
+
+}} // namespace
+
+#endif
@@ -75,7 +75,7 @@ namespace Victor { namespace Align2{
     ScoringP2P::scoring(int i, int j) {
         double s = cSeq * fun->scoringSeq(i, j);
         if (str != 0)
-            s += str->scoringStr(i, j);
+            s += str->getScoringStr(i, j);
         return s;
     }
 
@@ -109,10 +109,7 @@ namespace Victor { namespace Align2{
     ScoringP2P::reverse() {
         ScoringScheme::reverse();
 
-        string tmp = "";
-        for (unsigned int i = seq2.length(); i > 0; i--)
-            tmp.push_back(seq2[i - 1]);
-        seq2 = tmp;
+        seq2.reverse();
 
         pro2->reverse();
     }
@@ -76,8 +76,8 @@ namespace Victor { namespace Align2{
 
         // ATTRIBUTES:
 
-        string seq1; ///< Target sequence.
-        string seq2; ///< Template sequence.
+        EncodedSequence seq1; ///< Target sequence.
+        EncodedSequence seq2; ///< Template sequence.
         Profile *pro1; ///< Target profile.
         Profile *pro2; ///< Template profile.
         ScoringFunction *fun; ///< Scoring function.
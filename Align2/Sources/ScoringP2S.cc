@@ -63,14 +63,15 @@ namespace Victor { namespace Align2{
         double s = 0.00;
 
         for (AminoAcidCode amino = ALA; amino < TYR; amino++) {
-            char aminoacid = aminoAcidOneLetterTranslator(amino);
-            s += (sub->score[seq2[j - 1]][aminoacid]) *
+            EncodedSequence::Residue aminoacid =
+                    EncodedSequence::encode(aminoAcidOneLetterTranslator(amino));
+            s += (sub->getScore(seq2[j - 1], aminoacid)) *
                     (pro->getAminoFrequencyFromCode(amino, (i - 1)));
         }
         s *= cSeq;
 
         if (str != 0)
-            s += str->scoringStr(i, j);
+            s += str->getScoringStr(i, j);
 
         return s;
     }
@@ -97,10 +98,7 @@ namespace Victor { namespace Align2{
     ScoringP2S::reverse() {
         ScoringScheme::reverse();
 
-        string tmp = "";
-        for (unsigned int i = seq2.length(); i > 0; i--)
-            tmp.push_back(seq2[i - 1]);
-        seq2 = tmp;
+        seq2.reverse();
     }
 
 }} // namespace
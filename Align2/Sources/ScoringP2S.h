@@ -75,8 +75,8 @@ namespace Victor { namespace Align2{
 
         // ATTRIBUTES:
 
-        string seq1; ///< Target sequence.
-        string seq2; ///< Template sequence.
+        EncodedSequence seq1; ///< Target sequence.
+        EncodedSequence seq2; ///< Template sequence.
         Profile *pro; ///< Target profile.
         double cSeq; ///< Coefficient for sequence alignment.
 
@@ -67,10 +67,10 @@ namespace Victor { namespace Align2{
      */
     double
     ScoringS2S::scoring(int i, int j) {
-        double s = cSeq * sub->score[seq1[i - 1]][seq2[j - 1]];
+        double s = cSeq * sub->getScore(seq1[i - 1], seq2[j - 1]);
 
         if (str != 0)
-            s += str->scoringStr(i, j);
+            s += str->getScoringStr(i, j);
 
         return s;
     }
@@ -101,10 +101,7 @@ namespace Victor { namespace Align2{
     ScoringS2S::reverse() {
         ScoringScheme::reverse();
 
-        string tmp = "";
-        for (unsigned int i = seq2.length(); i > 0; i--)
-            tmp.push_back(seq2[i - 1]);
-        seq2 = tmp;
+        seq2.reverse();
     }
 
 }} // namespace
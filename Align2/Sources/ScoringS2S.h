@@ -73,8 +73,8 @@ namespace Victor { namespace Align2{
 
         // ATTRIBUTES:
 
-        string seq1; ///< Target sequence.
-        string seq2; ///< Template sequence.
+        EncodedSequence seq1; ///< Target sequence.
+        EncodedSequence seq2; ///< Template sequence.
         double cSeq; ///< Coefficient for sequence alignment.
 
     };
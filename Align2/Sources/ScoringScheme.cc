@@ -110,8 +110,10 @@ namespace Victor { namespace Align2{
 
     void
     ScoringScheme::reverse() {
-        if (str != 0)
+        if (str != 0) {
             str->reverse();
+            str->refreshTable();
+        }
     }
 
 }} // namespace
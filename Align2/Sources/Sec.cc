@@ -65,7 +65,7 @@ namespace Victor { namespace Align2{
      */
     double
     Sec::scoringStr(int i, int j) {
-        return cSec * subStr->score[sec1[i - 1]][sec2[j - 1]];
+        return cSec * subStr->getScore(sec1[i - 1], sec2[j - 1]);
     }
 
 
@@ -95,10 +95,7 @@ namespace Victor { namespace Align2{
      */
     void
     Sec::reverse() {
-        string tmp = "";
-        for (unsigned int i = sec2.length(); i > 0; i--)
-            tmp.push_back(sec2[i - 1]);
-        sec2 = tmp;
+        sec2.reverse();
     }
 
 }} // namespace
@@ -74,8 +74,8 @@ namespace Victor { namespace Align2{
 
         // ATTRIBUTES:
 
-        string sec1; ///< Target secondary structure.
-        string sec2; ///< Template secondary structure.
+        EncodedSequence sec1; ///< Target secondary structure.
+        EncodedSequence sec2; ///< Template secondary structure.
         double cSec; ///< Coefficient for secondary structure alignment.
 
     };
@@ -60,7 +60,10 @@ namespace Victor { namespace Align2{
      */
     double
     Ss2::scoringStr(int i, int j) {
-        const string ss2_indices = "HEC";
+        const EncodedSequence::Residue ss2_indices[3] = {
+            EncodedSequence::encode('H'), EncodedSequence::encode('E'),
+            EncodedSequence::encode('C')
+        };
 
 
         // Target PSI-PRED input file
@@ -68,9 +71,9 @@ namespace Victor { namespace Align2{
         double weigthH = psipred1->score((i - 1), 1);
         double weigthE = psipred1->score((i - 1), 2);
         double weigthC = psipred1->score((i - 1), 0);
-        int substiH = subStr->score[sec2[j - 1]][ss2_indices[0]];
-        int substiE = subStr->score[sec2[j - 1]][ss2_indices[1]];
-        int substiC = subStr->score[sec2[j - 1]][ss2_indices[2]];
+        int substiH = subStr->getScore(sec2[j - 1], ss2_indices[0]);
+        int substiE = subStr->getScore(sec2[j - 1], ss2_indices[1]);
+        int substiC = subStr->getScore(sec2[j - 1], ss2_indices[2]);
         double tmp1 = weigthH * substiH + weigthE * substiE + weigthC * substiC;
 
 
@@ -79,9 +82,9 @@ namespace Victor { namespace Align2{
         weigthH = psipred2->score((j - 1), 1);
         weigthE = psipred2->score((j - 1), 2);
         weigthC = psipred2->score((j - 1), 0);
-        substiH = subStr->score[sec1[i - 1]][ss2_indices[0]];
-        substiE = subStr->score[sec1[i - 1]][ss2_indices[1]];
-        substiC = subStr->score[sec1[i - 1]][ss2_indices[2]];
+        substiH = subStr->getScore(sec1[i - 1], ss2_indices[0]);
+        substiE = subStr->getScore(sec1[i - 1], ss2_indices[1]);
+        substiC = subStr->getScore(sec1[i - 1], ss2_indices[2]);
         double tmp2 = weigthH * substiH + weigthE * substiE + weigthC * substiC;
 
 
@@ -117,10 +120,7 @@ namespace Victor { namespace Align2{
      */
     void
     Ss2::reverse() {
-        string tmp = "";
-        for (unsigned int i = sec2.length(); i > 0; i--)
-            tmp.push_back(sec2[i - 1]);
-        sec2 = tmp;
+        sec2.reverse();
     }
 
 }} // namespace
@@ -76,8 +76,8 @@ namespace Victor { namespace Align2{
 
         // ATTRIBUTES:
 
-        string sec1; ///< Target secondary structure.
-        string sec2; ///< Template secondary structure.
+        EncodedSequence sec1; ///< Target secondary structure.
+        EncodedSequence sec2; ///< Template secondary structure.
         Ss2Input *psipred1; ///< Target PSI-PRED input file.
         Ss2Input *psipred2; ///< Template PSI-PRED input file.
         double cSs2; ///< Coefficient for PSI-PRED prediction.
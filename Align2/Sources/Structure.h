@@ -18,25 +18,37 @@
 #ifndef __Structure_H__
 #define __Structure_H__
 
+#include <EncodedSequence.h>
 #include <SubMatrix.h>
 #include <math.h>
 #include <string>
+#include <vector>
 
 namespace Victor { namespace Align2{
 
     /** @brief   Base class for structural scores.
      * 
-     *   
-
+     *    The n x m structural scores can be materialized once per alignment
+     *    with precompute(), so that every DP pass reads them from a table.
+     *    If the table exceeds the memory budget the scores are evaluated on
+     *    the fly by scoringStr().
      **/
     class Structure {
     public:
 
+        /// Default memory budget for the precomputed table (64 MB).
+
+        enum {
+            DEFAULT_TABLE_BYTES = 67108864
+        };
+
+
         // CONSTRUCTORS:
 
         /// Default constructor.
 
-        Structure(SubMatrix *subStr) : subStr(subStr) {
+        Structure(SubMatrix *subStr) : subStr(subStr), table(), tableM(0),
+        maxTableBytes(DEFAULT_TABLE_BYTES) {
         }
 
         /// Copy constructor.
@@ -62,6 +74,12 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoringStr(int i, int j) = 0;
 
+        /// Return structural score, from the precomputed table if present.
+        double getScoringStr(int i, int j);
+
+        /// Return true if the structural scores are held in a table.
+        bool isPrecomputed() const;
+
 
         // MODIFIERS:
 
@@ -76,6 +94,18 @@ namespace Victor { namespace Align2{
         virtual void reverse() {
         }
 
+        /// Materialize the n x m structural scores if they fit the budget.
+        bool precompute(unsigned int n, unsigned int m);
+
+        /// Recompute the table after the structural components changed.
+        void refreshTable();
+
+        /// Drop the precomputed table.
+        void clearTable();
+
+        /// Set the memory budget of the table in bytes (0 disables it).
+        void setTableBudget(unsigned long bytes);
+
 
         // ATTRIBUTES:
 
@@ -84,6 +114,12 @@ namespace Victor { namespace Align2{
 
     protected:
 
+        // ATTRIBUTES:
+
+        vector<double> table; ///< Precomputed structural scores, row-major.
+        unsigned int tableM; ///< Number of columns of the table.
+        unsigned long maxTableBytes; ///< Memory budget of the table.
+
 
     private:
 
@@ -104,11 +140,72 @@ namespace Victor { namespace Align2{
     }
 
 
+    // PREDICATES:
+
+    inline double
+    Structure::getScoringStr(int i, int j) {
+        if (!table.empty())
+            return table[(i - 1) * tableM + (j - 1)];
+        return scoringStr(i, j);
+    }
+
+    inline bool
+    Structure::isPrecomputed() const {
+        return !table.empty();
+    }
+
+
     // MODIFIERS:
 
     inline void
     Structure::copy(const Structure &orig) {
         subStr = orig.subStr->newCopy();
+        table = orig.table;
+        tableM = orig.tableM;
+        maxTableBytes = orig.maxTableBytes;
+    }
+    /**
+     * 
+     * @param n length of target sequence
+     * @param m length of template sequence
+     * @return true if the table was built
+     */
+    inline bool
+    Structure::precompute(unsigned int n, unsigned int m) {
+        clearTable();
+        if ((n == 0) || (m == 0) ||
+                (static_cast<double> (n) * m * sizeof (double) > maxTableBytes))
+            return false;
+
+        table.resize(n * m);
+        for (unsigned int i = 1; i <= n; i++)
+            for (unsigned int j = 1; j <= m; j++)
+                table[(i - 1) * m + (j - 1)] = scoringStr(i, j);
+        tableM = m;
+
+        return true;
+    }
+
+    inline void
+    Structure::refreshTable() {
+        if (!table.empty()) {
+            unsigned int n = table.size() / tableM;
+            unsigned int m = tableM;
+            precompute(n, m);
+        }
+    }
+
+    inline void
+    Structure::clearTable() {
+        vector<double>().swap(table);
+        tableM = 0;
+    }
+
+    inline void
+    Structure::setTableBudget(unsigned long bytes) {
+        maxTableBytes = bytes;
+        if (static_cast<double> (table.size()) * sizeof (double) > maxTableBytes)
+            clearTable();
     }
 
 }} // namespace
@@ -28,6 +28,7 @@ namespace Victor { namespace Align2{
     // CONSTRUCTORS:
 
     Substitution::Substitution() {
+        pSetDenseScore();
     }
 
     Substitution::Substitution(const Substitution &orig) {
@@ -66,6 +67,7 @@ namespace Victor { namespace Align2{
     istream&
     operator >>(istream &is, Substitution &object) {
         Substitution::pReadDoubleVector(is, object.score);
+        object.pSetDenseScore();
         return is;
     }
 
@@ -86,6 +88,7 @@ namespace Victor { namespace Align2{
                 tmp.push_back(orig.score[i][j]);
             score.push_back(tmp);
         }
+        pSetDenseScore();
     }
     /**
      * 
@@ -113,6 +116,8 @@ namespace Victor { namespace Align2{
                         residuescores[i][j];
             }
         }
+
+        pSetDenseScore();
     }
 
 
@@ -134,6 +139,21 @@ namespace Victor { namespace Align2{
 
         os << "\n";
     }
+
+    void
+    Substitution::pSetDenseScore() {
+        for (unsigned int i = 0; i < EncodedSequence::ALPHABET_SIZE; i++)
+            for (unsigned int j = 0; j < EncodedSequence::ALPHABET_SIZE; j++) {
+                unsigned char c1 = EncodedSequence::decode(i);
+                unsigned char c2 = EncodedSequence::decode(j);
+                if ((i == EncodedSequence::UNKNOWN_CODE) ||
+                        (j == EncodedSequence::UNKNOWN_CODE) ||
+                        (c1 >= score.size()) || (c2 >= score[c1].size()))
+                    denseScore[i][j] = 0;
+                else
+                    denseScore[i][j] = score[c1][c2];
+            }
+    }
     /**
      * 
      * @param is
@@ -19,6 +19,7 @@
 #define __Substitution_H__
 
 #include <Debug.h>
+#include <EncodedSequence.h>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -62,6 +63,9 @@ namespace Victor { namespace Align2{
         /// Dummy implementation.
         virtual string getResidues() const = 0;
 
+        /// Return substitution score of two encoded residues.
+        int getScore(EncodedSequence::Residue r1, EncodedSequence::Residue r2) const;
+
 
         // MODIFIERS:
 
@@ -84,23 +88,44 @@ namespace Victor { namespace Align2{
                 vector<vector<T> > data);
          */
         static void pWriteDoubleVector(ostream &os, vector<vector<int> > data);
+
         /// Helper function used to read a vector<vector> construct.
         template<class T> static void pReadDoubleVector(istream &is,
                 vector<vector<T> > &data);
 
 
-        // ATTRIBUTES:
+    protected:
 
-        vector< vector<int> > score; ///< Substitution score.
+        // HELPERS:
 
+        /// Fill the dense table of encoded residues from score.
+        void pSetDenseScore();
 
-    protected:
+
+        // ATTRIBUTES:
+
+        /// Substitution score indexed by ASCII characters. Only read through
+        /// getScore(); whoever writes it must call pSetDenseScore() after.
+        vector< vector<int> > score;
+        int denseScore[EncodedSequence::ALPHABET_SIZE][EncodedSequence::ALPHABET_SIZE]; ///< Substitution score by residue code.
 
 
     private:
 
     };
 
+    // -----------------------------------------------------------------------------
+    //                                Substitution
+    // -----------------------------------------------------------------------------
+
+    // PREDICATES:
+
+    inline int
+    Substitution::getScore(EncodedSequence::Residue r1,
+            EncodedSequence::Residue r2) const {
+        return denseScore[EncodedSequence::index(r1)][EncodedSequence::index(r2)];
+    }
+
 }} // namespace
 
 #endif
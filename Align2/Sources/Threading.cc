@@ -30,6 +30,7 @@ namespace Victor { namespace Align2{
 
     Threading::Threading(AlignmentData *ad, ThreadingInput *thread, double cThr)
     : Structure(0), seq1(ad->getSequence(1)), thread(thread), cThr(cThr) {
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
     }
 
     Threading::Threading(const Threading &orig) : Structure(orig) {
@@ -64,18 +65,7 @@ namespace Victor { namespace Align2{
      */
     double
     Threading::scoringStr(int i, int j) {
-        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
-
-        char aaTarget = seq1[i - 1];
-        int targetIndex = 0;
-
-        for (int k = 0; k < 20; k++)
-            if (aaTarget == residue_indices[k]) {
-                targetIndex = k;
-                break;
-            }
-
-        return cThr * thread->score(targetIndex, (j - 1));
+        return cThr * thread->score(targetIndex[i - 1], (j - 1));
     }
 
 
@@ -88,6 +78,7 @@ namespace Victor { namespace Align2{
     Threading::copy(const Threading &orig) {
         Structure::copy(orig);
         seq1 = orig.seq1;
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
         thread = orig.thread->newCopy();
         cThr = orig.cThr;
     }
@@ -98,4 +89,5 @@ namespace Victor { namespace Align2{
         return tmp;
     }
 
+
 }} // namespace
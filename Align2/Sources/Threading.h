@@ -74,6 +74,7 @@ namespace Victor { namespace Align2{
         // ATTRIBUTES:
 
         string seq1; ///< Target sequence.
+        vector<int> targetIndex; ///< Threading row of each target residue.
         ThreadingInput *thread; ///< Template threading input file.
         double cThr; ///< Coefficient for threading.
 
@@ -97,6 +97,25 @@ namespace Victor { namespace Align2{
 
 
     // HELPERS:
+    /**
+     * Residues that are not one of the 20 standard amino acids map to the 
+     * first row.
+     * @param seq
+     * @return 
+     */
+    vector<int>
+    ThreadingInput::getResidueIndices(const string &seq) {
+        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
+
+        vector<int> indices(seq.size(), 0);
+        for (unsigned int i = 0; i < seq.size(); i++)
+            for (int k = 0; k < 20; k++)
+                if (seq[i] == residue_indices[k]) {
+                    indices[i] = k;
+                    break;
+                }
+        return indices;
+    }
 
     template<class T> void
     ThreadingInput::pWriteDoubleVector(ostream &os, vector< vector<T> > data) {
@@ -79,6 +79,9 @@ namespace Victor { namespace Align2{
 
         // HELPERS:
 
+        /// Map every residue of seq to its row of the threading input.
+        static vector<int> getResidueIndices(const string &seq);
+
         /// Helper function used to write a vector<vector> construct.
         template<class T> static void pWriteDoubleVector(ostream &os,
                 vector< vector<T> > data);
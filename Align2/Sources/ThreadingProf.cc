@@ -39,6 +39,7 @@ namespace Victor { namespace Align2{
             ThreadingInput *thread, ProfInput *phd1, ProfInput *phd2, double cThr,
             double cPrf) : Structure(subStr), seq1(ad->getSequence(1)),
     thread(thread), phd1(phd1), phd2(phd2), cThr(cThr), cPrf(cPrf) {
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
     }
 
     ThreadingProf::ThreadingProf(const ThreadingProf &orig) : Structure(orig) {
@@ -77,18 +78,7 @@ namespace Victor { namespace Align2{
         // THREADING
         //
 
-        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
-
-        char aaTarget = seq1[i - 1];
-        int targetIndex = 0;
-
-        for (int k = 0; k <= 19; k++)
-            if (aaTarget == residue_indices[k]) {
-                targetIndex = k;
-                break;
-            }
-
-        double s1 = thread->score(targetIndex, (j - 1));
+        double s1 = thread->score(targetIndex[i - 1], (j - 1));
 
 
         //
@@ -106,7 +96,8 @@ namespace Victor { namespace Align2{
         char mixTarget = phd1->getProfMixSSBE(ssTarget, beTarget);
         char mixTemplate = phd2->getProfMixSSBE(ssTemplate, beTemplate);
 
-        double s2 = subStr->score[mixTarget][mixTemplate];
+        double s2 = subStr->getScore(EncodedSequence::encode(mixTarget),
+                EncodedSequence::encode(mixTemplate));
 
 
         return cThr * s1 + cPrf * s2;
@@ -122,6 +113,7 @@ namespace Victor { namespace Align2{
     ThreadingProf::copy(const ThreadingProf &orig) {
         Structure::copy(orig);
         seq1 = orig.seq1;
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
         thread = orig.thread->newCopy();
         phd1 = orig.phd1->newCopy();
         phd2 = orig.phd2->newCopy();
@@ -135,4 +127,5 @@ namespace Victor { namespace Align2{
         return tmp;
     }
 
+
 }} // namespace
@@ -76,6 +76,7 @@ namespace Victor { namespace Align2{
         // ATTRIBUTES:
 
         string seq1; ///< Target sequence.
+        vector<int> targetIndex; ///< Threading row of each target residue.
         ThreadingInput *thread; ///< Template threading input file.
         ProfInput *phd1; ///< Target PHD input file.
         ProfInput *phd2; ///< Template PHD input file.
@@ -49,6 +49,7 @@ namespace Victor { namespace Align2{
             double cSs2) : Structure(subStr), seq1(ad->getSequence(1)),
     sec1(ad->getSequence(3)), sec2(ad->getSequence(4)), thread(thread),
     psipred1(psipred1), psipred2(psipred2), cThr(cThr), cSs2(cSs2) {
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
     }
 
     ThreadingSs2::ThreadingSs2(const ThreadingSs2 &orig) : Structure(orig) {
@@ -83,42 +84,34 @@ namespace Victor { namespace Align2{
         // THREADING
         //
 
-        const string residue_indices = "ARNDCQEGHILKMFPSTWYV";
-
-        char aaTarget = seq1[i - 1];
-        int targetIndex = 0;
-
-        for (int k = 0; k <= 19; k++)
-            if (aaTarget == residue_indices[k]) {
-                targetIndex = k;
-                break;
-            }
-
-        double s1 = thread->score(targetIndex, (j - 1));
+        double s1 = thread->score(targetIndex[i - 1], (j - 1));
 
 
         //
         // SS2
         //
 
-        const string ss2_indices = "HEC";
+        const EncodedSequence::Residue ss2_indices[3] = {
+            EncodedSequence::encode('H'), EncodedSequence::encode('E'),
+            EncodedSequence::encode('C')
+        };
 
         // Target PSI-PRED
         double weigthH = psipred1->score((i - 1), 1);
         double weigthE = psipred1->score((i - 1), 2);
         double weigthC = psipred1->score((i - 1), 0);
-        int substiH = subStr->score[sec2[j - 1]][ss2_indices[0]];
-        int substiE = subStr->score[sec2[j - 1]][ss2_indices[1]];
-        int substiC = subStr->score[sec2[j - 1]][ss2_indices[2]];
+        int substiH = subStr->getScore(sec2[j - 1], ss2_indices[0]);
+        int substiE = subStr->getScore(sec2[j - 1], ss2_indices[1]);
+        int substiC = subStr->getScore(sec2[j - 1], ss2_indices[2]);
         double tmp1 = weigthH * substiH + weigthE * substiE + weigthC * substiC;
 
         // Template PSI-PRED
         weigthH = psipred2->score((j - 1), 1);
         weigthE = psipred2->score((j - 1), 2);
         weigthC = psipred2->score((j - 1), 0);
-        substiH = subStr->score[sec1[i - 1]][ss2_indices[0]];
-        substiE = subStr->score[sec1[i - 1]][ss2_indices[1]];
-        substiC = subStr->score[sec1[i - 1]][ss2_indices[2]];
+        substiH = subStr->getScore(sec1[i - 1], ss2_indices[0]);
+        substiE = subStr->getScore(sec1[i - 1], ss2_indices[1]);
+        substiC = subStr->getScore(sec1[i - 1], ss2_indices[2]);
         double tmp2 = weigthH * substiH + weigthE * substiE + weigthC * substiC;
 
         double s2 = (tmp1 + tmp2) / 2;
@@ -137,6 +130,7 @@ namespace Victor { namespace Align2{
     ThreadingSs2::copy(const ThreadingSs2 &orig) {
         Structure::copy(orig);
         seq1 = orig.seq1;
+        targetIndex = ThreadingInput::getResidueIndices(seq1);
         sec1 = orig.sec1;
         sec2 = orig.sec2;
         thread = orig.thread->newCopy();
@@ -152,4 +146,5 @@ namespace Victor { namespace Align2{
         return tmp;
     }
 
+
 }} // namespace
@@ -76,8 +76,9 @@ namespace Victor { namespace Align2{
         // ATTRIBUTES:
 
         string seq1; ///< Target sequence.
-        string sec1; ///< Target secondary structure.
-        string sec2; ///< Template secondary structure.
+        vector<int> targetIndex; ///< Threading row of each target residue.
+        EncodedSequence sec1; ///< Target secondary structure.
+        EncodedSequence sec2; ///< Template secondary structure.
         ThreadingInput *thread; ///< Template threading input file.
         Ss2Input *psipred1; ///< Target PSI-PRED input file.
         Ss2Input *psipred2; ///< Template PSI-PRED input file.
@@ -245,6 +245,8 @@ namespace Victor { namespace Align2{
         //TODO improve default assignment for unseen residues
         //define SA that will be used in case of gaps.
         //double previousSolvAcc = 0.5;
+        SolvExpos solv;
+        NeighborGrid reprGrid(*sp, 10.0, NeighborGrid::REPR_ATOMS);
 
         for (unsigned int k = 0; k < sp->sizeAmino(); k++) {
             // Helical/strand content
@@ -276,8 +278,8 @@ namespace Victor { namespace Align2{
 
             // Solvent accessibility
             try {
-                SolvExpos solv;
-                double solvAcc = solv.getSolvAccess(*sp, k, 0, sp->sizeAmino());
+                double solvAcc = solv.getSolvAccess(reprGrid, *sp, k, 0,
+                        sp->sizeAmino());
                 solvAccess.push_back(solvAcc);
                 //previousSolvAcc = solvAcc;
             } catch (const char* exc) {
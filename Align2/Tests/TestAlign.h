@@ -18,7 +18,12 @@
 #include <AlignmentBase.h>
 #include <Alignment.h>
 #include <NWAlign.h>
+#include <SWAlign.h>
 #include <Align.h>
+#include <ScoreTypePolicy.h>
+#include <AlignmentCollector.h>
+#include <FastaIndex.h>
+#include <sstream>
 using namespace std;
 using namespace Victor;
 using namespace Victor::Align2;
@@ -103,6 +108,12 @@ public:
                 &TestAlign::testAlign_B));
         suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test3 - setting penalty values.",
                 &TestAlign::testAlign_C));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test4 - integer score matrix.",
+                &TestAlign::testAlign_D));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test5 - top-K result collector.",
+                &TestAlign::testAlign_E));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test6 - indexed FASTA reader.",
+                &TestAlign::testAlign_F));
 
         return suiteOfTests;
     }
@@ -140,4 +151,119 @@ protected:
         CPPUNIT_ASSERT((testAlign->penaltyMul== 14 )&&(testAlign->penaltyAdd== 10 ));
     }
 
+    void testAlign_D() {
+        // BLOSUM62 and integer gap penalties: integer matrices match double
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        SequenceData data(2, "HEAGAWGHEE", "PAWHEAE", "seq1", "seq2");
+        AGPFunction gapFunction(12, 3);
+        ScoringS2S scoring(&sub, &data, 0, 1.00);
+
+        CPPUNIT_ASSERT(ScoreTypePolicy::select(sub, 1.00, 12, 3, 10, 7) ==
+                ScoreTypePolicy::INT16);
+        CPPUNIT_ASSERT(ScoreTypePolicy::select(sub, 0.80, 12, 3, 10, 7) ==
+                ScoreTypePolicy::FLOAT64);
+
+        NWAlign doubleAlign(&data, &gapFunction, &scoring);
+        NWAlignT<int> intAlign(&data, &gapFunction, &scoring);
+        NWAlignT<short> shortAlign(&data, &gapFunction, &scoring);
+        CPPUNIT_ASSERT(intAlign.getScore() == doubleAlign.getScore());
+        CPPUNIT_ASSERT(shortAlign.getScore() == doubleAlign.getScore());
+        CPPUNIT_ASSERT(intAlign.getMatch() == doubleAlign.getMatch());
+    }
+
+    void testAlign_E() {
+        // Keep the 2 best of 3 templates, round trip through the binary file
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        AGPFunction gapFunction(12, 3);
+        AlignmentCollector collector(2);
+        string templates[3] = {"PAWHEAE", "HEAGAWGHEE", "WWWW"};
+
+        for (unsigned int t = 0; t < 3; t++) {
+            SequenceData data(2, "HEAGAWGHEE", templates[t], "seq1", "seq2");
+            ScoringS2S scoring(&sub, &data, 0, 1.00);
+            NWAlign align(&data, &gapFunction, &scoring);
+            collector.add(0, t, align);
+        }
+
+        vector<AlignmentCollector::Record> best = collector.getTop(0);
+        CPPUNIT_ASSERT((collector.size() == 2) && (best.size() == 2));
+        CPPUNIT_ASSERT((best[0].target == 1) && (best[0].identity == 1.00));
+        CPPUNIT_ASSERT(AlignmentCollector::decodeOps(best[0].ops,
+                "HEAGAWGHEE", "HEAGAWGHEE")[1] == "HEAGAWGHEE");
+
+        stringstream file;
+        collector.write(file);
+        AlignmentCollector merged(1);
+        merged.read(file);
+        CPPUNIT_ASSERT((merged.size() == 1) && (merged.getTop(0)[0].score == best[0].score));
+        CPPUNIT_ASSERT(merged.getTop(0)[0].ops == best[0].ops);
+
+        // A local alignment is rebuilt from the record and the full sequences
+        SequenceData data(2, "HEAGAWGHEE", "PAWHEAE", "seq1", "seq2");
+        ScoringS2S scoring(&sub, &data, 0, 1.00);
+        SWAlign local(&data, &gapFunction, &scoring);
+        AlignmentCollector locals(1);
+        locals.add(0, 0, local);
+        stringstream localFile;
+        locals.write(localFile);
+        merged.clear();
+        merged.read(localFile);
+        AlignmentCollector::Record r = merged.getTop(0)[0];
+        CPPUNIT_ASSERT((r.queryStart > 0) || (r.targetStart > 0));
+        CPPUNIT_ASSERT(AlignmentCollector::decode(r, "HEAGAWGHEE", "PAWHEAE")
+                == local.getMatch());
+    }
+
+    /// Counts the residues of the records visited.
+
+    class ResidueCounter : public FastaIndex::RecordVisitor {
+    public:
+
+        ResidueCounter() : residues(0) {
+        }
+
+        virtual void visit(unsigned int id, const FastaIndex::Record &rec,
+                const FastaIndex::SequenceView &seq) {
+            residues += seq.size();
+        }
+
+        unsigned long residues;
+    };
+
+    void testAlign_F() {
+        // Compare the mapped records with a plain read of the file
+        string fileName = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/t0111.prof.fasta";
+        FastaIndex index(fileName);
+        ifstream in(fileName.c_str());
+        vector<string> names, seqs;
+        string line;
+        while (getline(in, line))
+            if ((line.size() > 0) && (line[0] == '>')) {
+                names.push_back(line.substr(1, line.find(' ') - 1));
+                seqs.push_back("");
+            } else
+                seqs.back() += line;
+
+        CPPUNIT_ASSERT((index.size() == seqs.size()) && (index.size() > 1));
+        unsigned long residues = 0;
+        for (unsigned int i = 0; i < index.size(); i++) {
+            CPPUNIT_ASSERT(index.getRecord(i).name == names[i]);
+            CPPUNIT_ASSERT(index.getSequence(i).toString() == seqs[i]);
+            residues += seqs[i].size();
+        }
+        CPPUNIT_ASSERT(index.getSequence(names[1]).substr(70, 5) == seqs[1].substr(70, 5));
+        CPPUNIT_ASSERT(index.find("missing") == index.size());
+
+        ResidueCounter counters[2];
+        vector<FastaIndex::RecordVisitor*> visitors;
+        visitors.push_back(&counters[0]);
+        visitors.push_back(&counters[1]);
+        index.forEachParallel(visitors, 2);
+        CPPUNIT_ASSERT(counters[0].residues + counters[1].residues == residues);
+    }
+
 };
@@ -0,0 +1,106 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ */
+#include <Protein.h>
+#include <PdbLoader.h>
+#include <MmcifLoader.h>
+#include <BinSaver.h>
+#include <IoTools.h>
+#include <GetArg.h>
+
+using namespace Victor;using namespace Victor::Biopool;
+
+void sShowHelp() {
+    cout << "Pdb 2 Bin $Revision: 1.0 $ -- converts a PDB or mmCIF file into\n"
+            << "the binary structure format read by BinLoader\n"
+            << " Options: \n"
+            << "\t-i <filename> \t Input PDB file (.cif or .cif.gz for mmCIF)\n"
+            << "\t-o <filename> \t Output file\n"
+            << "\t-c <id>       \t Chain identifier to read\n"
+            << "\t--all         \t All chains\n"
+            << "\t-m <number>   \t Model number to read (NMR only, default is first model)\n"
+            << "\t--float       \t Store coordinates in single precision\n"
+            << "\t-v            \t verbose output\n\n"
+            << "\tIf both -c and --all are missing, only the first chain is processed.\n\n";
+
+}
+
+int main(int argc, char* argv[]) {
+
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    }
+
+    string inputFile, outputFile, chainID;
+    unsigned int modelNum;
+    bool all;
+
+    getArg("i", inputFile, argc, argv, "!");
+    getArg("o", outputFile, argc, argv, "!");
+    getArg("c", chainID, argc, argv, "!");
+    getArg("m", modelNum, argc, argv, 999);
+    all = getArg("-all", argc, argv);
+
+    // Check input and output files
+    if ((inputFile == "!") || (outputFile == "!")) {
+        cout << "Missing input or output file specification. Aborting. (-h for help)" << endl;
+        return -1;
+    }
+    ifstream inFile(inputFile.c_str(), ios::binary);
+    if (!inFile)
+        ERROR("Input file not found.", exception);
+
+    // Check chain args
+    if ((chainID != "!") && all) {
+        ERROR("You can use --all or -c, not both", error);
+    }
+
+    // Load the protein object
+    Protein prot;
+    if ((inputFile.find(".cif") != string::npos)) {
+        MmcifLoader ml(inFile);
+        ml.setModel(modelNum);
+        if (!getArg("v", argc, argv))
+            ml.setNoVerbose();
+        if (chainID != "!")
+            ml.setChain(chainID);
+        else if (all)
+            ml.setAllChains();
+        prot.load(ml);
+    } else {
+        PdbLoader pl(inFile);
+        pl.setModel(modelNum);
+        if (!getArg("v", argc, argv))
+            pl.setNoVerbose();
+        if (chainID != "!") {
+            if (chainID.size() > 1)
+                ERROR("You can choose only 1 chain", error);
+            pl.setChain(chainID[0]);
+        } else if (all)
+            pl.setAllChains();
+        prot.load(pl);
+    }
+
+    ofstream fout(outputFile.c_str(), ios::binary);
+    if (!fout)
+        ERROR("Could not open file for writing.", exception);
+    BinSaver bs(fout, getArg("-float", argc, argv));
+    prot.save(bs);
+
+    return 0;
+}
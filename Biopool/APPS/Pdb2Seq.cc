@@ -17,6 +17,7 @@
  */
 #include <Protein.h>
 #include <PdbLoader.h>
+#include <PdbBatch.h>
 #include <SeqSaver.h>
 #include <IoTools.h>
 #include <GetArg.h>
@@ -28,6 +29,9 @@ void sShowHelp() {
             << "(torsion angles) protein structure backbone torsion angles\n"
             << " Options: \n"
             << "\t-i <filename> \t Input PDB file\n"
+            << "\t-I <filename> \t Input file list (one PDB file per line)\n"
+            << "\t-d <directory>\t Input directory (all *.pdb files)\n"
+            << "\t-j <number>   \t Threads for -I and -d (default one per CPU)\n"
             << "\t-o <filename> \t Output to file (default stdout)\n"
             << "\t-c <id>       \t Chain identifier to read\n"
             << "\t--all         \t All chains\n"
@@ -38,6 +42,57 @@ void sShowHelp() {
 
 }
 
+/**
+ *  Writes the sequence of the selected chains of each structure.
+ */
+class Pdb2SeqTask : public StructureTask {
+public:
+
+    Pdb2SeqTask(unsigned int _modelNum, const string& _chainID, bool _all,
+            bool _chi, bool _verbose) : modelNum(_modelNum), chainID(_chainID),
+    all(_all), chi(_chi), verbose(_verbose) {
+    }
+
+    virtual void configure(PdbLoader& pl) {
+        // Set PdbLoader variables
+        pl.setModel(modelNum);
+        pl.setNoHAtoms();
+        pl.setNoHetAtoms();
+        pl.setNoSecondary();
+        if (!verbose) {
+            pl.setNoVerbose();
+        }
+
+        // User selected chain
+        if (chainID != "!") {
+            pl.setChain(chainID[0]);
+        }// All chains
+        else if (all) {
+            pl.setAllChains();
+        }// First chain
+        else {
+            vector<char> allCh = pl.getAllChains();
+            if (allCh.size() > 0)
+                pl.setChain(allCh[0]);
+        }
+    }
+
+    virtual void process(const string& fileName, Protein& prot, ostream& os) {
+        for (unsigned int i = 0; i < prot.sizeProtein(); i++) {
+            // Write the sequence
+            SeqSaver ss(os);
+            if (!chi)
+                ss.setWriteChi(false);
+            prot.getSpacer(i)->save(ss);
+        }
+    }
+
+private:
+    unsigned int modelNum;
+    string chainID;
+    bool all, chi, verbose;
+};
+
 int main(int argc, char* argv[]) {
 
     if (getArg("h", argc, argv)) {
@@ -45,11 +100,14 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    string inputFile, outputFile, chainID;
-    unsigned int modelNum;
+    string inputFile, inputList, inputDir, outputFile, chainID;
+    unsigned int modelNum, threads;
     bool chi, all;
 
     getArg("i", inputFile, argc, argv, "!");
+    getArg("I", inputList, argc, argv, "!");
+    getArg("d", inputDir, argc, argv, "!");
+    getArg("j", threads, argc, argv, 0);
     getArg("o", outputFile, argc, argv, "!");
     getArg("c", chainID, argc, argv, "!");
     getArg("m", modelNum, argc, argv, 999);
@@ -57,47 +115,19 @@ int main(int argc, char* argv[]) {
     chi = getArg("-chi", argc, argv);
 
     // Check input file
-    if (inputFile == "!") {
+    if ((inputFile == "!") && (inputList == "!") && (inputDir == "!")) {
         cout << "Missing input file specification. Aborting. (-h for help)" << endl;
         return -1;
     }
-    ifstream inFile(inputFile.c_str());
-    if (!inFile)
-        ERROR("Input file not found.", exception);
-
-
-    PdbLoader pl(inFile);
-
-    // Set PdbLoader variables
-    pl.setModel(modelNum);
-    pl.setNoHAtoms();
-    pl.setNoHetAtoms();
-    pl.setNoSecondary();
-    if (!getArg("v", argc, argv)) {
-        pl.setNoVerbose();
-    }
-
 
     // Check chain args
     if ((chainID != "!") && all) {
         ERROR("You can use --all or -c, not both", error);
     }
-    // User selected chain
-    if (chainID != "!") {
-        if (chainID.size() > 1)
-            ERROR("You can choose only 1 chain", error);
-        pl.setChain(chainID[0]);
-    }// All chains
-    else if (all) {
-        pl.setAllChains();
-    }// First chain
-    else {
-        pl.setChain(pl.getAllChains()[0]);
-    }
+    if ((chainID != "!") && (chainID.size() > 1))
+        ERROR("You can choose only 1 chain", error);
 
-    // Load the protein object
-    Protein prot;
-    prot.load(pl);
+    Pdb2SeqTask task(modelNum, chainID, all, chi, getArg("v", argc, argv));
 
     // Open the proper output stream (file or stdout)
     std::ostream* os = &cout;
@@ -112,17 +142,36 @@ int main(int argc, char* argv[]) {
     }
 
 
-    Spacer* sp;
-    for (unsigned int i = 0; i < prot.sizeProtein(); i++) {
+    // Many files: parse and convert them in parallel, output in list order
+    if ((inputList != "!") || (inputDir != "!")) {
+        vector<string> files;
+        if (inputList != "!") {
+            ifstream listFile(inputList.c_str());
+            if (!listFile)
+                ERROR("Input file list not found.", exception);
+            files = BatchRunner::readList(listFile);
+        } else
+            files = BatchRunner::readDirectory(inputDir, ".pdb");
+
+        PdbBatch batch(task, threads);
+        batch.run(files, *os);
+        for (unsigned int i = 0; i < batch.getFailed().size(); i++)
+            cerr << "Warning: could not convert " << batch.getFailed()[i] << "\n";
+        return 0;
+    }
+
+    ifstream inFile(inputFile.c_str());
+    if (!inFile)
+        ERROR("Input file not found.", exception);
+
+    PdbLoader pl(inFile);
+    task.configure(pl);
 
-        sp = prot.getSpacer(i);
+    // Load the protein object
+    Protein prot;
+    prot.load(pl);
 
-        // Write the sequence
-        SeqSaver ss(*os);
-        if (!chi)
-            ss.setWriteChi(false);
-        sp->save(ss);
-    }
+    task.process(inputFile, prot, *os);
 
     return 0;
 }
@@ -18,7 +18,7 @@
 #include <string>
 #include <GetArg.h>
 #include <PdbLoader.h>
-#include <PdbSaver.h>
+#include <FastPdbSaver.h>
 #include <vector3.h>
 #include <matrix3.h>
 #include <IntCoordConverter.h>
@@ -190,8 +190,9 @@ int main(int nArgs, char* argv[]) {
     ofstream outFile(outputFile.c_str());
     if (!outFile)
         ERROR("File not found.", exception);
-    PdbSaver ps(outFile);
+    FastPdbSaver ps(outFile);
 
     sp.save(ps);
+    ps.flushOutput();
     outFile.close();
 }
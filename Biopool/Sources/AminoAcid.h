@@ -158,6 +158,9 @@ namespace Victor { namespace Biopool {
         SideChain sideChain;
         // vector atoms (inherited from Group) contains the backbone
         IntCoordConverter icc;  
+
+        friend class SpacerSnapshot;
+        friend class IntCoordConverter;
     };
 
     // ---------------------------------------------------------------------------
@@ -20,6 +20,7 @@
 #include <IntCoordConverter.h>
 #include <IoTools.h>
 #include <vector>
+#include <pthread.h>
 
 
 
@@ -29,6 +30,9 @@ using namespace Victor::Biopool;
 double BOND_LENGTH_H_TO_ALL = 1.00;
 map<AminoAcidCode, vector<vector<string> > > AminoAcidHydrogen::paramH;
 
+static pthread_mutex_t sParamMutex = PTHREAD_MUTEX_INITIALIZER;
+static bool sDefaultLoaded = false;
+
 /**
  *    Load a file "AminoAcidHydrogenData.txt", containing angles and reference atoms to build hydrogens. 
  *@param   string inputFile name
@@ -42,6 +46,7 @@ AminoAcidHydrogen::loadParam(string inputFile) {
 
     input.clear(); // reset file to previous content 
     input.seekg(0, ios::beg);
+    paramH.clear(); // replace parameters loaded before
 
     string tok = "";
     vector<string> tokens; // One parsed line splitted by white spaces
@@ -86,6 +91,24 @@ AminoAcidHydrogen::loadParam(string inputFile) {
 
 }
 
+/**
+ *    Loads $VICTOR_ROOT/data/AminoAcidHydrogenData.txt the first time it is
+ *    called, later calls (from any thread) do nothing.
+ *@return  void
+ */
+void
+AminoAcidHydrogen::loadDefaultParam() {
+    pthread_mutex_lock(&sParamMutex);
+    if (!sDefaultLoaded) {
+        const char* root = getenv("VICTOR_ROOT");
+        if (root == NULL)
+            ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+        loadParam(string(root) + "data/AminoAcidHydrogenData.txt");
+        sDefaultLoaded = true;
+    }
+    pthread_mutex_unlock(&sParamMutex);
+}
+
 /**
  *    Add Hydrogen to an AminoAcid
  *@param   One AminoAcid pointer
@@ -108,7 +131,10 @@ AminoAcidHydrogen::setHydrogen(AminoAcid* aa, bool verbose) {
 
     }
 
-    vector<vector<string > > paramList = paramH[aaCode];
+    // read only, setHydrogen() runs concurrently on different chains
+    static const vector<vector<string > > noParam;
+    map<AminoAcidCode, vector<vector<string> > >::const_iterator it = paramH.find(aaCode);
+    const vector<vector<string > >& paramList = (it != paramH.end()) ? it->second : noParam;
     vector<string> args;
 
 
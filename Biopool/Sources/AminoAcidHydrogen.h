@@ -36,6 +36,7 @@ namespace Victor { namespace Biopool {
     public:
 
         static void loadParam(string inputFile);
+        static void loadDefaultParam(); // once per process
         static void setHydrogen(AminoAcid* aa, bool verbose);
 
     private:
@@ -20,6 +20,7 @@
 #include <matrix3.h>
 #include <math.h>
 #include <IoTools.h>
+#include <vector>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -142,6 +143,10 @@ Atom::copy(const Atom& orig) {
 /**
  *   Synchronize coords with structure
  *
+ * The chain of modified atoms leading to this one (following the first 
+ * in-bond) is collected first and then updated from its start, so a 
+ * change near the beginning of a long chain costs a single sweep over the
+ * changed atoms instead of a recursion as deep as the chain.
  */
 
 void
@@ -150,26 +155,17 @@ Atom::sync()
     if (inSync())
         return;
 
-    vgMatrix3<double> tmpMatrix(1);
-    vgVector3<double> supTrans(0, 0, 0);
-
-    if (isNotFirstAtomInStructure())
-        getInBond(0).sync();
-    else
-        if (hasSuperior()) { // use superior's trans & rot
-        supTrans = getSuperior().getTrans();
-        rot = getSuperior().getRot() * rot;
-        const_cast<Group&> (getSuperior()).setRot(tmpMatrix);
+    vector<Atom*> pending;
+    Atom* curr = this;
+    pending.push_back(curr);
+    while (curr->isNotFirstAtomInStructure() 
+            && !curr->getInBond(0).inSync()) {
+        curr = &(curr->getInBond(0));
+        pending.push_back(curr);
     }
 
-    trans = rot * trans;
-    coords = trans + supTrans; // set the relative position
-
-    if (isNotFirstAtomInStructure())
-        coords += getInBond(0).getCoords(); // make absolute position
-
-    propagateRotation();
-    modified = false;
+    for (unsigned int i = pending.size(); i > 0; i--)
+        pending[i - 1]->updateCoords();
 }
 
 
@@ -183,9 +179,19 @@ Atom::setModified() {
         return;
     modified = true;
 
-    for (unsigned int i = 0; i < sizeOutBonds(); i++)
-        getOutBond(i).setModified();
-
+    vector<Atom*> pending;
+    pending.push_back(this);
+    while (!pending.empty()) {
+        Atom* curr = pending.back();
+        pending.pop_back();
+        for (unsigned int i = 0; i < curr->sizeOutBonds(); i++) {
+            Atom& next = curr->getOutBond(i);
+            if (!next.modified) {
+                next.modified = true;
+                pending.push_back(&next);
+            }
+        }
+    }
 }
 
 /**
@@ -212,6 +218,32 @@ Atom&
 
 // HELPERS:
 
+/**
+ *   Recomputes coords from trans and rot. The atom's first in-bond (if any)
+ * has to be in sync already.
+ */
+void
+Atom::updateCoords() {
+    vgMatrix3<double> tmpMatrix(1);
+    vgVector3<double> supTrans(0, 0, 0);
+    bool notFirst = isNotFirstAtomInStructure();
+
+    if (!notFirst && hasSuperior()) { // use superior's trans & rot
+        supTrans = getSuperior().getTrans();
+        rot = getSuperior().getRot() * rot;
+        const_cast<Group&> (getSuperior()).setRot(tmpMatrix);
+    }
+
+    trans = rot * trans;
+    coords = trans + supTrans; // set the relative position
+
+    if (notFirst)
+        coords += getInBond(0).coords; // make absolute position
+
+    propagateRotation();
+    modified = false;
+}
+
 /**
  *   Propagate the "rot" matrix to all the outbonds. 
  * The "rot" of this atom is multiplied with the "rot" of the out atom.
@@ -228,27 +260,35 @@ Atom::propagateRotation() {
         return;
 
     for (unsigned int i = 0; i < sizeOutBonds(); i++)
-        if (!hasSuperior() ||
-                (!((getSuperior().getType() == "PRO") && (getCode() == CD)
-                && (getOutBond(i).getCode() == N))
-                && !((getSuperior().getType() == "PHE") && (getCode() == CE2)
-                && (getOutBond(i).getCode() == CZ))
-                && !((getSuperior().getType() == "TYR") && (getCode() == CE2)
-                && (getOutBond(i).getCode() == CZ))
-                && !((getSuperior().getType() == "TRP") && (getCode() == NE1)
-                && (getOutBond(i).getCode() == CE2))
-                && !((getSuperior().getType() == "TRP") && (getCode() == CZ3)
-                && (getOutBond(i).getCode() == CH2))
-                && !((getSuperior().getType() == "HIS" && (getCode() == CE1)
-                && (getOutBond(i).getCode() == NE2)))
-                )
-                ) {
+        if (!hasSuperior() || !isRingClosure(type, getOutBond(i).type))
             getOutBond(i).addRot(rot);
-        }
    
     rot = tmpMatrix;
 }
 
+/**
+ *   Check if the bond from -> to closes one of the rings of PRO, PHE, TYR, 
+ * TRP or HIS. None of these atom pairs is bonded in any other residue, 
+ * so the atom codes are enough and no residue name has to be compared.
+ */
+bool
+Atom::isRingClosure(AtomCode from, AtomCode to) {
+    switch (from) {
+        case CD: // PRO
+            return (to == N);
+        case CE2: // PHE, TYR
+            return (to == CZ);
+        case NE1: // TRP
+            return (to == CE2);
+        case CZ3: // TRP
+            return (to == CH2);
+        case CE1: // HIS
+            return (to == NE2);
+        default:
+            return false;
+    }
+}
+
 /**
  *   Check if an atom is the first atom in the structure. Meaning that it does not have any in bond.
  *
@@ -257,11 +297,9 @@ Atom::propagateRotation() {
  *  which would crash the program
  */
 
-inline bool
+bool
 Atom::isNotFirstAtomInStructure() {
-    if (sizeInBonds() && !((getSuperior().getType() == "PRO")
-            && (getCode() == N) && (getInBond(0).getCode() == CD)))
-        
+    if (sizeInBonds() && !((type == N) && (getInBond(0).type == CD)))
         return true;
     else
         return false;
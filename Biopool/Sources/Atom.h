@@ -109,6 +109,8 @@ namespace Victor { namespace Biopool {
         // HELPERS: 
         bool isNotFirstAtomInStructure();
         void propagateRotation(); // pass on rotation matrix to following atoms
+        void updateCoords(); // apply trans & rot, parent assumed in sync
+        static bool isRingClosure(AtomCode from, AtomCode to);
 
 
         // ATTRIBUTES:
@@ -121,6 +123,9 @@ namespace Victor { namespace Biopool {
         vgVector3<double> trans; // relative translation
         vgMatrix3<double> rot; // relative rotation
         bool modified; // --""--  modified?  
+
+        friend class SpacerSnapshot;
+        friend class IntCoordConverter;
     };
 
 
@@ -0,0 +1,87 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _BIN_FORMAT_H_
+#define _BIN_FORMAT_H_
+
+// Includes:
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /*
+     *   On-disk layout of the binary structure format written by BinSaver
+     *   and read by BinLoader.
+     *
+     *   A file is a BinHeader followed by one BinChain per chain. The
+     *   sections of each chain are its residues (amino acids first, then
+     *   ligands), their atoms (backbone, then side chain), the coordinates
+     *   (three floats or doubles per atom) and the Spacer type. Offsets are
+     *   in bytes from the start of the file and sections start on 8 byte
+     *   boundaries, so a mapped file is read in place. Numbers are stored
+     *   in the byte order of the machine that wrote the file.
+     */
+
+    const unsigned int BIN_MAGIC = 0x4e494256; // "VBIN" in little-endian order
+    const unsigned int BIN_VERSION = 1;
+
+    const unsigned int BIN_CONNECTED = 1; // chain flag: residues were bonded
+
+    const unsigned char BIN_AMINO_ACID = 0; // residue kinds
+    const unsigned char BIN_LIGAND = 1;
+
+    struct BinHeader {
+        unsigned int magic;
+        unsigned int version;
+        unsigned int chains; // number of BinChain entries
+        unsigned int coordSize; // 4 (float) or 8 (double)
+    };
+
+    struct BinChain {
+        char name[8]; // chain ID, zero padded
+        unsigned int residues; // amino acids and ligands
+        unsigned int aminoAcids;
+        unsigned int atoms;
+        unsigned int flags;
+        unsigned int residueOffset; // BinResidue[residues]
+        unsigned int atomOffset; // BinAtom[atoms]
+        unsigned int coordOffset; // coordSize[3 * atoms]
+        unsigned int typeOffset; // char[typeLength]
+        unsigned int typeLength;
+        unsigned int reserved;
+    };
+
+    struct BinResidue {
+        char name[4]; // three letter code, zero padded
+        int number; // PDB number of amino acids
+        unsigned int firstAtom;
+        unsigned short atoms;
+        unsigned char state; // StateCode
+        unsigned char kind;
+    };
+
+    struct BinAtom {
+        char type[4]; // PDB atom name, zero padded
+        unsigned int number;
+        float bfac;
+        unsigned char sideChain; // 1 if in the side chain
+        unsigned char reserved[3];
+    };
+
+}} //namespace
+#endif //_BIN_FORMAT_H_
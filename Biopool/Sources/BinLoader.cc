@@ -0,0 +1,336 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <BinLoader.h>
+#include <PdbLoader.h>
+#include <AtomCode.h>
+#include <string.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+/// Name stored in the zero padded field s of n characters.
+static string sName(const char* s, unsigned int n) {
+    unsigned int len = 0;
+    while ((len < n) && (s[len] != '\0'))
+        len++;
+    return string(s, len);
+}
+
+/// True if count elements of elemSize bytes at offset lie within size bytes.
+/// Written without sums, which could wrap on corrupt offsets.
+static bool sFits(unsigned long size, unsigned long offset,
+        unsigned long count, unsigned long elemSize) {
+    return (offset <= size) && (count <= (size - offset) / elemSize);
+}
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *   Maps the file and checks its header and chain directory.
+ */
+BinLoader::BinLoader(const string& _fileName, bool _noHAtoms, bool _noHetAtoms,
+        bool _noConnection, bool _verb) : fileName(_fileName), data(NULL), size(0),
+mapped(false), valid(true), noHAtoms(_noHAtoms), noHetAtoms(_noHetAtoms),
+noConnection(_noConnection), verbose(_verb), allChains(false), chain(""),
+first(0), count(static_cast<unsigned int> (-1)) {
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        ERROR("BinLoader: cannot open " + fileName, exception);
+    struct stat st;
+    if (fstat(fd, &st) == 0)
+        size = st.st_size;
+    if (size > 0) {
+        void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            data = static_cast<const char*> (p);
+            mapped = true;
+        }
+    }
+    close(fd);
+
+    if (!mapped) { // not mappable: read a copy
+        ifstream in(fileName.c_str(), ios::binary);
+        string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size = contents.size();
+        char* copy = new char[size + 1];
+        memcpy(copy, contents.data(), size);
+        data = copy;
+    }
+
+    if (size < sizeof (BinHeader))
+        ERROR("BinLoader: " + fileName + " is not a binary structure file.", exception);
+    const BinHeader& header = *reinterpret_cast<const BinHeader*> (data);
+    if (header.magic != BIN_MAGIC)
+        ERROR("BinLoader: " + fileName + " is not a binary structure file.", exception);
+    if (header.version != BIN_VERSION)
+        ERROR("BinLoader: unsupported format version in " + fileName, exception);
+    if ((header.coordSize != sizeof (float)) && (header.coordSize != sizeof (double)))
+        ERROR("BinLoader: invalid coordinate size in " + fileName, exception);
+    if (!sFits(size, sizeof (BinHeader), header.chains, sizeof (BinChain)))
+        ERROR("BinLoader: truncated file " + fileName, exception);
+
+    for (unsigned int c = 0; c < header.chains; c++) {
+        const BinChain& e = getChain(c);
+        if (!sFits(size, e.residueOffset, e.residues, sizeof (BinResidue))
+                || !sFits(size, e.atomOffset, e.atoms, sizeof (BinAtom))
+                || !sFits(size, e.coordOffset, e.atoms, 3 * header.coordSize)
+                || !sFits(size, e.typeOffset, e.typeLength, 1)
+                || (e.aminoAcids > e.residues))
+            ERROR("BinLoader: truncated file " + fileName, exception);
+        const BinResidue* res = reinterpret_cast<const BinResidue*> (data + e.residueOffset);
+        for (unsigned int i = 0; i < e.residues; i++)
+            if (!sFits(e.atoms, res[i].firstAtom, res[i].atoms, 1))
+                ERROR("BinLoader: corrupt residue in " + fileName, exception);
+    }
+}
+
+BinLoader::~BinLoader() {
+    PRINT_NAME;
+    if (mapped)
+        munmap(const_cast<char*> (data), size);
+    else
+        delete[] data;
+}
+
+// PREDICATES:
+
+/**
+ *   Returns the number of chains in the file.
+ *@return unsigned int
+ */
+unsigned int
+BinLoader::sizeChains() const {
+    return reinterpret_cast<const BinHeader*> (data)->chains;
+}
+
+/**
+ *   Returns the ID of chain c.
+ *@param c (unsigned int) chain index
+ *@return string
+ */
+string
+BinLoader::getChainName(unsigned int c) const {
+    return sName(getChain(c).name, sizeof (getChain(c).name));
+}
+
+/**
+ *   Returns the number of amino acids of chain c.
+ *@param c (unsigned int) chain index
+ *@return unsigned int
+ */
+unsigned int
+BinLoader::sizeAmino(unsigned int c) const {
+    return getChain(c).aminoAcids;
+}
+
+// MODIFIERS:
+
+/**
+ *   Loads the selected chain (the first one if none is selected).
+ *@param sp (Spacer&)
+ */
+void
+BinLoader::loadSpacer(Spacer& sp) {
+    PRINT_NAME;
+    loadChain(selectedChain(), sp);
+}
+
+/**
+ *   Loads the ligands of the selected chain.
+ *@param ls (LigandSet&)
+ */
+void
+BinLoader::loadLigandSet(LigandSet& ls) {
+    PRINT_NAME;
+    loadLigands(selectedChain(), ls);
+}
+
+/**
+ *   Loads the selected chain, or all of them, with their ligands.
+ *@param prot (Protein&)
+ */
+void
+BinLoader::loadProtein(Protein& prot) {
+    PRINT_NAME;
+    unsigned int c = allChains ? 0 : selectedChain();
+    unsigned int end = allChains ? sizeChains() : c + 1;
+    for (; c < end; c++) {
+        if (verbose)
+            cout << "\nLoading chain: ->" << getChainName(c) << "<-\n";
+        Spacer* sp = new Spacer();
+        loadChain(c, *sp);
+
+        Polymer* pol = new Polymer();
+        pol->insertComponent(sp);
+        if (verbose)
+            cout << "Loaded AminoAcids: " << sp->size() << "\n";
+        if (!noHetAtoms) {
+            LigandSet* ls = new LigandSet();
+            loadLigands(c, *ls);
+            if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
+                pol->insertComponent(ls);
+                if (verbose)
+                    cout << "Loaded Ligands: " << ls->size() << "\n";
+            } else
+                delete ls;
+        }
+        prot.addChain(getChainName(c));
+        prot.insertComponent(pol);
+    }
+}
+
+// HELPERS:
+
+/**
+ *   Returns the directory entry of chain c.
+ *@param c (unsigned int) chain index
+ *@return const BinChain&
+ */
+const BinChain&
+BinLoader::getChain(unsigned int c) const {
+    if (c >= sizeChains())
+        ERROR("BinLoader: chain index out of range.", exception);
+    return reinterpret_cast<const BinChain*> (data + sizeof (BinHeader))[c];
+}
+
+/**
+ *   Returns the index of the selected chain.
+ *@return unsigned int
+ */
+unsigned int
+BinLoader::selectedChain() const {
+    if (sizeChains() == 0)
+        ERROR("BinLoader: no chains in " + fileName, exception);
+    if (chain == "")
+        return 0;
+    for (unsigned int c = 0; c < sizeChains(); c++)
+        if (getChainName(c) == chain)
+            return c;
+    ERROR("BinLoader: chain " + chain + " not found in " + fileName, exception);
+    return 0;
+}
+
+/**
+ *   Loads the amino acids of chain c in the selected range, restoring
+ *   chain breaks, secondary structure and bonds as PdbLoader left them.
+ *@param c (unsigned int) chain index
+ *@param sp (Spacer&)
+ */
+void
+BinLoader::loadChain(unsigned int c, Spacer& sp) {
+    const BinChain& e = getChain(c);
+    const BinResidue* res = reinterpret_cast<const BinResidue*> (data + e.residueOffset);
+    sp.setType(string(data + e.typeOffset, e.typeLength));
+
+    unsigned int last = e.aminoAcids;
+    if (first >= last)
+        return;
+    if (count < last - first)
+        last = first + count;
+
+    for (unsigned int i = first; i < last; i++) {
+        string name = sName(res[i].name, sizeof (res[i].name));
+        AminoAcid* aa = new AminoAcid();
+        aa->setType(name);
+        aa->getSideChain().setType(name);
+        aa->setState(static_cast<StateCode> (res[i].state));
+        loadAtoms(c, res[i], *aa, &aa->getSideChain());
+
+        if (sp.sizeAmino() == 0)
+            sp.setStartOffset(res[i].number - 1);
+        else // Add gaps
+            for (int k = sp.maxPdbNumber() + 1; k < res[i].number; k++)
+                sp.addGap(k);
+        sp.insertComponent(aa);
+    }
+
+    if (sp.sizeAmino() > 0) {
+
+        // connect aminoacids
+        if ((e.flags & BIN_CONNECTED) && !noConnection && !PdbLoader::setBonds(sp)) {
+            valid = false;
+            if (verbose)
+                cout << "Warning: Fail to connect residues in chain: " << getChainName(c) << ".\n";
+        }
+
+        // correct position of leading N atom
+        sp.setTrans(sp.getAmino(0)[N].getTrans());
+        vgVector3<double> tmp(0.0, 0.0, 0.0);
+        sp.getAmino(0)[N].setTrans(tmp);
+        sp.getAmino(0).adjustLeadingN();
+    }
+}
+
+/**
+ *   Loads the ligands of chain c.
+ *@param c (unsigned int) chain index
+ *@param ls (LigandSet&)
+ */
+void
+BinLoader::loadLigands(unsigned int c, LigandSet& ls) {
+    const BinChain& e = getChain(c);
+    const BinResidue* res = reinterpret_cast<const BinResidue*> (data + e.residueOffset);
+    for (unsigned int i = e.aminoAcids; i < e.residues; i++) {
+        Ligand* lig = new Ligand();
+        lig->setType(sName(res[i].name, sizeof (res[i].name)));
+        loadAtoms(c, res[i], *lig, NULL);
+        ls.insertComponent(lig);
+    }
+}
+
+/**
+ *   Adds the atoms of a residue to gr, or to sideChain if they belong to it.
+ *@param c (unsigned int) chain index
+ *@param res (const BinResidue&)
+ *@param gr (Group&)
+ *@param sideChain (Group*) may be NULL
+ */
+void
+BinLoader::loadAtoms(unsigned int c, const BinResidue& res, Group& gr, Group* sideChain) {
+    const BinChain& e = getChain(c); // residue atom ranges checked on opening
+    const BinAtom* atoms = reinterpret_cast<const BinAtom*> (data + e.atomOffset) + res.firstAtom;
+    bool single = (reinterpret_cast<const BinHeader*> (data)->coordSize == sizeof (float));
+    const float* fc = reinterpret_cast<const float*> (data + e.coordOffset) + 3 * res.firstAtom;
+    const double* dc = reinterpret_cast<const double*> (data + e.coordOffset) + 3 * res.firstAtom;
+
+    for (unsigned int j = 0; j < res.atoms; j++) {
+        Atom at;
+        at.setNumber(atoms[j].number);
+        at.setType(sName(atoms[j].type, sizeof (atoms[j].type)));
+        if (noHAtoms && !isHeavyAtom(at.getCode()))
+            continue;
+        if (single)
+            at.setCoords(fc[3 * j], fc[3 * j + 1], fc[3 * j + 2]);
+        else
+            at.setCoords(dc[3 * j], dc[3 * j + 1], dc[3 * j + 2]);
+        at.setBFac(atoms[j].bfac);
+
+        if ((sideChain != NULL) && atoms[j].sideChain)
+            sideChain->addAtom(at);
+        else
+            gr.addAtom(at);
+    }
+}
@@ -0,0 +1,134 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _BIN_LOADER_H_
+#define _BIN_LOADER_H_
+
+// Includes:
+#include <Loader.h>
+#include <BinFormat.h>
+#include <AminoAcid.h>
+#include <Spacer.h>
+#include <LigandSet.h>
+#include <Protein.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Loads Spacers and Proteins saved by BinSaver.
+     *
+     *   The file is memory mapped: only the sections of the selected
+     *   chains and residue range are read, and nothing is parsed.
+     * */
+    class BinLoader : public Loader {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        /**
+         *   Constructor.
+         * @param _fileName = the file written by BinSaver
+         * @param _noHAtoms = if true, doesn't load Hydrogens
+         * @param _noHetAtoms = if true, doesn't load ligands
+         * @param _noConnection = if true, doesn't connect residues
+         * @param _verb = if true, verbose mode
+         */
+        BinLoader(const string& _fileName, bool _noHAtoms = false,
+                bool _noHetAtoms = false, bool _noConnection = false, bool _verb = true);
+
+        virtual ~BinLoader();
+
+        // PREDICATES:
+
+        bool isValid() {
+            return valid;
+        }
+        unsigned int sizeChains() const;
+        string getChainName(unsigned int c) const;
+        unsigned int sizeAmino(unsigned int c) const;
+
+        // MODIFIERS:
+
+        void setVerbose() {
+            verbose = true;
+        }
+
+        void setNoVerbose() {
+            verbose = false;
+        }
+
+        void setChain(const string& _ch) {
+            chain = _ch;
+            allChains = false;
+        }
+
+        void setAllChains() {
+            allChains = true;
+        }
+
+        /// Loads only the amino acids first .. first + count - 1 of each chain.
+        void setRange(unsigned int _first, unsigned int _count) {
+            first = _first;
+            count = _count;
+        }
+
+        void setNoHAtoms() {
+            noHAtoms = true;
+        }
+
+        void setNoHetAtoms() {
+            noHetAtoms = true;
+        }
+
+        void setNoConnection() {
+            noConnection = true;
+        }
+
+        virtual void loadSpacer(Spacer& sp);
+        virtual void loadLigandSet(LigandSet& ls);
+        virtual void loadProtein(Protein& prot);
+
+    protected:
+        // HELPERS:
+        const BinChain& getChain(unsigned int c) const;
+        unsigned int selectedChain() const;
+        void loadChain(unsigned int c, Spacer& sp);
+        void loadLigands(unsigned int c, LigandSet& ls);
+        void loadAtoms(unsigned int c, const BinResidue& res, Group& gr, Group* sideChain);
+
+        // ATTRIBUTES 
+    private:
+        BinLoader(const BinLoader&); // the mapping is not shared
+        BinLoader& operator=(const BinLoader&);
+
+        string fileName;
+        const char* data; // file contents
+        unsigned long size;
+        bool mapped; // data is a mapping, not a copy
+        bool valid;
+        bool noHAtoms;
+        bool noHetAtoms;
+        bool noConnection;
+        bool verbose;
+        bool allChains;
+        string chain; // chain ID to be loaded, empty for the first one
+        unsigned int first; // range of amino acids to be loaded
+        unsigned int count;
+    };
+
+}} //namespace
+#endif //_BIN_LOADER_H_
@@ -0,0 +1,236 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <BinSaver.h>
+#include <string.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+/**
+ *   The sections of one chain, collected before writing.
+ */
+struct BinSaver::ChainSections {
+    BinChain entry;
+    vector<BinResidue> residues;
+    vector<BinAtom> atoms;
+    vector<double> coords;
+    string type;
+};
+
+/// Copies s into the zero padded field dest of n characters.
+static void sCopyName(char* dest, const string& s, unsigned int n, const char* what) {
+    if (s.size() > n)
+        ERROR("BinSaver: " + string(what) + " too long: " + s, exception);
+    memset(dest, 0, n);
+    memcpy(dest, s.data(), s.size());
+}
+
+/// Bytes up to the next 8 byte boundary.
+static unsigned int sAlign(unsigned int pos) {
+    return (pos + 7) & ~7u;
+}
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+// MODIFIERS:
+
+/**
+ *  Saves a spacer as a file with a single unnamed chain.
+ *@param Spacer reference
+ *@return void
+ */
+void
+BinSaver::saveSpacer(Spacer& sp) {
+    PRINT_NAME;
+    vector<ChainSections> chains(1);
+    addChain(chains[0], "", sp, NULL);
+    write(chains);
+}
+
+/**
+ *  Saves all chains of a protein, with their ligands.
+ *@param Protein reference
+ *@return void
+ */
+void
+BinSaver::saveProtein(Protein& prot) {
+    PRINT_NAME;
+    vector<ChainSections> chains(prot.sizeProtein());
+    for (unsigned int i = 0; i < prot.sizeProtein(); i++)
+        addChain(chains[i], prot.getChainName(i), *prot.getSpacer(i), prot.getLigandSet(i));
+    write(chains);
+}
+
+// HELPERS:
+
+/**
+ *  Collects the residues and atoms of a chain.
+ *@param cs (ChainSections&) the chain
+ *@param name (const string&) chain ID
+ *@param sp (Spacer&)
+ *@param ls (LigandSet*) ligands, may be NULL
+ *@return void
+ */
+void
+BinSaver::addChain(ChainSections& cs, const string& name, Spacer& sp, LigandSet* ls) {
+    memset(&cs.entry, 0, sizeof (cs.entry));
+    sCopyName(cs.entry.name, name, sizeof (cs.entry.name) - 1, "chain ID");
+    cs.type = sp.getType();
+
+    int number = sp.getStartOffset();
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        aa.sync();
+
+        BinResidue res;
+        sCopyName(res.name, aa.getType(), sizeof (res.name), "residue name");
+        // PDB number, skipping chain breaks as PdbSaver does
+        number++;
+        while ((sp.isGap(number)) && (number < sp.maxPdbNumber()))
+            number++;
+        res.number = number;
+        res.firstAtom = cs.atoms.size();
+        res.state = aa.getState();
+        res.kind = BIN_AMINO_ACID;
+
+        for (unsigned int j = 0; j < aa.sizeBackbone(); j++)
+            addAtom(cs, aa[j], false);
+        for (unsigned int j = 0; j < aa.getSideChain().size(); j++)
+            addAtom(cs, aa.getSideChain()[j], true);
+        res.atoms = cs.atoms.size() - res.firstAtom;
+        cs.residues.push_back(res);
+
+        // bonds are rebuilt from the atom names when loading
+        for (unsigned int j = 0; (j < aa.sizeBackbone()) && (i == 0); j++)
+            if (aa[j].sizeInBonds() + aa[j].sizeOutBonds() > 0)
+                cs.entry.flags |= BIN_CONNECTED;
+    }
+    cs.entry.aminoAcids = cs.residues.size();
+
+    for (unsigned int i = 0; (ls != NULL) && (i < ls->sizeLigand()); i++) {
+        Ligand& lig = ls->getLigand(i);
+        lig.sync();
+
+        BinResidue res;
+        sCopyName(res.name, lig.getType(), sizeof (res.name), "ligand name");
+        res.number = 0;
+        res.firstAtom = cs.atoms.size();
+        res.state = 0;
+        res.kind = BIN_LIGAND;
+        for (unsigned int j = 0; j < lig.size(); j++)
+            addAtom(cs, lig[j], false);
+        res.atoms = cs.atoms.size() - res.firstAtom;
+        cs.residues.push_back(res);
+    }
+
+    cs.entry.residues = cs.residues.size();
+    cs.entry.atoms = cs.atoms.size();
+}
+
+/**
+ *  Appends an atom and its coordinates.
+ *@param cs (ChainSections&) the chain
+ *@param at (Atom&)
+ *@param sideChain (bool)
+ *@return void
+ */
+void
+BinSaver::addAtom(ChainSections& cs, Atom& at, bool sideChain) {
+    BinAtom rec;
+    memset(&rec, 0, sizeof (rec));
+    sCopyName(rec.type, at.getType(), sizeof (rec.type), "atom name");
+    rec.number = at.getNumber();
+    rec.bfac = at.getBFac();
+    rec.sideChain = sideChain;
+    cs.atoms.push_back(rec);
+
+    vgVector3<double> c = at.getCoords();
+    cs.coords.push_back(c.x);
+    cs.coords.push_back(c.y);
+    cs.coords.push_back(c.z);
+}
+
+/**
+ *  Lays out the sections of all chains and writes the file.
+ *@param chains (vector<ChainSections>&)
+ *@return void
+ */
+void
+BinSaver::write(vector<ChainSections>& chains) {
+    BinHeader header;
+    header.magic = BIN_MAGIC;
+    header.version = BIN_VERSION;
+    header.chains = chains.size();
+    header.coordSize = singlePrecision ? sizeof (float) : sizeof (double);
+
+    unsigned int pos = sAlign(sizeof (header) + chains.size() * sizeof (BinChain));
+    for (unsigned int i = 0; i < chains.size(); i++) {
+        BinChain& e = chains[i].entry;
+        e.residueOffset = pos;
+        pos = sAlign(pos + e.residues * sizeof (BinResidue));
+        e.atomOffset = pos;
+        pos = sAlign(pos + e.atoms * sizeof (BinAtom));
+        e.coordOffset = pos;
+        pos = sAlign(pos + 3 * e.atoms * header.coordSize);
+        e.typeOffset = pos;
+        e.typeLength = chains[i].type.size();
+        pos = sAlign(pos + e.typeLength);
+    }
+
+    static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned int written = 0;
+    output.write(reinterpret_cast<const char*> (&header), sizeof (header));
+    written += sizeof (header);
+    for (unsigned int i = 0; i < chains.size(); i++)
+        output.write(reinterpret_cast<const char*> (&chains[i].entry), sizeof (BinChain));
+    written += chains.size() * sizeof (BinChain);
+
+    for (unsigned int i = 0; i < chains.size(); i++) {
+        ChainSections& cs = chains[i];
+        vector<float> single;
+        if (singlePrecision)
+            single.assign(cs.coords.begin(), cs.coords.end());
+
+        const char* data[4] = {
+            cs.residues.empty() ? NULL : reinterpret_cast<const char*> (&cs.residues[0]),
+            cs.atoms.empty() ? NULL : reinterpret_cast<const char*> (&cs.atoms[0]),
+            cs.coords.empty() ? NULL : (singlePrecision
+            ? reinterpret_cast<const char*> (&single[0])
+            : reinterpret_cast<const char*> (&cs.coords[0])),
+            cs.type.data()
+        };
+        unsigned int offset[4] = {cs.entry.residueOffset, cs.entry.atomOffset,
+            cs.entry.coordOffset, cs.entry.typeOffset};
+        unsigned int size[4] = {cs.residues.size() * sizeof (BinResidue),
+            cs.atoms.size() * sizeof (BinAtom), 3 * cs.entry.atoms * header.coordSize,
+            cs.entry.typeLength};
+
+        for (unsigned int k = 0; k < 4; k++) {
+            output.write(padding, offset[k] - written);
+            if (size[k] > 0)
+                output.write(data[k], size[k]);
+            written = offset[k] + size[k];
+        }
+    }
+    output.write(padding, sAlign(written) - written);
+
+    if (!output)
+        ERROR("BinSaver: error writing the output.", exception);
+}
@@ -0,0 +1,83 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _BIN_SAVER_H_
+#define _BIN_SAVER_H_
+
+// Includes:
+#include <Saver.h>
+#include <BinFormat.h>
+#include <Spacer.h>
+#include <LigandSet.h>
+#include <Protein.h>
+#include <iostream>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Saves Spacers and Proteins in the binary structure format.
+     *
+     *   The format (see BinFormat.h) keeps residue and atom names,
+     *   secondary structure, chain breaks and coordinates, so a
+     *   structure parsed once with PdbLoader can be reloaded with
+     *   BinLoader without parsing text again.
+     * */
+    class BinSaver : public Saver {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        /**
+         *   Constructor.
+         * @param _output = the output stream, opened in binary mode
+         * @param _singlePrecision = if true, coordinates are stored as floats
+         */
+        BinSaver(ostream& _output = cout, bool _singlePrecision = false)
+        : output(_output), singlePrecision(_singlePrecision) {
+        }
+
+        // this class uses the implicit copy operator.
+
+        virtual ~BinSaver() {
+            PRINT_NAME;
+        }
+
+        // MODIFIERS:
+
+        void setSinglePrecision(bool _s) {
+            singlePrecision = _s;
+        }
+
+        virtual void saveSpacer(Spacer& sp); // a file with one chain
+        virtual void saveProtein(Protein& prot);
+
+    protected:
+        struct ChainSections;
+
+        // HELPERS:
+        void addChain(ChainSections& cs, const string& name, Spacer& sp, LigandSet* ls);
+        void addAtom(ChainSections& cs, Atom& at, bool sideChain);
+        void write(vector<ChainSections>& chains);
+
+        // ATTRIBUTES 
+    private:
+        ostream& output; // output stream
+        bool singlePrecision; // store coordinates as floats
+    };
+
+}} //namespace
+#endif //_BIN_SAVER_H_
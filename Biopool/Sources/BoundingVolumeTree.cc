@@ -0,0 +1,459 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//Includes:
+#include <BoundingVolumeTree.h>
+#include <algorithm>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// bounds of empty nodes, far enough to fail every distance test
+static const double EMPTY_BOUND = 1.0e30;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+BoundingVolumeTree::BoundingVolumeTree(NeighborGrid::AtomFilter filter,
+        unsigned int minSeparation) : filter(filter),
+minSeparation(minSeparation) {
+    pClear();
+    pBuild();
+}
+
+BoundingVolumeTree::~BoundingVolumeTree() {
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the lower corner of the box of residue r. Residues without 
+ *  selected atoms have a lower bound above the upper one.
+ *@param r residue index
+ *@return lower bound
+ */
+vgVector3<double>
+BoundingVolumeTree::getLowerBound(unsigned int r) const {
+    PRECOND(r < sizeResidues(), exception);
+    const unsigned int k = 3 * (leaves + r);
+    return vgVector3<double>(lower[k], lower[k + 1], lower[k + 2]);
+}
+
+/**
+ *  Returns the upper corner of the box of residue r.
+ *@param r residue index
+ *@return upper bound
+ */
+vgVector3<double>
+BoundingVolumeTree::getUpperBound(unsigned int r) const {
+    PRECOND(r < sizeResidues(), exception);
+    const unsigned int k = 3 * (leaves + r);
+    return vgVector3<double>(upper[k], upper[k + 1], upper[k + 2]);
+}
+
+/**
+ *  Checks if any two atoms of the tree clash, stopping at the first one.
+ *@param d clash distance
+ *@return bool
+ */
+bool
+BoundingVolumeTree::anyClash(double d) const {
+    Query q = {this, d * d, false, 0, 0, NULL};
+    return pSelf(1, q);
+}
+
+/**
+ *  Checks if any atom of residues first to last (included) clashes with 
+ *  another atom of the tree, e.g. after a loop has been moved and refitted
+ *  with update(first, last).
+ *@param first index of the first residue
+ *@param last index of the last residue
+ *@param d clash distance
+ *@return bool
+ */
+bool
+BoundingVolumeTree::anyClash(unsigned int first, unsigned int last,
+        double d) const {
+    PRECOND((first <= last) && (last < sizeResidues()), exception);
+    Query q = {this, d * d, true, first, last, NULL};
+    return pSegment(q);
+}
+
+/**
+ *  Checks if any atom of the tree clashes with an atom of another tree,
+ *  e.g. a loop against the protein it is modelled in. No residue pair is
+ *  excluded.
+ *@param other tree
+ *@param d clash distance
+ *@return bool
+ */
+bool
+BoundingVolumeTree::anyClash(const BoundingVolumeTree& other, double d) const {
+    Query q = {&other, d * d, false, 0, 0, NULL};
+    return pNodes(1, 1, q);
+}
+
+/**
+ *  Finds all clashing atom pairs of the tree, each once with atom1 in the
+ *  lower residue.
+ *@param d clash distance
+ *@param result clashes found
+ *@return void
+ */
+void
+BoundingVolumeTree::findClashes(double d, vector<Clash>& result) const {
+    result.clear();
+    Query q = {this, d * d, false, 0, 0, &result};
+    pSelf(1, q);
+}
+
+/**
+ *  Finds all atoms clashing with an atom of residues first to last 
+ *  (included). atom1 belongs to the segment; pairs inside the segment are
+ *  reported once.
+ *@param first index of the first residue
+ *@param last index of the last residue
+ *@param d clash distance
+ *@param result clashes found
+ *@return void
+ */
+void
+BoundingVolumeTree::findClashes(unsigned int first, unsigned int last,
+        double d, vector<Clash>& result) const {
+    PRECOND((first <= last) && (last < sizeResidues()), exception);
+    result.clear();
+    Query q = {this, d * d, true, first, last, &result};
+    pSegment(q);
+}
+
+/**
+ *  Finds all pairs of clashing atoms between this tree (atom1) and 
+ *  another one (atom2).
+ *@param other tree
+ *@param d clash distance
+ *@param result clashes found
+ *@return void
+ */
+void
+BoundingVolumeTree::findClashes(const BoundingVolumeTree& other, double d,
+        vector<Clash>& result) const {
+    result.clear();
+    Query q = {&other, d * d, false, 0, 0, &result};
+    pNodes(1, 1, q);
+}
+
+/**
+ *  Collects the indices of all atoms at most r from pos.
+ *@param pos position
+ *@param r radius
+ *@param result indices of the atoms found
+ *@return void
+ */
+void
+BoundingVolumeTree::neighborsOf(const vgVector3<double>& pos, double r,
+        vector<unsigned int>& result) const {
+    result.clear();
+    const double r2 = r * r;
+    vector<unsigned int> stack(1, 1);
+    while (!stack.empty()) {
+        unsigned int k = stack.back();
+        stack.pop_back();
+        if (pPointDistance2(k, pos) > r2)
+            continue;
+        if (k < leaves) {
+            stack.push_back(2 * k);
+            stack.push_back(2 * k + 1);
+            continue;
+        }
+        for (unsigned int i = residueStart[k - leaves];
+                i < residueStart[k - leaves + 1]; i++)
+            if ((pos - coords[i]).square() <= r2)
+                result.push_back(i);
+    }
+}
+
+// MODIFIERS:
+
+/**
+ *  (Re)builds the tree from the atoms of a spacer.
+ *@param sp spacer
+ *@return void
+ */
+void
+BoundingVolumeTree::build(Spacer& sp) {
+    pClear();
+    pAddChain(sp);
+    pBuild();
+}
+
+/**
+ *  (Re)builds the tree from all chains of a protein. Residues are 
+ *  numbered chain after chain.
+ *@param prot protein
+ *@return void
+ */
+void
+BoundingVolumeTree::build(Protein& prot) {
+    pClear();
+    for (unsigned int c = 0; c < prot.sizeProtein(); c++)
+        pAddChain(*prot.getSpacer(c));
+    pBuild();
+}
+
+/**
+ *  Reads the coordinates of all atoms again and refits the whole tree.
+ *@return void
+ */
+void
+BoundingVolumeTree::update() {
+    for (unsigned int r = 0; r < sizeResidues(); r++)
+        pRefitLeaf(r);
+    for (unsigned int k = leaves - 1; k > 0; k--)
+        pRefitNode(k);
+}
+
+/**
+ *  Refits the tree after residues first to last (included) have moved. 
+ *  Only the nodes above them are recomputed.
+ *@param first index of the first residue moved
+ *@param last index of the last residue moved
+ *@return void
+ */
+void
+BoundingVolumeTree::update(unsigned int first, unsigned int last) {
+    PRECOND((first <= last) && (last < sizeResidues()), exception);
+    for (unsigned int r = first; r <= last; r++)
+        pRefitLeaf(r);
+    for (unsigned int lo = (leaves + first) / 2, hi = (leaves + last) / 2;
+            lo > 0; lo /= 2, hi /= 2)
+        for (unsigned int k = lo; k <= hi; k++)
+            pRefitNode(k);
+}
+
+/**
+ *  Refits the tree after the given residues have moved.
+ *@param residues indices of the residues moved
+ *@return void
+ */
+void
+BoundingVolumeTree::update(const vector<unsigned int>& residues) {
+    vector<unsigned int> nodes;
+    for (unsigned int i = 0; i < residues.size(); i++) {
+        PRECOND(residues[i] < sizeResidues(), exception);
+        pRefitLeaf(residues[i]);
+        nodes.push_back(leaves + residues[i]);
+    }
+    sort(nodes.begin(), nodes.end());
+
+    // one level at a time, so that each node is refitted once
+    while (!nodes.empty() && (nodes[0] > 1)) {
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            nodes[i] /= 2;
+        nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            pRefitNode(nodes[i]);
+    }
+}
+
+// HELPERS:
+
+void
+BoundingVolumeTree::pClear() {
+    atoms.clear();
+    coords.clear();
+    atomResidue.clear();
+    residueStart.clear();
+    residueChain.clear();
+    chainStart.assign(1, 0);
+}
+
+void
+BoundingVolumeTree::pAddChain(Spacer& sp) {
+    const unsigned int c = sizeChains();
+    vector<Atom*> selected;
+    for (unsigned int r = 0; r < sp.sizeAmino(); r++) {
+        residueStart.push_back(atoms.size());
+        residueChain.push_back(c);
+        selected.clear();
+        NeighborGrid::selectAtoms(sp.getAmino(r), filter, selected);
+        for (unsigned int k = 0; k < selected.size(); k++) {
+            atoms.push_back(selected[k]);
+            atomResidue.push_back(residueChain.size() - 1);
+        }
+    }
+    chainStart.push_back(residueChain.size());
+}
+
+void
+BoundingVolumeTree::pBuild() {
+    residueStart.push_back(atoms.size());
+    coords.resize(atoms.size());
+
+    leaves = 1;
+    while (leaves < sizeResidues())
+        leaves *= 2;
+    lower.assign(3 * 2 * leaves, EMPTY_BOUND);
+    upper.assign(3 * 2 * leaves, -EMPTY_BOUND);
+    update();
+}
+
+void
+BoundingVolumeTree::pRefitLeaf(unsigned int r) {
+    double* lo = &lower[3 * (leaves + r)];
+    double* hi = &upper[3 * (leaves + r)];
+    for (unsigned int j = 0; j < 3; j++) {
+        lo[j] = EMPTY_BOUND;
+        hi[j] = -EMPTY_BOUND;
+    }
+    for (unsigned int i = residueStart[r]; i < residueStart[r + 1]; i++) {
+        coords[i] = atoms[i]->getCoords();
+        for (unsigned int j = 0; j < 3; j++) {
+            lo[j] = min(lo[j], coords[i][j]);
+            hi[j] = max(hi[j], coords[i][j]);
+        }
+    }
+}
+
+void
+BoundingVolumeTree::pRefitNode(unsigned int k) {
+    for (unsigned int j = 0; j < 3; j++) {
+        lower[3 * k + j] = min(lower[6 * k + j], lower[6 * k + 3 + j]);
+        upper[3 * k + j] = max(upper[6 * k + j], upper[6 * k + 3 + j]);
+    }
+}
+
+/**
+ *  Returns the squared distance between the box of node k and the box of
+ *  node l of other, 0 if they overlap.
+ */
+double
+BoundingVolumeTree::pBoxDistance2(unsigned int k,
+        const BoundingVolumeTree& other, unsigned int l) const {
+    double d2 = 0.0;
+    for (unsigned int j = 0; j < 3; j++) {
+        double gap = max(lower[3 * k + j] - other.upper[3 * l + j],
+                other.lower[3 * l + j] - upper[3 * k + j]);
+        if (gap > 0.0)
+            d2 += gap * gap;
+    }
+    return d2;
+}
+
+double
+BoundingVolumeTree::pPointDistance2(unsigned int k,
+        const vgVector3<double>& pos) const {
+    double d2 = 0.0;
+    for (unsigned int j = 0; j < 3; j++) {
+        double gap = max(lower[3 * k + j] - pos[j], pos[j] - upper[3 * k + j]);
+        if (gap > 0.0)
+            d2 += gap * gap;
+    }
+    return d2;
+}
+
+/**
+ *  Checks if residue r1 of this tree and r2 of q.other must not be tested.
+ */
+bool
+BoundingVolumeTree::pSkip(unsigned int r1, unsigned int r2,
+        const Query& q) const {
+    if (q.other != this)
+        return false;
+    if (r1 == r2)
+        return true;
+    if ((residueChain[r1] == residueChain[r2])
+            && (max(r1, r2) - min(r1, r2) < minSeparation))
+        return true;
+    // pairs inside the segment are visited from both sides
+    return q.segment && (r2 < r1) && (r2 >= q.first) && (r2 <= q.last);
+}
+
+/**
+ *  Tests the atoms of residue r1 against those of residue r2 of q.other.
+ *  Returns true to stop the query.
+ */
+bool
+BoundingVolumeTree::pLeaves(unsigned int r1, unsigned int r2, Query& q) const {
+    if (pSkip(r1, r2, q))
+        return false;
+    const BoundingVolumeTree& other = *q.other;
+    for (unsigned int i = residueStart[r1]; i < residueStart[r1 + 1]; i++)
+        for (unsigned int j = other.residueStart[r2];
+                j < other.residueStart[r2 + 1]; j++) {
+            double d2 = (coords[i] - other.coords[j]).square();
+            if (d2 > q.d2)
+                continue;
+            if (q.result == NULL)
+                return true;
+            Clash clash = {i, j, sqrt(d2)};
+            q.result->push_back(clash);
+        }
+    return false;
+}
+
+/**
+ *  Descends node k of this tree and node l of q.other, pruning the pairs
+ *  of boxes further apart than the clash distance. Returns true to stop 
+ *  the query.
+ */
+bool
+BoundingVolumeTree::pNodes(unsigned int k, unsigned int l, Query& q) const {
+    const BoundingVolumeTree& other = *q.other;
+    if (pBoxDistance2(k, other, l) > q.d2)
+        return false;
+
+    const bool leafK = (k >= leaves);
+    const bool leafL = (l >= other.leaves);
+    if (leafK && leafL)
+        return pLeaves(k - leaves, l - other.leaves, q);
+
+    // split the larger box
+    bool splitK = !leafK;
+    if (!leafK && !leafL) {
+        double sizeK = 0.0, sizeL = 0.0;
+        for (unsigned int j = 0; j < 3; j++) {
+            sizeK += upper[3 * k + j] - lower[3 * k + j];
+            sizeL += other.upper[3 * l + j] - other.lower[3 * l + j];
+        }
+        splitK = (sizeK >= sizeL);
+    }
+    if (splitK)
+        return pNodes(2 * k, l, q) || pNodes(2 * k + 1, l, q);
+    return pNodes(k, 2 * l, q) || pNodes(k, 2 * l + 1, q);
+}
+
+/**
+ *  Visits all pairs of residues below node k once.
+ */
+bool
+BoundingVolumeTree::pSelf(unsigned int k, Query& q) const {
+    if (k >= leaves)
+        return false;
+    return pSelf(2 * k, q) || pSelf(2 * k + 1, q) || pNodes(2 * k, 2 * k + 1, q);
+}
+
+/**
+ *  Visits all pairs of a residue of the segment with any other residue.
+ */
+bool
+BoundingVolumeTree::pSegment(Query& q) const {
+    for (unsigned int r = q.first; r <= q.last; r++)
+        if (pNodes(leaves + r, 1, q))
+            return true;
+    return false;
+}
@@ -0,0 +1,231 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _BOUNDINGVOLUMETREE_H_
+#define _BOUNDINGVOLUMETREE_H_
+
+// Includes:
+#include <NeighborGrid.h>
+#include <Protein.h>
+#include <Spacer.h>
+#include <Debug.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Bounding volume hierarchy over the residues of a Spacer or of 
+     *    all chains of a Protein, for clash detection.
+     * 
+     *  Each leaf is the axis aligned box of the atoms of one residue 
+     *  selected by the filter (see NeighborGrid::AtomFilter). Inner nodes 
+     *  bound contiguous segments of residues, i.e. sub-spacers, since the 
+     *  tree is built along the sequence: residues of all chains are 
+     *  numbered consecutively (see getChainStart()) and node k has 
+     *  children 2k and 2k + 1, the root being node 1.
+     *  When only a segment moves update(first, last) refits its leaves and 
+     *  the nodes above them, in O(k + log n) for k residues.
+     * 
+     *  Two atoms clash when they are at most d apart. Within the tree, 
+     *  atoms of the same residue and of residues of the same chain closer 
+     *  than minSeparation in sequence never clash.
+     * */
+    class BoundingVolumeTree {
+    public:
+
+        /** Two clashing atoms, as indices in the tree(s) queried. */
+        struct Clash {
+            unsigned int atom1;
+            unsigned int atom2;
+            double distance;
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        BoundingVolumeTree(
+                NeighborGrid::AtomFilter filter = NeighborGrid::HEAVY_ATOMS,
+                unsigned int minSeparation = 2);
+        virtual ~BoundingVolumeTree();
+
+        // PREDICATES:
+        unsigned int size() const; // number of atoms
+        unsigned int sizeResidues() const;
+        unsigned int sizeChains() const;
+        NeighborGrid::AtomFilter getFilter() const;
+        unsigned int getMinSeparation() const;
+
+        Atom& getAtom(unsigned int i) const;
+        unsigned int getResidue(unsigned int i) const; // residue of atom i
+        const vgVector3<double>& getCoords(unsigned int i) const;
+        unsigned int getResidueStart(unsigned int r) const; // first atom of r
+        unsigned int getResidueEnd(unsigned int r) const; // past last atom of r
+        unsigned int getChain(unsigned int r) const;
+        unsigned int getChainStart(unsigned int c) const;
+        vgVector3<double> getLowerBound(unsigned int r) const;
+        vgVector3<double> getUpperBound(unsigned int r) const;
+
+        bool anyClash(double d) const;
+        bool anyClash(unsigned int first, unsigned int last, double d) const;
+        bool anyClash(const BoundingVolumeTree& other, double d) const;
+        void findClashes(double d, vector<Clash>& result) const;
+        void findClashes(unsigned int first, unsigned int last, double d,
+                vector<Clash>& result) const;
+        void findClashes(const BoundingVolumeTree& other, double d,
+                vector<Clash>& result) const;
+
+        void neighborsOf(const vgVector3<double>& pos, double r,
+                vector<unsigned int>& result) const;
+        void neighborsOf(Atom& at, double r, vector<unsigned int>& result) const;
+
+        // MODIFIERS:
+        void build(Spacer& sp);
+        void build(Protein& prot);
+        void update();
+        void update(unsigned int first, unsigned int last);
+        void update(const vector<unsigned int>& residues);
+
+    protected:
+
+    private:
+
+        /** State of a clash query, see pNodes(). */
+        struct Query {
+            const BoundingVolumeTree* other; // == this for self queries
+            double d2;
+            bool segment; // only clashes of residues first to last
+            unsigned int first;
+            unsigned int last;
+            vector<Clash>* result; // NULL stops at the first clash
+        };
+
+        // HELPERS:
+        void pClear();
+        void pAddChain(Spacer& sp);
+        void pBuild();
+        void pRefitLeaf(unsigned int r);
+        void pRefitNode(unsigned int k);
+        double pBoxDistance2(unsigned int k, const BoundingVolumeTree& other,
+                unsigned int l) const;
+        double pPointDistance2(unsigned int k,
+                const vgVector3<double>& pos) const;
+        bool pSkip(unsigned int r1, unsigned int r2, const Query& q) const;
+        bool pLeaves(unsigned int r1, unsigned int r2, Query& q) const;
+        bool pNodes(unsigned int k, unsigned int l, Query& q) const;
+        bool pSelf(unsigned int k, Query& q) const;
+        bool pSegment(Query& q) const;
+
+        BoundingVolumeTree(const BoundingVolumeTree& orig);
+        BoundingVolumeTree& operator=(const BoundingVolumeTree& orig);
+
+        // ATTRIBUTES:
+        NeighborGrid::AtomFilter filter;
+        unsigned int minSeparation;
+
+        vector<Atom*> atoms;
+        vector<vgVector3<double> > coords; // cached, refreshed by update()
+        vector<unsigned int> atomResidue; // residue of each atom
+        vector<unsigned int> residueStart; // first atom of each residue, +1 sentinel
+        vector<unsigned int> residueChain; // chain of each residue
+        vector<unsigned int> chainStart; // first residue of each chain, +1 sentinel
+
+        unsigned int leaves; // power of two >= sizeResidues(), leaf r is node leaves + r
+        vector<double> lower; // 3 per node, empty nodes have lower > upper
+        vector<double> upper;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                            BoundingVolumeTree
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    BoundingVolumeTree::size() const {
+        return atoms.size();
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::sizeResidues() const {
+        return residueChain.size();
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::sizeChains() const {
+        return chainStart.size() - 1;
+    }
+
+    inline NeighborGrid::AtomFilter
+    BoundingVolumeTree::getFilter() const {
+        return filter;
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getMinSeparation() const {
+        return minSeparation;
+    }
+
+    inline Atom&
+    BoundingVolumeTree::getAtom(unsigned int i) const {
+        PRECOND(i < atoms.size(), exception);
+        return *atoms[i];
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getResidue(unsigned int i) const {
+        PRECOND(i < atoms.size(), exception);
+        return atomResidue[i];
+    }
+
+    inline const vgVector3<double>&
+    BoundingVolumeTree::getCoords(unsigned int i) const {
+        PRECOND(i < coords.size(), exception);
+        return coords[i];
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getResidueStart(unsigned int r) const {
+        PRECOND(r < sizeResidues(), exception);
+        return residueStart[r];
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getResidueEnd(unsigned int r) const {
+        PRECOND(r < sizeResidues(), exception);
+        return residueStart[r + 1];
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getChain(unsigned int r) const {
+        PRECOND(r < sizeResidues(), exception);
+        return residueChain[r];
+    }
+
+    inline unsigned int
+    BoundingVolumeTree::getChainStart(unsigned int c) const {
+        PRECOND(c < chainStart.size(), exception);
+        return chainStart[c];
+    }
+
+    inline void
+    BoundingVolumeTree::neighborsOf(Atom& at, double r,
+            vector<unsigned int>& result) const {
+        neighborsOf(at.getCoords(), r, result);
+    }
+
+}} //namespace
+
+#endif
@@ -0,0 +1,162 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <CompactStructure.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+CompactStructure::CompactStructure() {
+}
+
+CompactStructure::CompactStructure(const CompactStructure& orig) {
+    this->copy(orig);
+}
+
+CompactStructure::~CompactStructure() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Memory used by the arrays, without the unused capacity.
+ *@return bytes
+ */
+unsigned long
+CompactStructure::getMemoryUsage() const {
+    return chainId.size() * (sizeof (char) + sizeof (unsigned int))
+            + residueNumber.size() * (sizeof (int) + sizeof (unsigned char)
+            + 2 * sizeof (unsigned int))
+            + atomCode.size() * (4 * sizeof (float) + sizeof (unsigned char)
+            + sizeof (unsigned int));
+}
+
+/**
+ *  Returns the index of the atom of residue r with the given code.
+ *@param r residue index
+ *@param code atom code
+ *@return atom index, -1 if r has no such atom
+ */
+int
+CompactStructure::findAtom(unsigned int r, AtomCode code) const {
+    for (unsigned int a = getResidueStart(r); a < getResidueEnd(r); a++)
+        if (atomCode[a] == code)
+            return a;
+    return -1;
+}
+
+// MODIFIERS:
+
+void
+CompactStructure::copy(const CompactStructure& orig) {
+    chainId = orig.chainId;
+    chainStart = orig.chainStart;
+    residueNumber = orig.residueNumber;
+    residueCode = orig.residueCode;
+    residueChain = orig.residueChain;
+    residueStart = orig.residueStart;
+    coords = orig.coords;
+    atomCode = orig.atomCode;
+    atomResidue = orig.atomResidue;
+    bfac = orig.bfac;
+}
+
+void
+CompactStructure::clear() {
+    chainId.clear();
+    chainStart.clear();
+    residueNumber.clear();
+    residueCode.clear();
+    residueChain.clear();
+    residueStart.clear();
+    coords.clear();
+    atomCode.clear();
+    atomResidue.clear();
+    bfac.clear();
+}
+
+/**
+ *  Reserves space to avoid reallocations while the structure grows.
+ *@param atoms expected number of atoms
+ *@param residues expected number of residues
+ */
+void
+CompactStructure::reserve(unsigned int atoms, unsigned int residues) {
+    residueNumber.reserve(residues);
+    residueCode.reserve(residues);
+    residueChain.reserve(residues);
+    residueStart.reserve(residues);
+    coords.reserve(3 * atoms);
+    atomCode.reserve(atoms);
+    atomResidue.reserve(atoms);
+    bfac.reserve(atoms);
+}
+
+/**
+ *  Appends a chain. A chain interrupted by other chains is added again.
+ *@param id chain identifier
+ *@return chain index
+ */
+unsigned int
+CompactStructure::addChain(char id) {
+    chainId.push_back(id);
+    chainStart.push_back(residueNumber.size());
+    return chainId.size() - 1;
+}
+
+/**
+ *  Appends a residue to the last chain.
+ *@param number PDB residue number
+ *@param code residue type
+ *@return residue index
+ */
+unsigned int
+CompactStructure::addResidue(int number, AminoAcidCode code) {
+    if (chainId.size() == 0)
+        ERROR("CompactStructure::addResidue(): no chain to add the residue to.", exception);
+    residueNumber.push_back(number);
+    residueCode.push_back(static_cast<unsigned char> (code));
+    residueChain.push_back(chainId.size() - 1);
+    residueStart.push_back(atomCode.size());
+    return residueNumber.size() - 1;
+}
+
+/**
+ *  Appends an atom to the last residue.
+ *@param code atom type
+ *@param c coordinates
+ *@param bfac b-factor
+ *@return atom index
+ */
+unsigned int
+CompactStructure::addAtom(AtomCode code, const vgVector3<double>& c, double bfac) {
+    if (residueNumber.size() == 0)
+        ERROR("CompactStructure::addAtom(): no residue to add the atom to.", exception);
+    coords.push_back(c.x);
+    coords.push_back(c.y);
+    coords.push_back(c.z);
+    atomCode.push_back(static_cast<unsigned char> (code));
+    atomResidue.push_back(residueNumber.size() - 1);
+    this->bfac.push_back(bfac);
+    return atomCode.size() - 1;
+}
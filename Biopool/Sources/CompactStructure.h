@@ -0,0 +1,218 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _CompactStructure_H_
+#define _CompactStructure_H_
+
+
+// Includes:
+#include <AtomCode.h>
+#include <AminoAcidCode.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Read-only structure with a small memory footprint.
+     * 
+     *  Atoms are kept in contiguous arrays: packed float coordinates, one 
+     *  byte atom codes, residue indices and b-factors, 21 bytes per atom
+     *  (12 + 1 + 4 + 4) plus 13 per residue, instead of the several
+     *  hundred of an Atom with its bonds. 
+     *  There are no bonds, relative transformations or torsion angles, so
+     *  the structure cannot be modified; it is meant for large assemblies
+     *  that are only analysed (contacts, scoring, surfaces, ...). 
+     *  Atoms of a residue and residues of a chain are stored next to each 
+     *  other. Loaded in a single pass by PdbLoader::loadCompact().
+     * */
+
+    class CompactStructure {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        CompactStructure();
+        CompactStructure(const CompactStructure& orig);
+        virtual ~CompactStructure();
+
+        // PREDICATES:
+        unsigned int sizeChains() const;
+        unsigned int sizeResidues() const;
+        unsigned int sizeAtoms() const;
+        unsigned long getMemoryUsage() const; // bytes used by the arrays
+
+        char getChainId(unsigned int c) const;
+        unsigned int getChainStart(unsigned int c) const; // first residue of c
+        unsigned int getChainEnd(unsigned int c) const; // past last residue of c
+
+        int getResidueNumber(unsigned int r) const;
+        AminoAcidCode getResidueCode(unsigned int r) const;
+        unsigned int getResidueChain(unsigned int r) const;
+        unsigned int getResidueStart(unsigned int r) const; // first atom of r
+        unsigned int getResidueEnd(unsigned int r) const; // past last atom of r
+
+        AtomCode getAtomCode(unsigned int a) const;
+        unsigned int getAtomResidue(unsigned int a) const;
+        double getBFac(unsigned int a) const;
+        vgVector3<double> getCoords(unsigned int a) const;
+        const float* getCoords() const; // x, y, z per atom
+        int findAtom(unsigned int r, AtomCode code) const; // -1 if missing
+
+        // MODIFIERS:
+        void copy(const CompactStructure& orig);
+        void clear();
+        void reserve(unsigned int atoms, unsigned int residues);
+
+        // Structures are built in order: chain, its residues, their atoms.
+        unsigned int addChain(char id);
+        unsigned int addResidue(int number, AminoAcidCode code);
+        unsigned int addAtom(AtomCode code, const vgVector3<double>& c, double bfac = 0.0);
+
+        // OPERATORS:
+        CompactStructure& operator=(const CompactStructure& orig);
+
+    protected:
+
+    private:
+        // ATTRIBUTES:
+        vector<char> chainId;
+        vector<unsigned int> chainStart; // first residue of each chain
+
+        vector<int> residueNumber; // PDB residue numbers
+        vector<unsigned char> residueCode; // AminoAcidCode
+        vector<unsigned int> residueChain; // chain of each residue
+        vector<unsigned int> residueStart; // first atom of each residue
+
+        vector<float> coords; // 3 values per atom
+        vector<unsigned char> atomCode; // AtomCode
+        vector<unsigned int> atomResidue; // residue of each atom
+        vector<float> bfac;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                              CompactStructure
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    CompactStructure::sizeChains() const {
+        return chainId.size();
+    }
+
+    inline unsigned int
+    CompactStructure::sizeResidues() const {
+        return residueNumber.size();
+    }
+
+    inline unsigned int
+    CompactStructure::sizeAtoms() const {
+        return atomCode.size();
+    }
+
+    inline char
+    CompactStructure::getChainId(unsigned int c) const {
+        PRECOND(c < chainId.size(), exception);
+        return chainId[c];
+    }
+
+    inline unsigned int
+    CompactStructure::getChainStart(unsigned int c) const {
+        PRECOND(c < chainStart.size(), exception);
+        return chainStart[c];
+    }
+
+    inline unsigned int
+    CompactStructure::getChainEnd(unsigned int c) const {
+        PRECOND(c < chainStart.size(), exception);
+        return (c + 1 < chainStart.size()) ? chainStart[c + 1] : residueNumber.size();
+    }
+
+    inline int
+    CompactStructure::getResidueNumber(unsigned int r) const {
+        PRECOND(r < residueNumber.size(), exception);
+        return residueNumber[r];
+    }
+
+    inline AminoAcidCode
+    CompactStructure::getResidueCode(unsigned int r) const {
+        PRECOND(r < residueCode.size(), exception);
+        return static_cast<AminoAcidCode> (residueCode[r]);
+    }
+
+    inline unsigned int
+    CompactStructure::getResidueChain(unsigned int r) const {
+        PRECOND(r < residueChain.size(), exception);
+        return residueChain[r];
+    }
+
+    inline unsigned int
+    CompactStructure::getResidueStart(unsigned int r) const {
+        PRECOND(r < residueStart.size(), exception);
+        return residueStart[r];
+    }
+
+    inline unsigned int
+    CompactStructure::getResidueEnd(unsigned int r) const {
+        PRECOND(r < residueStart.size(), exception);
+        return (r + 1 < residueStart.size()) ? residueStart[r + 1] : atomCode.size();
+    }
+
+    inline AtomCode
+    CompactStructure::getAtomCode(unsigned int a) const {
+        PRECOND(a < atomCode.size(), exception);
+        return static_cast<AtomCode> (atomCode[a]);
+    }
+
+    inline unsigned int
+    CompactStructure::getAtomResidue(unsigned int a) const {
+        PRECOND(a < atomResidue.size(), exception);
+        return atomResidue[a];
+    }
+
+    inline double
+    CompactStructure::getBFac(unsigned int a) const {
+        PRECOND(a < bfac.size(), exception);
+        return bfac[a];
+    }
+
+    inline vgVector3<double>
+    CompactStructure::getCoords(unsigned int a) const {
+        PRECOND(a < atomCode.size(), exception);
+        const float* c = &coords[3 * a];
+        return vgVector3<double>(c[0], c[1], c[2]);
+    }
+
+    inline const float*
+    CompactStructure::getCoords() const {
+        return coords.empty() ? NULL : &coords[0];
+    }
+
+    // OPERATORS:
+
+    inline CompactStructure&
+    CompactStructure::operator=(const CompactStructure& orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+}} //namespace
+#endif //_CompactStructure_H_
@@ -16,6 +16,7 @@
 
 // Includes:
 #include <Component.h>
+#include <ComponentArena.h>
 #include <Debug.h>
 #include <limits.h>
 #include <float.h>
@@ -54,7 +55,7 @@ Component::getLowerBound(double dist) {
     for (unsigned int i = 0; i < 3; i++)
         tmp[i] -= dist;
 
-    return lowerBound;
+    return tmp;
 }
 /**
  *   Return the upper bound coordinates.
@@ -68,7 +69,7 @@ Component::getUpperBound(double dist) {
     for (unsigned int i = 0; i < 3; i++)
         tmp[i] += dist;
 
-    return upperBound;
+    return tmp;
 }
 
 
@@ -144,6 +145,18 @@ Component& Component::operator=(const Component& orig) {
     return *this;
 }
 
+/**
+ *  Components are taken from the ComponentArena current in the calling
+ *  thread, if any, and from the heap otherwise.
+ */
+void* Component::operator new(size_t size) {
+    return ComponentArena::allocateComponent(size);
+}
+
+void Component::operator delete(void* p) {
+    ComponentArena::deallocateComponent(p);
+}
+
 // HELPERS:
 
 
@@ -94,6 +94,8 @@ namespace Victor { namespace Biopool {
 
         // OPERATORS:
         Component& operator=(const Component& orig);
+        static void* operator new(size_t size); // see ComponentArena
+        static void operator delete(void* p);
 
     protected:
 
@@ -137,7 +139,9 @@ namespace Victor { namespace Biopool {
     
     
     /**
-     *   Is other within dist of this' bounding box?
+     *   Is other within dist of this' bounding box? The boxes have to
+     *   overlap along all three axes. See BoundingVolumeTree for clash 
+     *   detection between many components.
      * @param other (Component)
      * @param dist (double)
      * @return True, if the component collides with "OTHER" 
@@ -145,12 +149,13 @@ namespace Victor { namespace Biopool {
 
     inline bool
     Component::collides(Component& other, double dist) {
-        return ( (lowerBound.x <= other.upperBound.x + dist)
-                || (lowerBound.y <= other.upperBound.y + dist)
-                || (lowerBound.z <= other.upperBound.z + dist)
-                || (upperBound.x >= other.lowerBound.x - dist)
-                || (upperBound.y >= other.lowerBound.y - dist)
-                || (upperBound.z >= other.lowerBound.z - dist));
+        vgVector3<double> lo = getLowerBound(dist);
+        vgVector3<double> hi = getUpperBound(dist);
+        vgVector3<double> otherLo = other.getLowerBound();
+        vgVector3<double> otherHi = other.getUpperBound();
+        return ( (lo.x <= otherHi.x) && (lo.y <= otherHi.y)
+                && (lo.z <= otherHi.z) && (hi.x >= otherLo.x)
+                && (hi.y >= otherLo.y) && (hi.z >= otherLo.z));
     }
 
     inline Component&
@@ -0,0 +1,187 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <ComponentArena.h>
+#include <new>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+static pthread_key_t sCurrentKey;
+static pthread_once_t sCurrentOnce = PTHREAD_ONCE_INIT;
+
+static void sCreateKey() {
+    pthread_key_create(&sCurrentKey, NULL);
+}
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *@param chunkSize bytes allocated at once from the heap
+ */
+ComponentArena::ComponentArena(size_t chunkSize) : chunks(), top(NULL),
+left(0), freeLists(), live(0), released(false) {
+    chunkUnits = (chunkSize + sizeof (Header) - 1) / sizeof (Header);
+    if (chunkUnits < 64)
+        chunkUnits = 64;
+    freeLists.resize(chunkUnits / 4 + 1, static_cast<Header*> (NULL));
+    pthread_mutex_init(&mutex, NULL);
+}
+
+ComponentArena::~ComponentArena() {
+    PRINT_NAME;
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        ::operator delete(chunks[i]);
+    pthread_mutex_destroy(&mutex);
+}
+
+
+// PREDICATES:
+
+size_t
+ComponentArena::sizeChunks() const {
+    pthread_mutex_lock(&mutex);
+    size_t n = chunks.size();
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+size_t
+ComponentArena::sizeLive() const {
+    pthread_mutex_lock(&mutex);
+    size_t n = live;
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+/**
+ *  Arena used by the calling thread for new components, NULL if none.
+ */
+ComponentArena*
+ComponentArena::getCurrent() {
+    pthread_once(&sCurrentOnce, sCreateKey);
+    return static_cast<ComponentArena*> (pthread_getspecific(sCurrentKey));
+}
+
+
+// MODIFIERS:
+
+/**
+ *  Called by the owner instead of delete. The memory is freed as soon as
+ *  no component allocated from the arena is left.
+ *@return void
+ */
+void
+ComponentArena::release() {
+    pthread_mutex_lock(&mutex);
+    released = true;
+    bool done = (live == 0);
+    pthread_mutex_unlock(&mutex);
+    if (done)
+        delete this;
+}
+
+/**
+ *  Sets the arena used by the calling thread for new components.
+ *@param arena arena, NULL to use the heap
+ *@return void
+ */
+void
+ComponentArena::setCurrent(ComponentArena* arena) {
+    pthread_once(&sCurrentOnce, sCreateKey);
+    pthread_setspecific(sCurrentKey, arena);
+}
+
+/**
+ *  Allocates a component from the current arena, or from the heap if no 
+ *  arena is current or the block is too large.
+ *@param size bytes
+ *@return pointer to the block
+ */
+void*
+ComponentArena::allocateComponent(size_t size) {
+    size_t units = (size + sizeof (Header) - 1) / sizeof (Header) + 1;
+    ComponentArena* arena = getCurrent();
+    Header* h;
+    if ((arena != NULL) && (units < arena->freeLists.size()))
+        h = arena->pAllocate(units);
+    else {
+        h = static_cast<Header*> (::operator new(units * sizeof (Header)));
+        h->info.arena = NULL;
+        h->info.units = units;
+    }
+    return h + 1;
+}
+
+/**
+ *  Returns a block obtained from allocateComponent().
+ *@param p pointer to the block
+ *@return void
+ */
+void
+ComponentArena::deallocateComponent(void* p) {
+    if (p == NULL)
+        return;
+    Header* h = static_cast<Header*> (p) - 1;
+    if (h->info.arena == NULL)
+        ::operator delete(h);
+    else
+        h->info.arena->pDeallocate(h);
+}
+
+
+// HELPERS:
+
+ComponentArena::Header*
+ComponentArena::pAllocate(size_t units) {
+    pthread_mutex_lock(&mutex);
+    Header* h = freeLists[units];
+    if (h != NULL)
+        freeLists[units] = *reinterpret_cast<Header**> (h + 1);
+    else {
+        if (left < units) {
+            top = static_cast<Header*> (::operator new(chunkUnits * sizeof (Header)));
+            left = chunkUnits;
+            chunks.push_back(top);
+        }
+        h = top;
+        top += units;
+        left -= units;
+    }
+    live++;
+    pthread_mutex_unlock(&mutex);
+
+    h->info.arena = this;
+    h->info.units = units;
+    return h;
+}
+
+void
+ComponentArena::pDeallocate(Header* h) {
+    pthread_mutex_lock(&mutex);
+    *reinterpret_cast<Header**> (h + 1) = freeLists[h->info.units];
+    freeLists[h->info.units] = h;
+    live--;
+    bool done = (released && (live == 0));
+    pthread_mutex_unlock(&mutex);
+    if (done)
+        delete this;
+}
@@ -0,0 +1,114 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _ComponentArena_H_
+#define _ComponentArena_H_
+
+
+// Includes:
+#include <Debug.h>
+#include <pthread.h>
+#include <vector>
+#include <cstddef>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Chunked memory pool for the component tree.
+     * 
+     *  Components (AminoAcid, Ligand, Spacer, ...) created while an arena is
+     *  active in the calling thread (see Scope) are carved out of large 
+     *  chunks instead of being allocated one by one. Deleted components go 
+     *  to a free list per size and are reused.
+     *  The arena is owned by a Protein: once the owner has released it and
+     *  the last of its components has been deleted, all chunks are freed 
+     *  at once. Components can therefore outlive their Protein safely.
+     * */
+
+    class ComponentArena {
+    public:
+
+        /** Makes an arena current in the calling thread for its lifetime. */
+        class Scope {
+        public:
+
+            Scope(ComponentArena* arena) : previous(ComponentArena::getCurrent()) {
+                ComponentArena::setCurrent(arena);
+            }
+
+            ~Scope() {
+                ComponentArena::setCurrent(previous);
+            }
+
+        private:
+            Scope(const Scope& orig);
+            Scope& operator=(const Scope& orig);
+            ComponentArena* previous;
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        ComponentArena(size_t chunkSize = 65536);
+
+        // PREDICATES:
+        size_t sizeChunks() const;
+        size_t sizeLive() const;
+        static ComponentArena* getCurrent();
+
+        // MODIFIERS:
+        void release();
+        static void setCurrent(ComponentArena* arena);
+        static void* allocateComponent(size_t size);
+        static void deallocateComponent(void* p);
+
+    protected:
+
+    private:
+
+        /** Prefix of every block, keeps the payload 16 byte aligned. */
+        union Header {
+
+            struct {
+                ComponentArena* arena; // NULL for blocks taken from the heap
+                size_t units; // size in units of sizeof(Header)
+            } info;
+            long double align;
+        };
+
+        // HELPERS:
+        ~ComponentArena();
+        Header* pAllocate(size_t units);
+        void pDeallocate(Header* h);
+
+        ComponentArena(const ComponentArena& orig);
+        ComponentArena& operator=(const ComponentArena& orig);
+
+        // ATTRIBUTES:
+        size_t chunkUnits; // chunk size in units
+        vector<Header*> chunks;
+        Header* top; // first free unit of the last chunk
+        size_t left; // units left in the last chunk
+        vector<Header*> freeLists; // one per size in units
+        size_t live; // blocks not yet deallocated
+        bool released; // owner is gone
+        mutable pthread_mutex_t mutex;
+    };
+
+}} //namespace
+
+#endif
@@ -0,0 +1,413 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Includes:
+#include <ContactMap.h>
+#include <algorithm>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+template <class T>
+static void
+sWrite(ostream& os, const T& value) {
+    os.write(reinterpret_cast<const char*> (&value), sizeof (T));
+}
+
+template <class T>
+static void
+sWrite(ostream& os, const vector<T>& values) {
+    unsigned int n = values.size();
+    sWrite(os, n);
+    if (n > 0)
+        os.write(reinterpret_cast<const char*> (&values[0]), n * sizeof (T));
+}
+
+template <class T>
+static void
+sRead(istream& is, T& value) {
+    is.read(reinterpret_cast<char*> (&value), sizeof (T));
+}
+
+template <class T>
+static void
+sRead(istream& is, vector<T>& values) {
+    unsigned int n = 0;
+    sRead(is, n);
+    if (!is)
+        ERROR("ContactMap::read: truncated file.", exception);
+    values.resize(n);
+    if (n > 0)
+        is.read(reinterpret_cast<char*> (&values[0]), n * sizeof (T));
+}
+
+// -----------------------------------------------------------------------
+//                          ContactMap::PairCollector
+// -----------------x-------------------x-------------------x-------------
+
+/**
+ *   Turns the atom pairs of one chain's grid into residue contacts.
+ */
+class ContactMap::PairCollector : public NeighborGrid::PairVisitor {
+public:
+
+    PairCollector(const ContactMap& _map, const NeighborGrid& _grid,
+            unsigned int _offset, vector<Contact>& _found) : map(_map),
+    grid(_grid), offset(_offset), found(_found) {
+    }
+
+    virtual void visit(unsigned int i, unsigned int j, double dist) {
+        map.pAdd(offset + grid.getResidue(i), offset + grid.getResidue(j),
+                dist, found);
+    }
+
+private:
+    const ContactMap& map;
+    const NeighborGrid& grid;
+    unsigned int offset; // first residue of the chain
+    vector<Contact>& found;
+};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Creates an empty map, to be filled by build() or read().
+ *@param cutoff largest distance between atoms of residues in contact
+ *@param filter atoms of each residue considered
+ *@param minSeparation smallest sequence separation of contacts in a chain
+ */
+ContactMap::ContactMap(double cutoff, NeighborGrid::AtomFilter filter,
+        unsigned int minSeparation) : cutoff(cutoff), filter(filter),
+minSeparation(minSeparation) {
+    PRECOND((cutoff > 0.0) && (minSeparation > 0), exception);
+    pClear();
+}
+
+ContactMap::~ContactMap() {
+    PRINT_NAME;
+    for (unsigned int c = 0; c < grids.size(); c++)
+        delete grids[c];
+}
+
+// PREDICATES:
+
+/**
+ *  Checks whether two residues are in contact (binary search in the row
+ *  of r1).
+ *@param r1, r2 residue indices
+ *@return true if they are in contact
+ */
+bool
+ContactMap::isContact(unsigned int r1, unsigned int r2) const {
+    PRECOND((r1 < size()) && (r2 < size()), exception);
+    vector<unsigned int>::const_iterator first = columns.begin() + rowStart[r1];
+    vector<unsigned int>::const_iterator last = columns.begin() + rowStart[r1 + 1];
+    vector<unsigned int>::const_iterator it = lower_bound(first, last, r2);
+    return (it != last) && (*it == r2);
+}
+
+/**
+ *  Returns the chain of a residue.
+ *@param r residue index
+ *@return index of the chain (0 for a Spacer)
+ */
+unsigned int
+ContactMap::getChain(unsigned int r) const {
+    PRECOND(r < size(), exception);
+    return upper_bound(chainStart.begin(), chainStart.end() - 1, r)
+            - chainStart.begin() - 1;
+}
+
+/**
+ *  Writes the map in binary form (native byte order), to be reloaded with
+ *  read().
+ *@param os output stream, opened in binary mode
+ *@return void
+ */
+void
+ContactMap::write(ostream& os) const {
+    sWrite(os, CONTACT_MAP_MAGIC);
+    sWrite(os, CONTACT_MAP_VERSION);
+    sWrite(os, cutoff);
+    unsigned int f = filter;
+    sWrite(os, f);
+    sWrite(os, minSeparation);
+    sWrite(os, chainStart);
+    sWrite(os, rowStart);
+    sWrite(os, columns);
+    sWrite(os, distances);
+}
+
+// MODIFIERS:
+
+/**
+ *  Computes the contacts of a single chain.
+ *@param sp spacer
+ *@return void
+ */
+void
+ContactMap::build(Spacer& sp) {
+    pClear();
+    pAddChain(sp);
+    pBuild();
+}
+
+/**
+ *  Computes the contacts of all chains of a protein, between chains 
+ *  included. Residues are numbered chain after chain.
+ *@param prot protein
+ *@return void
+ */
+void
+ContactMap::build(Protein& prot) {
+    pClear();
+    for (unsigned int c = 0; c < prot.sizeProtein(); c++)
+        pAddChain(*prot.getSpacer(c));
+    pBuild();
+}
+
+/**
+ *  Recomputes the contacts of residues first to last (included) after
+ *  they have moved, e.g. after a loop has been remodelled.
+ *@param first index of the first residue moved
+ *@param last index of the last residue moved
+ *@return void
+ */
+void
+ContactMap::update(unsigned int first, unsigned int last) {
+    PRECOND((first <= last) && (last < size()), exception);
+    vector<unsigned int> residues;
+    for (unsigned int r = first; r <= last; r++)
+        residues.push_back(r);
+    update(residues);
+}
+
+/**
+ *  Recomputes the contacts of the given residues after they have moved.
+ *  The other contacts are kept as they are.
+ *@param residues indices of the residues moved
+ *@return void
+ */
+void
+ContactMap::update(const vector<unsigned int>& residues) {
+    if (grids.size() != sizeChains())
+        ERROR("ContactMap::update: the map has no structure (read from file).",
+            exception);
+
+    vector<bool> moved(size(), false);
+    vector<vector<unsigned int> > local(sizeChains());
+    for (unsigned int k = 0; k < residues.size(); k++) {
+        PRECOND(residues[k] < size(), exception);
+        if (moved[residues[k]])
+            continue;
+        moved[residues[k]] = true;
+        unsigned int c = getChain(residues[k]);
+        local[c].push_back(residues[k] - chainStart[c]);
+    }
+    for (unsigned int c = 0; c < grids.size(); c++)
+        if (local[c].size())
+            grids[c]->update(local[c]);
+
+    vector<Contact> found;
+    found.reserve(columns.size() / 2 + 1);
+    for (unsigned int r = 0; r < size(); r++)
+        if (!moved[r])
+            for (unsigned int k = rowStart[r]; k < rowStart[r + 1]; k++)
+                if ((columns[k] > r) && !moved[columns[k]]) {
+                    Contact tmp = {r, columns[k], distances[k]};
+                    found.push_back(tmp);
+                }
+
+    for (unsigned int c = 0; c < local.size(); c++)
+        for (unsigned int k = 0; k < local[c].size(); k++)
+            pNeighbors(c, local[c][k], found);
+    pCompress(found);
+}
+
+/**
+ *  Reads a map written by write(). The map can be queried but not updated.
+ *@param is input stream, opened in binary mode
+ *@return void
+ */
+void
+ContactMap::read(istream& is) {
+    unsigned int magic = 0, version = 0, f = 0;
+    sRead(is, magic);
+    sRead(is, version);
+    if (!is || (magic != CONTACT_MAP_MAGIC) || (version != CONTACT_MAP_VERSION))
+        ERROR("ContactMap::read: not a contact map file.", exception);
+
+    pClear();
+    sRead(is, cutoff);
+    sRead(is, f);
+    filter = static_cast<NeighborGrid::AtomFilter> (f);
+    sRead(is, minSeparation);
+    sRead(is, chainStart);
+    sRead(is, rowStart);
+    sRead(is, columns);
+    sRead(is, distances);
+    if (!is) {
+        pClear();
+        ERROR("ContactMap::read: truncated file.", exception);
+    }
+    if (!pValid()) {
+        pClear();
+        ERROR("ContactMap::read: corrupt file.", exception);
+    }
+}
+
+// HELPERS:
+
+void
+ContactMap::pClear() {
+    for (unsigned int c = 0; c < grids.size(); c++)
+        delete grids[c];
+    grids.clear();
+    chainStart.assign(1, 0);
+    rowStart.assign(1, 0);
+    columns.clear();
+    distances.clear();
+}
+
+/**
+ *  Checks the arrays read from a file before any query indexes them: 
+ *  chain and row starts begin at 0 and never decrease, there is one row 
+ *  per residue and the partners of each row are increasing residue 
+ *  indices.
+ */
+bool
+ContactMap::pValid() const {
+    if (chainStart.empty() || (chainStart[0] != 0) || rowStart.empty()
+            || (rowStart[0] != 0) || (rowStart.back() != columns.size())
+            || (columns.size() != distances.size()))
+        return false;
+    for (unsigned int c = 1; c < chainStart.size(); c++)
+        if (chainStart[c] < chainStart[c - 1])
+            return false;
+    if (rowStart.size() - 1 != chainStart.back())
+        return false;
+    for (unsigned int r = 0; r < size(); r++) {
+        if (rowStart[r + 1] < rowStart[r])
+            return false;
+        for (unsigned int k = rowStart[r]; k < rowStart[r + 1]; k++)
+            if ((columns[k] >= size())
+                    || ((k > rowStart[r]) && (columns[k] <= columns[k - 1])))
+                return false;
+    }
+    return true;
+}
+
+void
+ContactMap::pAddChain(Spacer& sp) {
+    grids.push_back(new NeighborGrid(sp, cutoff, filter));
+    chainStart.push_back(chainStart.back() + sp.sizeAmino());
+}
+
+/**
+ *  Collects all contacts: pairs within each chain's grid, then the atoms
+ *  of each chain against the grids of the following chains.
+ */
+void
+ContactMap::pBuild() {
+    vector<Contact> found;
+    vector<unsigned int> hits;
+    for (unsigned int c = 0; c < grids.size(); c++) {
+        PairCollector collector(*this, *grids[c], chainStart[c], found);
+        grids[c]->forEachPairWithin(cutoff, collector);
+
+        for (unsigned int c2 = c + 1; c2 < grids.size(); c2++)
+            for (unsigned int i = 0; i < grids[c]->size(); i++) {
+                grids[c2]->neighborsOf(grids[c]->getCoords(i), cutoff, hits);
+                for (unsigned int k = 0; k < hits.size(); k++)
+                    pAdd(chainStart[c] + grids[c]->getResidue(i),
+                        chainStart[c2] + grids[c2]->getResidue(hits[k]),
+                        (grids[c]->getCoords(i)
+                        - grids[c2]->getCoords(hits[k])).length(), found);
+            }
+    }
+    pCompress(found);
+}
+
+void
+ContactMap::pAdd(unsigned int r1, unsigned int r2, double dist,
+        vector<Contact>& found) const {
+    if (r1 > r2)
+        swap(r1, r2);
+    if ((r2 - r1 < minSeparation) && (getChain(r1) == getChain(r2)))
+        return;
+    Contact tmp = {r1, r2, static_cast<float> (dist)};
+    found.push_back(tmp);
+}
+
+/**
+ *  Collects the contacts of residue r (index in chain c) with all chains.
+ */
+void
+ContactMap::pNeighbors(unsigned int c, unsigned int r,
+        vector<Contact>& found) const {
+    vector<unsigned int> hits;
+    const NeighborGrid& grid = *grids[c];
+    for (unsigned int i = grid.getResidueStart(r); i < grid.getResidueEnd(r); i++)
+        for (unsigned int c2 = 0; c2 < grids.size(); c2++) {
+            grids[c2]->neighborsOf(grid.getCoords(i), cutoff, hits);
+            for (unsigned int k = 0; k < hits.size(); k++)
+                pAdd(chainStart[c] + r,
+                    chainStart[c2] + grids[c2]->getResidue(hits[k]),
+                    (grid.getCoords(i) - grids[c2]->getCoords(hits[k])).length(),
+                    found);
+        }
+}
+
+/**
+ *  Builds the CSR rows from a list of contacts, which may contain the same
+ *  pair several times (the shortest distance is kept).
+ */
+void
+ContactMap::pCompress(vector<Contact>& found) {
+    sort(found.begin(), found.end());
+    unsigned int n = 0;
+    for (unsigned int k = 0; k < found.size(); k++)
+        if ((n > 0) && (found[n - 1].first == found[k].first)
+                && (found[n - 1].second == found[k].second))
+            found[n - 1].distance = min(found[n - 1].distance, found[k].distance);
+        else
+            found[n++] = found[k];
+    found.resize(n);
+
+    unsigned int residues = chainStart.back();
+    rowStart.assign(residues + 1, 0);
+    for (unsigned int k = 0; k < n; k++) {
+        rowStart[found[k].first + 1]++;
+        rowStart[found[k].second + 1]++;
+    }
+    for (unsigned int r = 0; r < residues; r++)
+        rowStart[r + 1] += rowStart[r];
+
+    // contacts are sorted by first residue, so every row gets its smaller
+    // partners (as second) before its larger ones, both in order
+    vector<unsigned int> fill(rowStart.begin(), rowStart.end() - 1);
+    columns.resize(2 * n);
+    distances.resize(2 * n);
+    for (unsigned int k = 0; k < n; k++) {
+        unsigned int a = found[k].first, b = found[k].second;
+        columns[fill[a]] = b;
+        distances[fill[a]++] = found[k].distance;
+        columns[fill[b]] = a;
+        distances[fill[b]++] = found[k].distance;
+    }
+}
@@ -0,0 +1,208 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CONTACTMAP_H_
+#define _CONTACTMAP_H_
+
+// Includes:
+#include <NeighborGrid.h>
+#include <Protein.h>
+#include <Spacer.h>
+#include <Debug.h>
+#include <iostream>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    const unsigned int CONTACT_MAP_MAGIC = 0x504d4356; // "VCMP" in little-endian order
+    const unsigned int CONTACT_MAP_VERSION = 1;
+
+    /**@brief Sparse residue contact map of a Spacer or of all chains of a 
+     *    Protein.
+     * 
+     *  Two residues are in contact when any two of their atoms selected by
+     *  the filter (CA, CB, representative or heavy atoms, see 
+     *  NeighborGrid::AtomFilter) are at most cutoff apart. Residues of all
+     *  chains are numbered consecutively (see getChainStart()) and contacts
+     *  between chains are included. Residues of the same chain closer than
+     *  minSeparation in sequence are never in contact.
+     *  The map is stored in compressed sparse row (CSR) format: the partners
+     *  of residue r, in increasing order, are getColumns()[k] for k from 
+     *  getRowStart()[r] to getRowStart()[r + 1], each with the shortest 
+     *  atom distance. Contacts are found with one NeighborGrid per chain, 
+     *  which update() reuses to recompute only the rows of moved residues.
+     * */
+    class ContactMap {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        ContactMap(double cutoff = 8.0,
+                NeighborGrid::AtomFilter filter = NeighborGrid::CA_ATOMS,
+                unsigned int minSeparation = 1);
+        virtual ~ContactMap();
+
+        // PREDICATES:
+        unsigned int size() const; // number of residues
+        unsigned int sizeContacts() const; // number of contacts (pairs)
+        unsigned int sizeContacts(unsigned int r) const; // contacts of r
+        unsigned int sizeChains() const;
+        double getCutoff() const;
+        NeighborGrid::AtomFilter getFilter() const;
+        unsigned int getMinSeparation() const;
+
+        unsigned int getContact(unsigned int r, unsigned int k) const;
+        double getDistance(unsigned int r, unsigned int k) const;
+        bool isContact(unsigned int r1, unsigned int r2) const;
+        unsigned int getChain(unsigned int r) const;
+        unsigned int getChainStart(unsigned int c) const;
+
+        const vector<unsigned int>& getRowStart() const;
+        const vector<unsigned int>& getColumns() const;
+        const vector<float>& getDistances() const;
+
+        void write(ostream& os) const; // binary dump
+
+        // MODIFIERS:
+        void build(Spacer& sp);
+        void build(Protein& prot);
+        void update(unsigned int first, unsigned int last);
+        void update(const vector<unsigned int>& residues);
+        void read(istream& is);
+
+    protected:
+
+    private:
+
+        /** A contact, with first < second. */
+        struct Contact {
+            unsigned int first;
+            unsigned int second;
+            float distance;
+
+            bool operator<(const Contact& other) const {
+                return (first < other.first)
+                        || ((first == other.first) && (second < other.second));
+            }
+        };
+
+        class PairCollector;
+
+        // HELPERS:
+        void pClear();
+        bool pValid() const;
+        void pAddChain(Spacer& sp);
+        void pBuild();
+        void pAdd(unsigned int r1, unsigned int r2, double dist,
+                vector<Contact>& found) const;
+        void pNeighbors(unsigned int c, unsigned int r,
+                vector<Contact>& found) const;
+        void pCompress(vector<Contact>& found);
+
+        ContactMap(const ContactMap& orig);
+        ContactMap& operator=(const ContactMap& orig);
+
+        // ATTRIBUTES:
+        double cutoff;
+        NeighborGrid::AtomFilter filter;
+        unsigned int minSeparation;
+
+        vector<NeighborGrid*> grids; // one per chain, empty after read()
+        vector<unsigned int> chainStart; // first residue of each chain, +1 sentinel
+        vector<unsigned int> rowStart; // CSR row pointers, size() + 1
+        vector<unsigned int> columns; // partners, increasing in each row
+        vector<float> distances; // shortest atom distance of each entry
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                ContactMap
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    ContactMap::size() const {
+        return rowStart.size() - 1;
+    }
+
+    inline unsigned int
+    ContactMap::sizeContacts() const {
+        return columns.size() / 2;
+    }
+
+    inline unsigned int
+    ContactMap::sizeContacts(unsigned int r) const {
+        PRECOND(r < size(), exception);
+        return rowStart[r + 1] - rowStart[r];
+    }
+
+    inline unsigned int
+    ContactMap::sizeChains() const {
+        return chainStart.size() - 1;
+    }
+
+    inline double
+    ContactMap::getCutoff() const {
+        return cutoff;
+    }
+
+    inline NeighborGrid::AtomFilter
+    ContactMap::getFilter() const {
+        return filter;
+    }
+
+    inline unsigned int
+    ContactMap::getMinSeparation() const {
+        return minSeparation;
+    }
+
+    inline unsigned int
+    ContactMap::getContact(unsigned int r, unsigned int k) const {
+        PRECOND(k < sizeContacts(r), exception);
+        return columns[rowStart[r] + k];
+    }
+
+    inline double
+    ContactMap::getDistance(unsigned int r, unsigned int k) const {
+        PRECOND(k < sizeContacts(r), exception);
+        return distances[rowStart[r] + k];
+    }
+
+    inline unsigned int
+    ContactMap::getChainStart(unsigned int c) const {
+        PRECOND(c < chainStart.size(), exception);
+        return chainStart[c];
+    }
+
+    inline const vector<unsigned int>&
+    ContactMap::getRowStart() const {
+        return rowStart;
+    }
+
+    inline const vector<unsigned int>&
+    ContactMap::getColumns() const {
+        return columns;
+    }
+
+    inline const vector<float>&
+    ContactMap::getDistances() const {
+        return distances;
+    }
+
+}} //namespace
+
+#endif
@@ -0,0 +1,216 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <CoordinateView.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Creates an empty view, to be filled by build().
+ *@param filter atoms of each residue to be put in the view
+ */
+template <class T>
+CoordinateView<T>::CoordinateView(NeighborGrid::AtomFilter filter) :
+filter(filter) {
+    pClear();
+}
+
+/**
+ *  Creates the view of the atoms of a spacer.
+ *@param sp spacer
+ *@param filter atoms of each residue to be put in the view
+ */
+template <class T>
+CoordinateView<T>::CoordinateView(Spacer& sp, NeighborGrid::AtomFilter filter) :
+filter(filter) {
+    build(sp);
+}
+
+/**
+ *  Creates the view of the atoms of a single residue.
+ *@param aa residue
+ *@param filter atoms to be put in the view
+ */
+template <class T>
+CoordinateView<T>::CoordinateView(AminoAcid& aa, NeighborGrid::AtomFilter filter) :
+filter(filter) {
+    build(aa);
+}
+
+template <class T>
+CoordinateView<T>::~CoordinateView() {
+    PRINT_NAME;
+}
+
+
+// MODIFIERS:
+
+/**
+ *  (Re)builds the view from the atoms of a spacer.
+ *@param sp spacer
+ *@return void
+ */
+template <class T>
+void
+CoordinateView<T>::build(Spacer& sp) {
+    pClear();
+    for (unsigned int r = 0; r < sp.sizeAmino(); r++)
+        pAddResidue(sp.getAmino(r), r);
+}
+
+/**
+ *  (Re)builds the view from the atoms of a single residue, which is
+ *  residue 0 of the view.
+ *@param aa residue
+ *@return void
+ */
+template <class T>
+void
+CoordinateView<T>::build(AminoAcid& aa) {
+    pClear();
+    pAddResidue(aa, 0);
+}
+
+/**
+ *  Reads again the coordinates of all atoms, discarding changes that were
+ *  not scattered.
+ *@return void
+ */
+template <class T>
+void
+CoordinateView<T>::gather() {
+    for (unsigned int i = 0; i < atoms.size(); i++)
+        pGather(i);
+}
+
+/**
+ *  Reads again the coordinates of the atoms of residues first to last
+ *  (included).
+ *@param first index of the first residue
+ *@param last index of the last residue
+ *@return void
+ */
+template <class T>
+void
+CoordinateView<T>::gather(unsigned int first, unsigned int last) {
+    PRECOND((first <= last) && (last + 1 < residueStart.size()), exception);
+    for (unsigned int i = residueStart[first]; i < residueStart[last + 1]; i++)
+        pGather(i);
+}
+
+/**
+ *  Writes the coordinates changed in the arrays back to the atoms. Atoms
+ *  whose coordinates are unchanged are not touched, so a float view does
+ *  not round the rest of the structure.
+ *@return number of atoms moved
+ */
+template <class T>
+unsigned int
+CoordinateView<T>::scatter() {
+    unsigned int moved = 0;
+    for (unsigned int i = 0; i < atoms.size(); i++)
+        if (pScatter(i))
+            moved++;
+    return moved;
+}
+
+/**
+ *  Writes the changed coordinates of residues first to last (included)
+ *  back to the atoms.
+ *@param first index of the first residue
+ *@param last index of the last residue
+ *@return number of atoms moved
+ */
+template <class T>
+unsigned int
+CoordinateView<T>::scatter(unsigned int first, unsigned int last) {
+    PRECOND((first <= last) && (last + 1 < residueStart.size()), exception);
+    unsigned int moved = 0;
+    for (unsigned int i = residueStart[first]; i < residueStart[last + 1]; i++)
+        if (pScatter(i))
+            moved++;
+    return moved;
+}
+
+
+// HELPERS:
+
+template <class T>
+void
+CoordinateView<T>::pClear() {
+    atoms.clear();
+    codes.clear();
+    atomResidue.clear();
+    residueStart.assign(1, 0);
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+/**
+ *  Appends the atoms of a residue selected by the filter.
+ *@param aa residue
+ *@param r index of the residue
+ *@return void
+ */
+template <class T>
+void
+CoordinateView<T>::pAddResidue(AminoAcid& aa, unsigned int r) {
+    NeighborGrid::selectAtoms(aa, filter, atoms);
+    for (unsigned int i = codes.size(); i < atoms.size(); i++) {
+        codes.push_back(atoms[i]->getCode());
+        atomResidue.push_back(r);
+        x.push_back(T());
+        y.push_back(T());
+        z.push_back(T());
+        pGather(i);
+    }
+    residueStart.push_back(atoms.size());
+}
+
+template <class T>
+void
+CoordinateView<T>::pGather(unsigned int i) {
+    vgVector3<double> c = atoms[i]->getCoords();
+    x[i] = static_cast<T> (c.x);
+    y[i] = static_cast<T> (c.y);
+    z[i] = static_cast<T> (c.z);
+}
+
+template <class T>
+bool
+CoordinateView<T>::pScatter(unsigned int i) {
+    vgVector3<double> c = atoms[i]->getCoords();
+    if ((static_cast<T> (c.x) == x[i]) && (static_cast<T> (c.y) == y[i])
+            && (static_cast<T> (c.z) == z[i]))
+        return false;
+    atoms[i]->setCoords(x[i], y[i], z[i]);
+    return true;
+}
+
+
+namespace Victor { namespace Biopool {
+    template class CoordinateView<float>;
+    template class CoordinateView<double>;
+}} //namespace
@@ -0,0 +1,238 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _CoordinateView_H_
+#define _CoordinateView_H_
+
+
+// Includes:
+#include <NeighborGrid.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Structure-of-arrays copy of the atom coordinates of a Spacer.
+     * 
+     *  The selected atoms are stored in residue order with their x, y and z
+     *  coordinates in three contiguous arrays of float or double, together
+     *  with their atom codes and the offset of every residue. Numerical
+     *  kernels (distances, RMSD, contacts, energies) can run on the plain
+     *  arrays without going through Atom::getCoords() for every access.
+     *  gather() reads the coordinates again from the atoms; scatter() writes
+     *  back those that were changed in the arrays.
+     *  The view keeps pointers to the atoms: the Spacer must not gain or lose
+     *  atoms while the view is in use (call build() again instead).
+     *  Only CoordinateView<float> and CoordinateView<double> are available.
+     * */
+
+    template <class T>
+    class CoordinateView {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        CoordinateView(NeighborGrid::AtomFilter filter = NeighborGrid::ALL_ATOMS);
+        CoordinateView(Spacer& sp,
+                NeighborGrid::AtomFilter filter = NeighborGrid::ALL_ATOMS);
+        CoordinateView(AminoAcid& aa,
+                NeighborGrid::AtomFilter filter = NeighborGrid::ALL_ATOMS);
+        virtual ~CoordinateView();
+
+        // PREDICATES:
+        unsigned int size() const;
+        unsigned int sizeResidues() const;
+        NeighborGrid::AtomFilter getFilter() const;
+
+        const T* getX() const; // NULL if empty
+        const T* getY() const;
+        const T* getZ() const;
+        const AtomCode* getCodes() const;
+        const unsigned int* getResidueOffsets() const; // sizeResidues()+1 entries
+
+        vgVector3<T> getCoords(unsigned int i) const;
+        AtomCode getCode(unsigned int i) const;
+        Atom& getAtom(unsigned int i) const;
+        unsigned int getResidue(unsigned int i) const; // index in the Spacer
+        unsigned int getResidueStart(unsigned int r) const; // first atom of r
+        unsigned int getResidueEnd(unsigned int r) const; // past last atom of r
+
+        // MODIFIERS:
+        T* getX();
+        T* getY();
+        T* getZ();
+        void setCoords(unsigned int i, const vgVector3<T>& c);
+
+        void build(Spacer& sp);
+        void build(AminoAcid& aa);
+        void gather();
+        void gather(unsigned int first, unsigned int last);
+        unsigned int scatter();
+        unsigned int scatter(unsigned int first, unsigned int last);
+
+    protected:
+
+    private:
+        // HELPERS:
+        void pClear();
+        void pAddResidue(AminoAcid& aa, unsigned int r);
+        void pGather(unsigned int i);
+        bool pScatter(unsigned int i);
+
+        // ATTRIBUTES:
+        NeighborGrid::AtomFilter filter;
+
+        vector<Atom*> atoms;
+        vector<AtomCode> codes;
+        vector<unsigned int> atomResidue; // residue of each atom
+        vector<unsigned int> residueStart; // first atom of each residue, +1 sentinel
+        vector<T> x;
+        vector<T> y;
+        vector<T> z;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               CoordinateView
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    template <class T>
+    inline unsigned int
+    CoordinateView<T>::size() const {
+        return atoms.size();
+    }
+
+    template <class T>
+    inline unsigned int
+    CoordinateView<T>::sizeResidues() const {
+        return residueStart.size() - 1;
+    }
+
+    template <class T>
+    inline NeighborGrid::AtomFilter
+    CoordinateView<T>::getFilter() const {
+        return filter;
+    }
+
+    template <class T>
+    inline const T*
+    CoordinateView<T>::getX() const {
+        return x.empty() ? NULL : &x[0];
+    }
+
+    template <class T>
+    inline const T*
+    CoordinateView<T>::getY() const {
+        return y.empty() ? NULL : &y[0];
+    }
+
+    template <class T>
+    inline const T*
+    CoordinateView<T>::getZ() const {
+        return z.empty() ? NULL : &z[0];
+    }
+
+    template <class T>
+    inline const AtomCode*
+    CoordinateView<T>::getCodes() const {
+        return codes.empty() ? NULL : &codes[0];
+    }
+
+    template <class T>
+    inline const unsigned int*
+    CoordinateView<T>::getResidueOffsets() const {
+        return &residueStart[0];
+    }
+
+    template <class T>
+    inline vgVector3<T>
+    CoordinateView<T>::getCoords(unsigned int i) const {
+        PRECOND(i < atoms.size(), exception);
+        return vgVector3<T > (x[i], y[i], z[i]);
+    }
+
+    template <class T>
+    inline AtomCode
+    CoordinateView<T>::getCode(unsigned int i) const {
+        PRECOND(i < codes.size(), exception);
+        return codes[i];
+    }
+
+    template <class T>
+    inline Atom&
+    CoordinateView<T>::getAtom(unsigned int i) const {
+        PRECOND(i < atoms.size(), exception);
+        return *atoms[i];
+    }
+
+    template <class T>
+    inline unsigned int
+    CoordinateView<T>::getResidue(unsigned int i) const {
+        PRECOND(i < atomResidue.size(), exception);
+        return atomResidue[i];
+    }
+
+    template <class T>
+    inline unsigned int
+    CoordinateView<T>::getResidueStart(unsigned int r) const {
+        PRECOND(r + 1 < residueStart.size(), exception);
+        return residueStart[r];
+    }
+
+    template <class T>
+    inline unsigned int
+    CoordinateView<T>::getResidueEnd(unsigned int r) const {
+        PRECOND(r + 1 < residueStart.size(), exception);
+        return residueStart[r + 1];
+    }
+
+    // MODIFIERS:
+
+    template <class T>
+    inline T*
+    CoordinateView<T>::getX() {
+        return x.empty() ? NULL : &x[0];
+    }
+
+    template <class T>
+    inline T*
+    CoordinateView<T>::getY() {
+        return y.empty() ? NULL : &y[0];
+    }
+
+    template <class T>
+    inline T*
+    CoordinateView<T>::getZ() {
+        return z.empty() ? NULL : &z[0];
+    }
+
+    template <class T>
+    inline void
+    CoordinateView<T>::setCoords(unsigned int i, const vgVector3<T>& c) {
+        PRECOND(i < atoms.size(), exception);
+        x[i] = c.x;
+        y[i] = c.y;
+        z[i] = c.z;
+    }
+
+}} //namespace
+
+#endif
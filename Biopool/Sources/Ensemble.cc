@@ -0,0 +1,139 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//Includes:
+#include <Ensemble.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+Ensemble::Ensemble() {
+}
+
+Ensemble::Ensemble(const Ensemble& orig) {
+    this->copy(orig);
+}
+
+Ensemble::~Ensemble() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the index of the atom of residue r with the given code.
+ *@param r residue index
+ *@param code atom code
+ *@return atom index, -1 if r has no such atom
+ */
+int
+Ensemble::findAtom(unsigned int r, AtomCode code) const {
+    for (unsigned int a = getResidueStart(r); a < getResidueEnd(r); a++)
+        if (atomCode[a] == code)
+            return a;
+    return -1;
+}
+
+/**
+ *  Returns the index of the atom of residue r with the given PDB name.
+ *@param r residue index
+ *@param type atom name
+ *@return atom index, -1 if r has no such atom
+ */
+int
+Ensemble::findAtom(unsigned int r, const string& type) const {
+    for (unsigned int a = getResidueStart(r); a < getResidueEnd(r); a++)
+        if (atomType[a] == type)
+            return a;
+    return -1;
+}
+
+// MODIFIERS:
+
+void
+Ensemble::copy(const Ensemble& orig) {
+    residueNumber = orig.residueNumber;
+    residueType = orig.residueType;
+    residueStart = orig.residueStart;
+    atomType = orig.atomType;
+    atomCode = orig.atomCode;
+    atomResidue = orig.atomResidue;
+    modelNumber = orig.modelNumber;
+    coords = orig.coords;
+}
+
+void
+Ensemble::clear() {
+    residueNumber.clear();
+    residueType.clear();
+    residueStart.clear();
+    atomType.clear();
+    atomCode.clear();
+    atomResidue.clear();
+    modelNumber.clear();
+    coords.clear();
+}
+
+/**
+ *  Appends a residue to the topology.
+ *@param number PDB residue number
+ *@param type three letter residue name
+ *@return residue index
+ */
+unsigned int
+Ensemble::addResidue(int number, const string& type) {
+    if (modelNumber.size() > 1)
+        ERROR("Ensemble::addResidue(): topology is fixed after the first model.", exception);
+    residueNumber.push_back(number);
+    residueType.push_back(type);
+    residueStart.push_back(atomType.size());
+    return residueNumber.size() - 1;
+}
+
+/**
+ *  Appends an atom to the last residue, with null coordinates in every
+ *  model already added.
+ *@param type PDB atom name
+ *@return atom index
+ */
+unsigned int
+Ensemble::addAtom(const string& type) {
+    if (residueNumber.size() == 0)
+        ERROR("Ensemble::addAtom(): no residue to add the atom to.", exception);
+    if (modelNumber.size() > 1)
+        ERROR("Ensemble::addAtom(): topology is fixed after the first model.", exception);
+    atomType.push_back(type);
+    atomCode.push_back(AtomTranslator(type));
+    atomResidue.push_back(residueNumber.size() - 1);
+    coords.resize(3 * modelNumber.size() * atomType.size(), 0.0);
+    return atomType.size() - 1;
+}
+
+/**
+ *  Appends a model with null coordinates.
+ *@param number PDB model number
+ *@return model index
+ */
+unsigned int
+Ensemble::addModel(int number) {
+    modelNumber.push_back(number);
+    coords.resize(3 * modelNumber.size() * atomType.size(), 0.0);
+    return modelNumber.size() - 1;
+}
@@ -0,0 +1,210 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _Ensemble_H_
+#define _Ensemble_H_
+
+
+// Includes:
+#include <AtomCode.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <string>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Compact multi-model structure (NMR ensembles, trajectories).
+     * 
+     *  The topology (residues and atoms) is stored once and shared by all
+     *  models, each model only adds a contiguous array of 3 * sizeAtoms()
+     *  coordinates. Atoms of a residue are stored next to each other.
+     *  Models are loaded in a single pass by PdbLoader::loadEnsemble() and
+     *  can be analysed without building a Spacer per model.
+     * */
+
+    class Ensemble {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        Ensemble();
+        Ensemble(const Ensemble& orig);
+        virtual ~Ensemble();
+
+        // PREDICATES:
+        unsigned int sizeModels() const;
+        unsigned int sizeResidues() const;
+        unsigned int sizeAtoms() const;
+
+        int getModelNumber(unsigned int m) const;
+        int getResidueNumber(unsigned int r) const;
+        const string& getResidueType(unsigned int r) const;
+        unsigned int getResidueStart(unsigned int r) const; // first atom of r
+        unsigned int getResidueEnd(unsigned int r) const; // past last atom of r
+
+        unsigned int getAtomResidue(unsigned int a) const;
+        const string& getAtomType(unsigned int a) const;
+        AtomCode getAtomCode(unsigned int a) const;
+        int findAtom(unsigned int r, AtomCode code) const; // -1 if missing
+        int findAtom(unsigned int r, const string& type) const; // -1 if missing
+
+        const double* getModelCoords(unsigned int m) const; // x, y, z per atom
+        vgVector3<double> getCoords(unsigned int m, unsigned int a) const;
+
+        // MODIFIERS:
+        void copy(const Ensemble& orig);
+        void clear();
+
+        // Topology can only grow while the first model is being added.
+        unsigned int addResidue(int number, const string& type);
+        unsigned int addAtom(const string& type);
+        unsigned int addModel(int number);
+        double* getModelCoords(unsigned int m);
+        void setCoords(unsigned int m, unsigned int a, const vgVector3<double>& c);
+
+        // OPERATORS:
+        Ensemble& operator=(const Ensemble& orig);
+
+    protected:
+
+    private:
+        // ATTRIBUTES:
+        vector<int> residueNumber; // PDB residue numbers
+        vector<string> residueType; // three letter residue names
+        vector<unsigned int> residueStart; // first atom of each residue
+
+        vector<string> atomType; // PDB atom names
+        vector<AtomCode> atomCode;
+        vector<unsigned int> atomResidue; // residue of each atom
+
+        vector<int> modelNumber; // PDB model numbers
+        vector<double> coords; // models one after the other, 3 values per atom
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                  Ensemble
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    Ensemble::sizeModels() const {
+        return modelNumber.size();
+    }
+
+    inline unsigned int
+    Ensemble::sizeResidues() const {
+        return residueNumber.size();
+    }
+
+    inline unsigned int
+    Ensemble::sizeAtoms() const {
+        return atomType.size();
+    }
+
+    inline int
+    Ensemble::getModelNumber(unsigned int m) const {
+        PRECOND(m < modelNumber.size(), exception);
+        return modelNumber[m];
+    }
+
+    inline int
+    Ensemble::getResidueNumber(unsigned int r) const {
+        PRECOND(r < residueNumber.size(), exception);
+        return residueNumber[r];
+    }
+
+    inline const string&
+    Ensemble::getResidueType(unsigned int r) const {
+        PRECOND(r < residueType.size(), exception);
+        return residueType[r];
+    }
+
+    inline unsigned int
+    Ensemble::getResidueStart(unsigned int r) const {
+        PRECOND(r < residueStart.size(), exception);
+        return residueStart[r];
+    }
+
+    inline unsigned int
+    Ensemble::getResidueEnd(unsigned int r) const {
+        PRECOND(r < residueStart.size(), exception);
+        return (r + 1 < residueStart.size()) ? residueStart[r + 1] : atomType.size();
+    }
+
+    inline unsigned int
+    Ensemble::getAtomResidue(unsigned int a) const {
+        PRECOND(a < atomResidue.size(), exception);
+        return atomResidue[a];
+    }
+
+    inline const string&
+    Ensemble::getAtomType(unsigned int a) const {
+        PRECOND(a < atomType.size(), exception);
+        return atomType[a];
+    }
+
+    inline AtomCode
+    Ensemble::getAtomCode(unsigned int a) const {
+        PRECOND(a < atomCode.size(), exception);
+        return atomCode[a];
+    }
+
+    inline const double*
+    Ensemble::getModelCoords(unsigned int m) const {
+        PRECOND(m < modelNumber.size(), exception);
+        return &coords[3 * m * atomType.size()];
+    }
+
+    inline vgVector3<double>
+    Ensemble::getCoords(unsigned int m, unsigned int a) const {
+        PRECOND(a < atomType.size(), exception);
+        const double* c = getModelCoords(m) + 3 * a;
+        return vgVector3<double>(c[0], c[1], c[2]);
+    }
+
+    // MODIFIERS:
+
+    inline double*
+    Ensemble::getModelCoords(unsigned int m) {
+        PRECOND(m < modelNumber.size(), exception);
+        return &coords[3 * m * atomType.size()];
+    }
+
+    inline void
+    Ensemble::setCoords(unsigned int m, unsigned int a, const vgVector3<double>& c) {
+        PRECOND(a < atomType.size(), exception);
+        double* p = getModelCoords(m) + 3 * a;
+        p[0] = c.x;
+        p[1] = c.y;
+        p[2] = c.z;
+    }
+
+    // OPERATORS:
+
+    inline Ensemble&
+    Ensemble::operator=(const Ensemble& orig) {
+        if (&orig != this)
+            copy(orig);
+        return *this;
+    }
+
+}} //namespace
+#endif //_Ensemble_H_
@@ -0,0 +1,548 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <FastPdbSaver.h>
+#include <IoTools.h>
+#include <vector3.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+static const unsigned int BUFFER_SIZE = 65536;
+
+// -----------------------------------------------------------------------
+//                          FastPdbSaver::Writer
+// -----------------x-------------------x-------------------x-------------
+
+/**
+ *   Block sink over the output stream. With gzip, every block is deflated
+ *   as it arrives and each finish() closes a gzip member, so a file may 
+ *   consist of several concatenated members (as allowed by the format).
+ */
+class FastPdbSaver::Writer {
+public:
+    Writer(ostream& _output, bool _gzip);
+    ~Writer();
+    void write(const char* data, unsigned int size);
+    void flushOutput();
+    void finish();
+
+private:
+    void deflateBlock(const char* data, unsigned int size, int mode);
+
+    ostream& output;
+    bool gzip;
+    bool pending; // data deflated since the last finish()
+#ifdef HAVE_ZLIB
+    vector<char> raw; // compressed characters
+    z_stream zs;
+#endif
+};
+
+FastPdbSaver::Writer::Writer(ostream& _output, bool _gzip) : output(_output),
+gzip(_gzip), pending(false) {
+    if (!gzip)
+        return;
+#ifdef HAVE_ZLIB
+    raw.resize(BUFFER_SIZE);
+    zs.zalloc = Z_NULL;
+    zs.zfree = Z_NULL;
+    zs.opaque = Z_NULL;
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+            Z_DEFAULT_STRATEGY) != Z_OK) // 16: gzip header
+        ERROR("Cannot initialize gzip compression.", exception);
+#else
+    ERROR("gzip output needs zlib: rebuild without nozlib=1.", exception);
+#endif
+}
+
+FastPdbSaver::Writer::~Writer() {
+    finish();
+#ifdef HAVE_ZLIB
+    if (gzip)
+        deflateEnd(&zs);
+#endif
+}
+
+void
+FastPdbSaver::Writer::write(const char* data, unsigned int size) {
+    if (size == 0)
+        return;
+    if (gzip)
+        deflateBlock(data, size, 0);
+    else
+        output.write(data, size);
+}
+
+/**
+ *   Pushes everything written so far to the stream, in a form that can
+ *   already be decompressed.
+ */
+void
+FastPdbSaver::Writer::flushOutput() {
+#ifdef HAVE_ZLIB
+    if (gzip && pending)
+        deflateBlock(NULL, 0, Z_SYNC_FLUSH);
+#endif
+    output.flush();
+}
+
+/**
+ *   Closes the current gzip member. Later writes start a new one.
+ */
+void
+FastPdbSaver::Writer::finish() {
+#ifdef HAVE_ZLIB
+    if (gzip && pending) {
+        deflateBlock(NULL, 0, Z_FINISH);
+        deflateReset(&zs);
+        pending = false;
+    }
+#endif
+    output.flush();
+}
+
+void
+FastPdbSaver::Writer::deflateBlock(const char* data, unsigned int size,
+        int mode) {
+#ifdef HAVE_ZLIB
+    zs.next_in = reinterpret_cast<Bytef*> (const_cast<char*> (data));
+    zs.avail_in = size;
+    int ret;
+    do {
+        zs.next_out = reinterpret_cast<Bytef*> (&raw[0]);
+        zs.avail_out = BUFFER_SIZE;
+        ret = deflate(&zs, mode); // mode 0 is Z_NO_FLUSH
+        if (ret == Z_STREAM_ERROR)
+            ERROR("Corrupt gzip output.", exception);
+        output.write(&raw[0], BUFFER_SIZE - zs.avail_out);
+    } while ((zs.avail_out == 0) || ((mode == Z_FINISH) && (ret != Z_STREAM_END)));
+    pending = true;
+#endif
+}
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+FastPdbSaver::FastPdbSaver(ostream& _output, bool _gzip)
+: writer(new Writer(_output, _gzip)), buffer(BUFFER_SIZE), used(0),
+writeSeq(true), writeSecStr(true), writeTer(true), atomOffset(0),
+ligandOffset(0), aminoOffset(0), chain(' '), model(0) {
+}
+
+FastPdbSaver::~FastPdbSaver() {
+    PRINT_NAME;
+    pFlushBuffer();
+    delete writer;
+}
+
+// PREDICATES:
+
+/**
+ *   Writes the END record and flushes the output. With gzip, this also 
+ *   closes the compressed stream.
+ *@return void
+ */
+void FastPdbSaver::endFile() {
+    pPut("END\n", 4);
+    pFlushBuffer();
+    writer->finish();
+}
+
+// MODIFIERS:
+
+/**
+ *   Starts the next model of a multi-model file (MODEL record). 
+ *@return void
+ */
+void FastPdbSaver::beginModel() {
+    model++;
+    pPut("MODEL     ", 10);
+    pInt(model, 4);
+    pPut('\n');
+}
+
+/**
+ *   Ends the current model (ENDMDL record).
+ *@return void
+ */
+void FastPdbSaver::endModel() {
+    pPut("ENDMDL\n", 7);
+}
+
+/**
+ *   Writes all buffered records to the output.
+ *@return void
+ */
+void FastPdbSaver::flushOutput() {
+    pFlushBuffer();
+    writer->flushOutput();
+}
+
+/**
+ *  Saves a group in PDB format.
+ *@param group reference 
+ *@return void
+ */
+void FastPdbSaver::saveGroup(Group& gr) {
+    gr.sync();
+
+    for (unsigned int i = 0; i < gr.size(); i++) {
+        const string& atName = gr[i].getType();
+
+        if (atName == "OXT") // cosmetics: OXT has to be output after 
+            continue; // the sidechain and therefore goes in saveSpacer
+
+        // atom type H (last column in PDBs)
+        char atomOneLetter = isdigit(atName[0]) ? atName[1] : atName[0];
+
+        pPut("ATOM", 4);
+        pInt(gr[i].getNumber(), 7);
+        pPut(' ');
+        unsigned int len = atName.size();
+        if (!isdigit(atName[0]) && (len < 4)) { // example HG12
+            pPut(' ');
+            len++;
+        }
+        pPut(atName);
+        for (; len < 4; len++)
+            pPut(' ');
+        pPut(' ');
+        pPut(gr.getType());
+        pPut(' ');
+        pPut(chain);
+        pInt(aminoOffset, 4);
+        pPut("    ", 4);
+        pCoords(gr[i], gr[i].getBFac());
+        pPut("           ", 11);
+        pPut(atomOneLetter);
+        pPut('\n');
+
+        atomOffset = gr[i].getNumber() + 1;
+    }
+}
+
+/**
+ *  Saves a sidechain in PDB format. 
+ *@param sideChain reference 
+ *@return void
+ */
+void FastPdbSaver::saveSideChain(SideChain& sc) {
+    saveGroup(sc);
+}
+
+/**
+ *  Saves an aminoacid in PDB format.
+ *@param AminoAcid reference 
+ *@return void
+ */
+void FastPdbSaver::saveAminoAcid(AminoAcid& aa) {
+    saveGroup(aa);
+}
+
+/**
+ *  Saves a spacer in PDB format. 
+ *@param Spacer reference 
+ *@return void
+ */
+void FastPdbSaver::saveSpacer(Spacer& sp) {
+    PRINT_NAME;
+
+    if (sp.size() == 0)
+        return;
+
+    if (sp.getDepth() == 0) {
+        if (writeTer) {
+            pPut("HEADER    ", 10);
+            pPut(sp.getType());
+            pPut("\nREMARK    created using Biopool2000 $Revision: 1.6.2.3 $ \n");
+        }
+        aminoOffset = 0;
+        atomOffset = sp.getAtomStartOffset();
+    }
+
+    if (writeSeq)
+        writeSeqRes(sp);
+
+    aminoOffset = sp.getStartOffset();
+    atomOffset = sp.getAtomStartOffset();
+
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+        aminoOffset++;
+        while ((sp.isGap(aminoOffset)) && (aminoOffset < sp.maxPdbNumber()))
+            aminoOffset++;
+        sp.getAmino(i).save(*this);
+    }
+
+    // cosmetics: write OXT after last side chain
+    AminoAcid& last = sp.getAmino(sp.sizeAmino() - 1);
+    if (last.isMember(OXT)) {
+        pPut("ATOM", 4);
+        pInt(last[OXT].getNumber(), 7);
+        pPut("  OXT ", 6);
+        pPut(last.getType());
+        pPut(' ');
+        pPut(chain);
+        pInt(aminoOffset, 4);
+        pPut("    ", 4);
+        pCoords(last[OXT], last[OXT].getBFac());
+        pPut("           O\n", 13);
+    }
+
+    if ((sp.getDepth() == 0) && (writeTer)) {
+        pPut("TER    ", 7);
+        pInt(atomOffset + 1, 4);
+        pPut("      ", 6);
+        pPut(last.getType());
+        pPut("  ", 2);
+        pInt(aminoOffset, 4);
+        pPut('\n');
+    }
+
+    aminoOffset = 0; //necessary if the's more than one spacer
+    pPut("TER\n", 4);
+}
+
+/**
+ *  Saves a Ligand in PDB format. 
+ *@param Ligand reference 
+ *@return void
+ */
+void FastPdbSaver::saveLigand(Ligand& gr) {
+    gr.sync();
+
+    string aaType = gr.getType();
+    bool nucleotide = isKnownNucleotide(nucleotideThreeLetterTranslator(aaType));
+
+    for (unsigned int i = 0; i < gr.size(); i++) { //print all HETATM of a ligand
+        string atType = gr[i].getType();
+        aaType = gr.getType();
+        string atTypeShort; //last column in a Pdb File
+        if (atType != aaType) {
+            atTypeShort = atType[0];
+            atTypeShort = ' ' + atTypeShort;
+            atType = ' ' + atType;
+        } else {
+            atTypeShort = atType;
+            aaType = ' ' + aaType;
+        }
+        while (atType.size() < 4)
+            atType = atType + ' ';
+
+        pPut(nucleotide ? "ATOM  " : "HETATM", 6);
+        pInt(gr[i].getNumber(), 5);
+        pPut(' ');
+        pPad(atType, 4);
+        pPut(' ');
+        pPad(aaType, 3);
+        pPut(' ');
+        pPut(chain);
+        pInt(ligandOffset, 4);
+        pPut("    ", 4);
+        pCoords(gr[i], gr[i].getBFac());
+        pPut("          ", 10);
+        pPut(atTypeShort);
+        pPut('\n');
+    }
+    if (nucleotide)
+        pPut("TER\n", 4);
+
+    ligandOffset++;
+}
+
+/**
+ *  Saves a LigandSet in PDB format. 
+ *@param LigandSet reference 
+ *@return void
+ */
+void FastPdbSaver::saveLigandSet(LigandSet& ls) {
+    ligandOffset = ls.getStartOffset(); //set the offset for current LigandSet
+
+    for (unsigned int i = 0; i < ls.sizeLigand(); i++) {
+        while ((ls.isGap(ligandOffset))
+                && (ligandOffset < ls.maxPdbNumber()))
+            ligandOffset++;
+        ls[i].save(*this);
+    }
+}
+
+/**
+ *  Saves a Protein in PDB format. 
+ *@param Protein reference 
+ *@return void
+ */
+void FastPdbSaver::saveProtein(Protein& prot) {
+    for (unsigned int i = 0; i < prot.sizeProtein(); i++) {
+        setChain(prot.getChainLetter(i)); //set the actual chain's ID
+        saveSpacer(*prot.getSpacer(i));
+    }
+
+    for (unsigned int i = 0; i < prot.sizeProtein(); i++) {
+        setChain(prot.getChainLetter(i)); //set the actual chain's ID
+        LigandSet* ls = prot.getLigandSet(i);
+        if (ls != NULL)
+            saveLigandSet(*ls);
+    }
+}
+
+// HELPERS:
+
+/**
+ *  Writes the SEQRES entry (PDB format) for a spacer, numbered as 
+ *    PdbSaver does.
+ *@param Spacer reference 
+ *@return void
+ */
+void FastPdbSaver::writeSeqRes(Spacer& sp) {
+    unsigned int n = sp.sizeAmino();
+    for (unsigned int i = 0; i < n / 13; i++) {
+        pPut("SEQRES ", 7);
+        pInt(i, 3);
+        pPut("   ", 3);
+        pInt(n, 3);
+        pPut("   ", 3);
+        for (unsigned int j = 0; j < 13; j++) {
+            pPut(sp.getAmino((i * 13) + j).getType());
+            pPut(' ');
+        }
+        pPut('\n');
+    }
+    if (n % 13 > 0) {
+        pPut("SEQRES ", 7);
+        pInt(n / 13 + 1, 3);
+        pPut("   ", 3);
+        pInt(n, 3);
+        pPut("   ", 3);
+        for (unsigned int j = 13 * (n / 13); j < n; j++) {
+            pPut(sp.getAmino(j).getType());
+            pPut(' ');
+        }
+        pPut('\n');
+    }
+}
+
+/**
+ *  Writes the coordinate, occupancy and B-factor columns of an atom.
+ */
+void FastPdbSaver::pCoords(Atom& at, double bfac) {
+    vgVector3<double> c = at.getCoords();
+    pFixed(c.x, 8, 3);
+    pFixed(c.y, 8, 3);
+    pFixed(c.z, 8, 3);
+    pPut("  1.00", 6);
+    pFixed(bfac, 6, 2);
+}
+
+void FastPdbSaver::pPut(const char* s, unsigned int n) {
+    if (used + n > buffer.size())
+        pFlushBuffer();
+    if (n > buffer.size()) {
+        writer->write(s, n);
+        return;
+    }
+    memcpy(&buffer[used], s, n);
+    used += n;
+}
+
+void FastPdbSaver::pPut(const string& s) {
+    pPut(s.data(), s.size());
+}
+
+/**
+ *  Writes a string right aligned in a column of the given width, as 
+ *    setw() does (longer strings are not cut).
+ */
+void FastPdbSaver::pPad(const string& s, unsigned int width) {
+    for (unsigned int i = s.size(); i < width; i++)
+        pPut(' ');
+    pPut(s);
+}
+
+/**
+ *  Writes an integer right aligned in a column of the given width.
+ */
+void FastPdbSaver::pInt(long value, unsigned int width) {
+    char tmp[24];
+    unsigned int n = 0;
+    unsigned long v = (value < 0) ? 0UL - static_cast<unsigned long> (value)
+            : static_cast<unsigned long> (value);
+    do {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0)
+        tmp[n++] = '-';
+
+    for (unsigned int i = n; i < width; i++)
+        pPut(' ');
+    while (n > 0)
+        pPut(tmp[--n]);
+}
+
+/**
+ *  Writes a number in fixed point notation right aligned in a column of 
+ *    the given width (precision up to 4), with the same digits as 
+ *    printf("%*.*f"). Values 
+ *    whose rounding is a tie within the double precision, zeros (for the 
+ *    sign of -0) and values out of range are left to sprintf.
+ */
+void FastPdbSaver::pFixed(double value, unsigned int width,
+        unsigned int precision) {
+    static const double SCALE[] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+
+    double scaled = fabs(value) * SCALE[precision];
+    if (!(scaled < 1e15) || (value == 0.0)
+            || (fabs(scaled - floor(scaled) - 0.5) < 1e-6)) {
+        char tmp[512];
+        int n = sprintf(tmp, "%*.*f", width, precision, value);
+        pPut(tmp, n);
+        return;
+    }
+
+    char tmp[32];
+    unsigned int n = 0;
+    unsigned long v = static_cast<unsigned long> (scaled + 0.5);
+    for (unsigned int i = 0; i < precision; i++) {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    }
+    if (precision > 0)
+        tmp[n++] = '.';
+    do {
+        tmp[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0)
+        tmp[n++] = '-';
+
+    for (unsigned int i = n; i < width; i++)
+        pPut(' ');
+    while (n > 0)
+        pPut(tmp[--n]);
+}
+
+void FastPdbSaver::pFlushBuffer() {
+    writer->write(&buffer[0], used);
+    used = 0;
+}
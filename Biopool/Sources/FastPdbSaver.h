@@ -0,0 +1,159 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FAST_PDB_SAVER_H_
+#define _FAST_PDB_SAVER_H_
+
+// Includes:
+#include <Group.h>
+#include <SideChain.h>
+#include <AminoAcid.h>
+#include <Spacer.h>
+#include <LigandSet.h>
+#include <Ligand.h>
+#include <Saver.h>
+#include <Debug.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <Protein.h>
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Saves components in standard PDB format through a reusable 
+     *    buffer.
+     * 
+     *  Writes the same records as PdbSaver, but formats the fixed columns
+     *  itself (including the coordinates) instead of going through stream
+     *  manipulators and hands the output stream blocks of 64 kB. Several 
+     *  models can be written to one file with beginModel()/endModel() and 
+     *  the output can be gzip compressed on the fly when Victor is built 
+     *  with zlib. Everything is flushed by endFile(), flushOutput() or the 
+     *  destructor.
+     * */
+    class FastPdbSaver : public Saver {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        /**
+         *   Basic constructor. By default it writes sequence, secondary structure and the term line. 
+         * @param _output (ostream&) the output file object
+         * @param _gzip (bool) if true, the output is gzip compressed
+         */
+        FastPdbSaver(ostream& _output = cout, bool _gzip = false);
+        // this class cannot be copied, see below.
+
+        virtual ~FastPdbSaver();
+
+        // PREDICATES:
+
+        unsigned int getModel() const {
+            return model;
+        }
+
+        void endFile();
+
+        // MODIFIERS:
+
+        void setWriteSecondaryStructure() {
+            writeSecStr = true;
+        }
+
+        void setDoNotWriteSecondaryStructure() {
+            writeSecStr = false;
+        }
+
+        void setWriteSeqRes() {
+            writeSeq = true;
+        }
+
+        void setDoNotWriteSeqRes() {
+            writeSeq = false;
+        }
+
+        void setWriteAtomOnly() {
+            writeSecStr = false;
+            writeSeq = false;
+            writeTer = false;
+        }
+
+        void setWriteAll() {
+            writeSecStr = true;
+            writeSeq = true;
+            writeTer = true;
+        }
+
+        void setChain(char _ch) {
+            chain = _ch;
+        }
+        void beginModel();
+        void endModel();
+        void flushOutput();
+
+        virtual void saveGroup(Group& gr);
+        virtual void saveSideChain(SideChain& sc);
+        virtual void saveAminoAcid(AminoAcid& aa);
+        virtual void saveSpacer(Spacer& sp);
+        virtual void saveLigand(Ligand& l);
+        virtual void saveLigandSet(LigandSet& l);
+        virtual void saveProtein(Protein& prot);
+
+    protected:
+
+    private:
+        class Writer;
+
+        FastPdbSaver(const FastPdbSaver& orig);
+        FastPdbSaver& operator=(const FastPdbSaver& orig);
+
+        // HELPERS:
+        void writeSeqRes(Spacer& sp); // writes SEQRES entry
+        void pCoords(Atom& at, double bfac);
+        void pPut(char c);
+        void pPut(const char* s, unsigned int n);
+        void pPut(const string& s);
+        void pPad(const string& s, unsigned int width);
+        void pInt(long value, unsigned int width);
+        void pFixed(double value, unsigned int width, unsigned int precision);
+        void pFlushBuffer();
+
+        // ATTRIBUTES 
+        Writer* writer; // plain or gzip output
+        vector<char> buffer; // formatted records not yet written
+        unsigned int used; // characters in buffer
+        bool writeSeq, writeSecStr, writeTer;
+        unsigned int atomOffset, ligandOffset;
+        int aminoOffset;
+        char chain; // chain ID
+        unsigned int model; // serial number of the last MODEL record
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                    FastPdbSaver
+    // -----------------x-------------------x-------------------x-----------------
+
+    // MODIFIERS:
+
+    inline void
+    FastPdbSaver::pPut(char c) {
+        if (used == buffer.size())
+            pFlushBuffer();
+        buffer[used++] = c;
+    }
+
+}} //namespace
+#endif //_FAST_PDB_SAVER_H_
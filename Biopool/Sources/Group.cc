@@ -56,12 +56,13 @@ Group::resetBoundaries() {
     upperBound = -tmpV;
 
     for (unsigned int i = 0; i < atoms.size(); i++) {
-        for (unsigned int j = 0; j < 3; j++)
-            if (atoms[i].getCoords()[j] < lowerBound[j])
-                lowerBound[j] = atoms[i].getCoords()[j];
-        for (unsigned int j = 0; j < 3; j++)
-            if (atoms[i].getCoords()[j] > upperBound[j])
-                upperBound[j] = atoms[i].getCoords()[j];
+        vgVector3<double> c = atoms[i].getCoords();
+        for (unsigned int j = 0; j < 3; j++) {
+            if (c[j] < lowerBound[j])
+                lowerBound[j] = c[j];
+            if (c[j] > upperBound[j])
+                upperBound[j] = c[j];
+        }
     }
 
 }
@@ -67,6 +67,9 @@ namespace Victor { namespace Biopool {
         /** Set a new number. */
         void setNumber(long _number);
 
+        /** Last number handed out. */
+        static long getLastNumber();
+
 
 
         /* FRIENDS */
@@ -91,14 +94,14 @@ namespace Victor { namespace Biopool {
         if (n != 0) {
             number = n;
         } else {
-            number = ++counter;
+            number = __sync_add_and_fetch(&counter, 1); // chains load concurrently
         }
     }
 
     inline
     Identity::Identity(const Identity& orig)
     : name(orig.name) {
-        number = ++counter;
+        number = __sync_add_and_fetch(&counter, 1);
     }
 
     inline
@@ -135,8 +138,20 @@ namespace Victor { namespace Biopool {
     void
     Identity::setNumber(long _number) {
         number = _number;
-        if (_number >= counter)
-            counter = _number;
+        // raise counter to _number, never lower it (chains load concurrently)
+        long old = counter;
+        while (_number > old) {
+            long seen = __sync_val_compare_and_swap(&counter, old, _number);
+            if (seen == old)
+                break;
+            old = seen;
+        }
+    }
+
+    inline
+    long
+    Identity::getLastNumber() {
+        return __sync_add_and_fetch(&counter, 0);
     }
 
     // ---------------------------------------------------------------------------
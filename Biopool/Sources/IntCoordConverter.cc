@@ -19,10 +19,58 @@
 #include <vector3.h>
 #include <matrix3.h>
 #include <AminoAcid.h>
+#include <Spacer.h>
 
 // Global constants, typedefs, etc. (to avoid):
 using namespace Victor; using namespace Victor::Biopool;
 
+/**
+ *   NeRF kernel: places n atoms following a -> b -> c, each one bonded to
+ * the previous, from its bond length and the cosine and sine of its bond
+ * and torsion angles. No trigonometric function is called in the loop.
+ */
+static void
+sPlace(vgVector3<double> a, vgVector3<double> b, vgVector3<double> c,
+        const double* bondLength, const double* cosAngle, const double* sinAngle,
+        const double* cosTorsion, const double* sinTorsion, unsigned int n,
+        vgVector3<double>* out) {
+    for (unsigned int k = 0; k < n; k++) {
+        vgVector3<double> bc = (c - b).normalize();
+        vgVector3<double> nrm = ((b - a).cross(bc)).normalize();
+        vgVector3<double> m = nrm.cross(bc);
+
+        out[k] = c + bondLength[k] * (-cosAngle[k] * bc
+                + (sinAngle[k] * cosTorsion[k]) * m
+                + (sinAngle[k] * sinTorsion[k]) * nrm);
+        a = b;
+        b = c;
+        c = out[k];
+    }
+}
+
+/**
+ *   Orthonormal frame spanned by p -> q -> r, centered in q.
+ */
+static void
+sFrame(const vgVector3<double>& p, const vgVector3<double>& q,
+        const vgVector3<double>& r, vgVector3<double>* e) {
+    e[0] = (r - q).normalize();
+    e[2] = ((p - q).cross(e[0])).normalize();
+    e[1] = e[2].cross(e[0]);
+}
+
+/**
+ *   Brings an angle in degrees into [-180, 180], as AminoAcid::setPhi() does.
+ */
+static double
+sWrap(double a) {
+    if (a < -180)
+        a += 360;
+    else if (a > 180)
+        a -= 360;
+    return a;
+}
+
 // CONSTRUCTORS/DESTRUCTOR:
 
 IntCoordConverter::IntCoordConverter() {
@@ -461,3 +509,222 @@ IntCoordConverter::zAtomToCartesian(Atom& atbLP, const double bondLength,
                 * (a * u1[2] + b * u2[2] + c * u3[2]));
     }
 }
+
+/**
+ *   Vectorized NeRF: converts arrays of internal coordinates into cartesian
+ * coordinates. The n atoms are placed one after the other following the
+ * three reference positions a -> b -> c. Sines and cosines are computed in a
+ * single pass before the placement loop.
+ * All angles for this function are in *DEGREES* not radiants!
+ * 
+ * @param a, b, c (const vgVector3<double>&) reference positions
+ * @param bondLength (const double*) n bond lengths
+ * @param bondAngle (const double*) n bond angles
+ * @param torsionAngle (const double*) n torsion angles
+ * @param n (unsigned int) number of atoms to place
+ * @param out (vgVector3<double>*) n resulting positions
+ */
+void
+IntCoordConverter::placeChain(const vgVector3<double>& a,
+        const vgVector3<double>& b, const vgVector3<double>& c,
+        const double* bondLength, const double* bondAngle,
+        const double* torsionAngle, unsigned int n, vgVector3<double>* out) {
+    if (n == 0)
+        return;
+
+    vector<double> cosAngle(n), sinAngle(n), cosTorsion(n), sinTorsion(n);
+    for (unsigned int k = 0; k < n; k++) {
+        cosAngle[k] = cos(DEG2RAD * bondAngle[k]);
+        sinAngle[k] = sin(DEG2RAD * bondAngle[k]);
+        cosTorsion[k] = cos(DEG2RAD * torsionAngle[k]);
+        sinTorsion[k] = sin(DEG2RAD * torsionAngle[k]);
+    }
+
+    sPlace(a, b, c, bondLength, &cosAngle[0], &sinAngle[0], &cosTorsion[0],
+            &sinTorsion[0], n, out);
+}
+
+/**
+ *   Sets phi, psi and omega of all the amino acids of a spacer at once.
+ * The backbone is rebuilt with placeChain()'s NeRF kernel, keeping the bond
+ * lengths and bond angles of the current structure, while all other atoms
+ * (side chains, O, H, ...) are moved rigidly with the frame of the backbone
+ * atom they are bonded to. The result is written into the atoms in one
+ * pass, which is faster than calling
+ * AminoAcid::setPhi(), setPsi() and setOmega() for each residue.
+ * As with those, angles are in degrees and values >= 990 keep the current
+ * angle. The first residue of each connected segment keeps its position.
+ * 
+ * @param sp (Spacer&) the spacer to modify
+ * @param phi, psi, omega (const vector<double>&) one angle per amino acid
+ */
+void
+IntCoordConverter::setTorsionAngles(Spacer& sp, const vector<double>& phi,
+        const vector<double>& psi, const vector<double>& omega) {
+    unsigned int n = sp.sizeAmino();
+    PRECOND((phi.size() == n) && (psi.size() == n) && (omega.size() == n),
+            exception);
+    if (n == 0)
+        return;
+    sp.sync();
+
+    // gather the backbone N -> CA -> C of each residue:
+    vector<Atom*> backbone(3 * n);
+    vector<bool> start(n);
+    for (unsigned int i = 0; i < n; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        if (!aa.isMember(N) || !aa.isMember(CA) || !aa.isMember(C))
+            ERROR("IntCoordConverter::setTorsionAngles : Incomplete backbone.",
+                exception);
+        backbone[3 * i] = &aa[N];
+        backbone[3 * i + 1] = &aa[CA];
+        backbone[3 * i + 2] = &aa[C];
+        start[i] = (i == 0) || (aa.sizeInBonds() == 0)
+                || (&aa.getInBond(0) != &sp.getAmino(i - 1));
+    }
+
+    // internal coordinates of the current backbone, torsions as requested:
+    unsigned int nb = backbone.size();
+    vector<vgVector3<double> > oldPos(nb), newPos(nb);
+    vector<double> bondLength(nb, 0.0), cosAngle(nb, 1.0), sinAngle(nb, 0.0),
+            cosTorsion(nb, 1.0), sinTorsion(nb, 0.0), torsion(nb, 999.0);
+    for (unsigned int k = 0; k < nb; k++)
+        oldPos[k] = newPos[k] = backbone[k]->coords;
+
+    for (unsigned int k = 3; k < nb; k++) {
+        if (start[k / 3])
+            continue;
+        vgVector3<double> bc = (oldPos[k - 1] - oldPos[k - 2]).normalize();
+        vgVector3<double> nrm =
+                ((oldPos[k - 2] - oldPos[k - 3]).cross(bc)).normalize();
+        vgVector3<double> m = nrm.cross(bc);
+        vgVector3<double> v = oldPos[k] - oldPos[k - 1];
+        double x = v * m;
+        double y = v * nrm;
+        double r = sqrt(x * x + y * y);
+
+        bondLength[k] = v.length();
+        cosAngle[k] = -(v * bc) / bondLength[k];
+        sinAngle[k] = r / bondLength[k];
+        if (r > 0.0) {
+            cosTorsion[k] = x / r;
+            sinTorsion[k] = y / r;
+        }
+
+        unsigned int i = k / 3;
+        switch (k % 3) {
+            case 0: torsion[k] = psi[i - 1];
+                break;
+            case 1: torsion[k] = omega[i - 1];
+                break;
+            default: torsion[k] = phi[i];
+        }
+    }
+
+    for (unsigned int k = 3; k < nb; k++)
+        if (torsion[k] < 990) {
+            cosTorsion[k] = cos(DEG2RAD * torsion[k]);
+            sinTorsion[k] = sin(DEG2RAD * torsion[k]);
+        }
+
+    // rebuild each connected segment from its first residue:
+    for (unsigned int i = 0; i < n;) {
+        unsigned int end = i + 1;
+        while ((end < n) && !start[end])
+            end++;
+        unsigned int k = 3 * i + 3;
+        sPlace(newPos[k - 3], newPos[k - 2], newPos[k - 1], &bondLength[k],
+                &cosAngle[k], &sinAngle[k], &cosTorsion[k], &sinTorsion[k],
+                3 * end - k, &newPos[k]);
+        i = end;
+    }
+
+    // move all other atoms rigidly with their frame (N, CA or C):
+    vector<Atom*> atoms;
+    vector<vgVector3<double> > coords;
+    atoms.reserve(8 * n);
+    coords.reserve(8 * n);
+    for (unsigned int i = 0; i < n; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        unsigned int k = 3 * i;
+        unsigned int frame[3][3] = {
+            {k, k + 1, k + 2},
+            {k, k + 1, k + 2},
+            {k, k + 1, k + 2}
+        };
+        if (!start[i]) {
+            frame[0][0] = k - 1;
+            frame[0][1] = k;
+            frame[0][2] = k + 1;
+        }
+        if ((i + 1 < n) && !start[i + 1]) {
+            frame[2][0] = k + 1;
+            frame[2][1] = k + 2;
+            frame[2][2] = k + 3;
+        }
+
+        vgVector3<double> oldE[3][3], newE[3][3];
+        for (unsigned int f = 0; f < 3; f++) {
+            sFrame(oldPos[frame[f][0]], oldPos[frame[f][1]],
+                    oldPos[frame[f][2]], oldE[f]);
+            sFrame(newPos[frame[f][0]], newPos[frame[f][1]],
+                    newPos[frame[f][2]], newE[f]);
+        }
+
+        for (unsigned int g = 0; g < 2; g++) {
+            Group& gr = (g == 0) ? static_cast<Group&> (aa)
+                    : static_cast<Group&> (aa.getSideChain());
+            for (unsigned int j = 0; j < gr.size(); j++) {
+                Atom& at = gr[j];
+                if ((&at == backbone[k]) || (&at == backbone[k + 1])
+                        || (&at == backbone[k + 2]))
+                    continue;
+
+                const Atom* parent = at.sizeInBonds() ? &at.getInBond(0) : NULL;
+                unsigned int f = 1;
+                if (parent == backbone[k])
+                    f = 0;
+                else if (parent == backbone[k + 2])
+                    f = 2;
+
+                vgVector3<double> d = at.coords - oldPos[frame[f][1]];
+                atoms.push_back(&at);
+                coords.push_back(newPos[frame[f][1]]
+                        + (d * oldE[f][0]) * newE[f][0]
+                        + (d * oldE[f][1]) * newE[f][1]
+                        + (d * oldE[f][2]) * newE[f][2]);
+            }
+        }
+    }
+    atoms.insert(atoms.end(), backbone.begin(), backbone.end());
+    coords.insert(coords.end(), newPos.begin(), newPos.end());
+
+    // write back: coords first, then trans relative to the new parents, so
+    // that the atoms are in sync without replaying the bond tree
+    vgMatrix3<double> identity(1);
+    for (unsigned int i = 0; i < atoms.size(); i++)
+        atoms[i]->coords = coords[i];
+    for (unsigned int i = 0; i < atoms.size(); i++) {
+        Atom& at = *atoms[i];
+        if (at.isNotFirstAtomInStructure())
+            at.trans = at.coords - at.getInBond(0).coords;
+        else if (at.hasSuperior())
+            at.trans = at.coords - at.getSuperior().getTrans();
+        else
+            at.trans = at.coords;
+        at.rot = identity;
+        at.modified = false;
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        if (phi[i] < 990)
+            aa.phi = sWrap(phi[i]);
+        if (psi[i] < 990)
+            aa.psi = sWrap(psi[i]);
+        if (omega[i] < 990)
+            aa.omega = sWrap(omega[i]);
+    }
+    sp.setModified(); // only updates the boundaries
+    sp.sync();
+}
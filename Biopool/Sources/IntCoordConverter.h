@@ -27,6 +27,7 @@
 namespace Victor { namespace Biopool { 
     
     class AminoAcid;
+    class Spacer;
 
 
 
@@ -78,6 +79,14 @@ namespace Victor { namespace Biopool {
         void zAtomToCartesian(Atom& atbLP, const double bondLength, Atom& atbAP,
                 const double bondAngle, Atom& attAP,
                 const double torsionAngle, const int chiral, Atom& at);
+        void setTorsionAngles(Spacer& sp, const vector<double>& phi,
+                const vector<double>& psi, const vector<double>& omega);
+
+        static void placeChain(const vgVector3<double>& a,
+                const vgVector3<double>& b, const vgVector3<double>& c,
+                const double* bondLength, const double* bondAngle,
+                const double* torsionAngle, unsigned int n,
+                vgVector3<double>* out);
 
         // OPERATORS:
 
@@ -0,0 +1,976 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <MmcifLoader.h>
+#include <PdbLoader.h>
+#include <IoTools.h>
+#include <vector3.h>
+#include <AtomCode.h>
+#include <AminoAcid.h>
+#include <String2Number.h>
+#include <Ligand.h>
+#include <Nucleotide.h>
+#include <AminoAcidHydrogen.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <ctype.h>
+#include <string.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+static const unsigned int BUFFER_SIZE = 65536;
+
+/// True if the value is the text s.
+static bool equals(const char* text, unsigned int length, const char* s) {
+    return (strlen(s) == length) && (strncmp(text, s, length) == 0);
+}
+
+// -----------------------------------------------------------------------
+//                          MmcifLoader::Reader
+// -----------------x-------------------x-------------------x-------------
+
+/**
+ *   Buffered line source over the input stream. A gzip compressed stream
+ *   (recognised by its magic number) is inflated a block at a time.
+ */
+class MmcifLoader::Reader {
+public:
+    Reader(istream& _input);
+    ~Reader();
+    bool getLine(string& line);
+
+private:
+    bool fill();
+
+    istream& input;
+    vector<char> data; // decoded characters
+    vector<char> raw; // compressed characters
+    unsigned int pos; // next character of data
+    unsigned int end; // size of data
+    bool gzip;
+#ifdef HAVE_ZLIB
+    z_stream zs;
+#endif
+};
+
+MmcifLoader::Reader::Reader(istream& _input) : input(_input), data(BUFFER_SIZE),
+raw(BUFFER_SIZE), pos(0), end(0), gzip(false) {
+    input.clear(); // reset file to previous content
+    input.seekg(0);
+
+    input.read(&raw[0], BUFFER_SIZE);
+    unsigned int size = input.gcount();
+    gzip = (size >= 2) && (static_cast<unsigned char> (raw[0]) == 0x1f)
+            && (static_cast<unsigned char> (raw[1]) == 0x8b);
+
+    if (!gzip) {
+        data.swap(raw);
+        end = size;
+        return;
+    }
+#ifdef HAVE_ZLIB
+    zs.zalloc = Z_NULL;
+    zs.zfree = Z_NULL;
+    zs.opaque = Z_NULL;
+    zs.next_in = reinterpret_cast<Bytef*> (&raw[0]);
+    zs.avail_in = size;
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) // 32: gzip header
+        ERROR("Cannot initialize gzip decompression.", exception);
+#else
+    ERROR("gzip input needs zlib: rebuild without nozlib=1.", exception);
+#endif
+}
+
+MmcifLoader::Reader::~Reader() {
+#ifdef HAVE_ZLIB
+    if (gzip)
+        inflateEnd(&zs);
+#endif
+}
+
+/**
+ *   Refills the buffer of decoded characters.
+ * @return false at end of input
+ */
+bool
+MmcifLoader::Reader::fill() {
+    pos = 0;
+    end = 0;
+    if (!gzip) {
+        input.read(&data[0], BUFFER_SIZE);
+        end = input.gcount();
+        return end > 0;
+    }
+#ifdef HAVE_ZLIB
+    while (end == 0) {
+        if (zs.avail_in == 0) {
+            input.read(&raw[0], BUFFER_SIZE);
+            if (input.gcount() == 0)
+                return false;
+            zs.next_in = reinterpret_cast<Bytef*> (&raw[0]);
+            zs.avail_in = input.gcount();
+        }
+        zs.next_out = reinterpret_cast<Bytef*> (&data[0]);
+        zs.avail_out = BUFFER_SIZE;
+        int ret = inflate(&zs, Z_NO_FLUSH);
+        end = BUFFER_SIZE - zs.avail_out;
+        if (ret == Z_STREAM_END) // concatenated gzip members may follow
+            inflateReset(&zs);
+        else if ((ret != Z_OK) && (ret != Z_BUF_ERROR))
+            ERROR("Corrupt gzip input.", exception);
+    }
+#endif
+    return true;
+}
+
+/**
+ *   Appends the next line, without its end of line, to line.
+ * @param line (string&)
+ * @return false at end of input
+ */
+bool
+MmcifLoader::Reader::getLine(string& line) {
+    string::size_type start = line.size();
+    bool found = false;
+    for (;;) {
+        if ((pos == end) && !fill())
+            break;
+        found = true;
+        const char* first = &data[pos];
+        const char* last = static_cast<const char*> (memchr(first, '\n', end - pos));
+        if (last != NULL) {
+            line.append(first, last - first);
+            pos += last - first + 1;
+            break;
+        }
+        line.append(first, end - pos);
+        pos = end;
+    }
+    if ((line.size() > start) && (line[line.size() - 1] == '\r'))
+        line.resize(line.size() - 1);
+    return found;
+}
+
+/**
+ *   A token of a line: offsets into the line buffer, which may grow.
+ */
+struct MmcifLoader::Token {
+    string::size_type start;
+    unsigned int length;
+    bool quoted;
+    bool null; // unquoted '.' or '?'
+};
+
+/**
+ *   Consecutive "_category.item value" pairs, passed on as a table of
+ *   one row.
+ */
+struct MmcifLoader::Pairs {
+
+    bool flush(Handler& h) {
+        if (items.empty())
+            return true;
+        row.resize(values.size());
+        for (unsigned int j = 0; j < values.size(); j++) {
+            row[j].text = values[j].data();
+            row[j].length = values[j].size();
+            row[j].null = null[j];
+        }
+        h.columns(category, items);
+        items.clear();
+        values.clear();
+        null.clear();
+        return h.row(&row[0]);
+    }
+
+    string category;
+    vector<string> items;
+    vector<string> values;
+    vector<bool> null;
+    vector<Value> row;
+};
+
+// -----------------------------------------------------------------------
+//                          MmcifLoader::AtomSite
+// -----------------x-------------------x-------------------x-------------
+
+/**
+ *   Column of each _atom_site item used, -1 if missing. Author (PDB)
+ *   numbering and names are preferred over the label ones.
+ */
+class MmcifLoader::AtomSite {
+public:
+
+    enum Item {
+        GROUP, ID, ATOM, ALT, COMP, CHAIN, SEQ, INS, X, Y, Z, BFAC, MODEL, ITEMS
+    };
+
+    void setColumns(const vector<string>& items) {
+        static const char* preferred[ITEMS] = {"group_PDB", "id", "auth_atom_id",
+            "label_alt_id", "auth_comp_id", "auth_asym_id", "auth_seq_id",
+            "pdbx_PDB_ins_code", "Cartn_x", "Cartn_y", "Cartn_z",
+            "B_iso_or_equiv", "pdbx_PDB_model_num"};
+        static const char* fallback[ITEMS] = {"", "", "label_atom_id", "", "label_comp_id",
+            "label_asym_id", "label_seq_id", "", "", "", "", "", ""};
+
+        for (unsigned int i = 0; i < ITEMS; i++) {
+            col[i] = find(items, preferred[i]);
+            if (col[i] < 0)
+                col[i] = find(items, fallback[i]);
+        }
+        if ((col[ATOM] < 0) || (col[COMP] < 0) || (col[CHAIN] < 0) || (col[SEQ] < 0)
+                || (col[X] < 0) || (col[Y] < 0) || (col[Z] < 0))
+            ERROR("mmCIF _atom_site lacks atom, residue, chain or coordinate items.", exception);
+    }
+
+    bool has(Item i) const {
+        return col[i] >= 0;
+    }
+
+    const Value& get(const Value* values, Item i) const {
+        return values[col[i]];
+    }
+
+    static int find(const vector<string>& items, const char* name) {
+        for (unsigned int i = 0; i < items.size(); i++)
+            if (items[i] == name)
+                return i;
+        return -1;
+    }
+
+    int col[ITEMS];
+};
+
+/**
+ *   Residues and ligands of one chain, collected while parsing.
+ */
+struct MmcifLoader::ChainData {
+
+    ChainData() : sp(new Spacer()), ls(new LigandSet()), aa(new AminoAcid()),
+    lig(new Ligand()), oldAaNum(-100000) {
+    }
+
+    Spacer* sp;
+    LigandSet* ls;
+    AminoAcid* aa; // residue being read
+    Ligand* lig; // ligand being read
+    int oldAaNum; // number of the residue being read
+};
+
+// -----------------------------------------------------------------------
+//                          MmcifLoader handlers
+// -----------------x-------------------x-------------------x-------------
+
+/**
+ *   Lists the chains with ATOM records of the first model, in order.
+ */
+class MmcifLoader::ChainCollector : public MmcifLoader::Handler {
+public:
+
+    ChainCollector() : atoms(false), firstModel(-1) {
+    }
+
+    virtual void columns(const string& category, const vector<string>& items) {
+        atoms = (category == "_atom_site");
+        if (atoms)
+            site.setColumns(items);
+    }
+
+    virtual bool row(const Value* values) {
+        if (!atoms)
+            return true;
+        if (site.has(AtomSite::MODEL)) {
+            const Value& m = site.get(values, AtomSite::MODEL);
+            int num = stoiDEF(m.text, m.length);
+            if (firstModel < 0)
+                firstModel = num;
+            if (num != firstModel)
+                return false; // only consider first model: others duplicate chain IDs
+        }
+        if (site.has(AtomSite::GROUP)
+                && !equals(site.get(values, AtomSite::GROUP).text,
+                site.get(values, AtomSite::GROUP).length, "ATOM"))
+            return true;
+        const Value& c = site.get(values, AtomSite::CHAIN);
+        if ((chains.size() == 0) || (chains.back().compare(0, string::npos, c.text, c.length) != 0))
+            chains.push_back(string(c.text, c.length));
+        return true;
+    }
+
+    AtomSite site;
+    bool atoms;
+    int firstModel;
+    vector<string> chains;
+};
+
+/**
+ *   Counts the models of the _atom_site table.
+ */
+class MmcifLoader::ModelCounter : public MmcifLoader::Handler {
+public:
+
+    ModelCounter() : atoms(false), last(-1) {
+    }
+
+    virtual void columns(const string& category, const vector<string>& items) {
+        atoms = (category == "_atom_site");
+        if (atoms)
+            site.setColumns(items);
+    }
+
+    virtual bool row(const Value* values) {
+        if (!atoms)
+            return true;
+        int num = 1;
+        if (site.has(AtomSite::MODEL)) {
+            const Value& m = site.get(values, AtomSite::MODEL);
+            num = stoiDEF(m.text, m.length);
+        }
+        if (num != last) {
+            models.insert(num);
+            last = num;
+        }
+        return true;
+    }
+
+    AtomSite site;
+    bool atoms;
+    int last;
+    set<int> models;
+};
+
+/**
+ *   Collects the atoms of the selected chains and model, and the
+ *   secondary structure ranges.
+ */
+class MmcifLoader::ProteinHandler : public MmcifLoader::Handler {
+public:
+
+    enum Table {
+        OTHER, ATOMS, HELICES, STRANDS
+    };
+
+    ProteinHandler(MmcifLoader& _loader) : loader(_loader), table(OTHER),
+    last(NULL), firstModel(-1), loading(false) {
+    }
+
+    ~ProteinHandler() {
+        // chains parsed before the default chain was known
+        for (map<string, ChainData*>::iterator it = chains.begin(); it != chains.end(); ++it)
+            if (it->second != NULL) {
+                delete it->second->aa;
+                delete it->second->lig;
+                delete it->second->sp;
+                delete it->second->ls;
+                delete it->second;
+            }
+    }
+
+    virtual void block(const string& _name) {
+        if (name == "")
+            name = _name;
+    }
+
+    virtual void columns(const string& category, const vector<string>& items) {
+        table = OTHER;
+        if (category == "_atom_site") {
+            table = ATOMS;
+            site.setColumns(items);
+        } else if ((category == "_struct_conf") || (category == "_struct_sheet_range")) {
+            table = (category == "_struct_conf") ? HELICES : STRANDS;
+            type = AtomSite::find(items, "conf_type_id");
+            chain = AtomSite::find(items, "beg_auth_asym_id");
+            if (chain < 0)
+                chain = AtomSite::find(items, "beg_label_asym_id");
+            start = AtomSite::find(items, "beg_auth_seq_id");
+            if (start < 0)
+                start = AtomSite::find(items, "beg_label_seq_id");
+            end = AtomSite::find(items, "end_auth_seq_id");
+            if (end < 0)
+                end = AtomSite::find(items, "end_label_seq_id");
+            if ((chain < 0) || (start < 0) || (end < 0))
+                table = OTHER;
+        }
+    }
+
+    virtual bool row(const Value* values) {
+        switch (table) {
+            case ATOMS:
+                return atom(values);
+            case HELICES:
+                if ((type >= 0) && (strncmp(values[type].text, "HELX", 4) != 0))
+                    return true; // turns
+            case STRANDS:
+                if (values[start].null || values[end].null)
+                    return true;
+                if (table == HELICES) {
+                    loader.helixData.push_back(pair<int, int>(
+                            stoiDEF(values[start].text, values[start].length),
+                            stoiDEF(values[end].text, values[end].length)));
+                    loader.helixChain.push_back(string(values[chain].text, values[chain].length));
+                } else {
+                    loader.sheetData.push_back(pair<int, int>(
+                            stoiDEF(values[start].text, values[start].length),
+                            stoiDEF(values[end].text, values[end].length)));
+                    loader.sheetChain.push_back(string(values[chain].text, values[chain].length));
+                }
+                return true;
+            default:
+                return true;
+        }
+    }
+
+    /// One _atom_site row; stops the scan after the selected model.
+    bool atom(const Value* values) {
+        int num = 1;
+        if (site.has(AtomSite::MODEL)) {
+            const Value& m = site.get(values, AtomSite::MODEL);
+            num = stoiDEF(m.text, m.length);
+        }
+        if (firstModel < 0)
+            firstModel = num;
+
+        const Value& c = site.get(values, AtomSite::CHAIN);
+        bool atomRecord = !site.has(AtomSite::GROUP)
+                || equals(site.get(values, AtomSite::GROUP).text,
+                site.get(values, AtomSite::GROUP).length, "ATOM");
+        if ((num == firstModel) && atomRecord && ((chainList.size() == 0)
+                || (chainList.back().compare(0, string::npos, c.text, c.length) != 0))) {
+            chainList.push_back(string(c.text, c.length));
+            if ((!loader.allChains) && (loader.chain == ""))
+                loader.chain = chainList.back();
+        }
+
+        // Get only the first model if not specified
+        if (loader.model == 999)
+            loader.model = num;
+        if (static_cast<unsigned int> (num) != loader.model)
+            return !loading;
+        loading = true;
+
+        // only the selected chain is parsed when it is known, otherwise
+        // every chain is parsed until the first ATOM record names it
+        if ((!loader.allChains) && (loader.chain != "")
+                && (loader.chain.compare(0, string::npos, c.text, c.length) != 0))
+            return true;
+
+        if ((last == NULL) || (lastName.compare(0, string::npos, c.text, c.length) != 0)) {
+            lastName.assign(c.text, c.length);
+            ChainData*& data = chains[lastName];
+            if (data == NULL)
+                data = new ChainData();
+            last = data;
+        }
+
+        const Value& s = site.get(values, AtomSite::SEQ);
+        int aaNum = s.null ? 0 : stoiDEF(s.text, s.length);
+
+        // Insert the previous residue and ligand
+        if (aaNum != last->oldAaNum) {
+            loader.insertResidue(*last);
+            last->aa = new AminoAcid();
+            last->lig = new Ligand();
+        }
+        last->oldAaNum = aaNum;
+        loader.addAtom(*last, site, values);
+        return true;
+    }
+
+    MmcifLoader& loader;
+    Table table;
+    AtomSite site;
+    int type, chain, start, end; // columns of the secondary structure tables
+
+    string name; // data block
+    vector<string> chainList; // chains of the first model, in order of appearance
+    map<string, ChainData*> chains;
+    ChainData* last; // chain of the previous row
+    string lastName;
+    int firstModel;
+    bool loading; // rows of the selected model are being read
+};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+// PREDICATES:
+
+/**
+ *  Returns the number of models in the file.
+ *@param none
+ */
+unsigned int
+MmcifLoader::getMaxModels() {
+    ModelCounter counter;
+    scan(counter);
+    return counter.models.size();
+}
+
+/**
+ *    Returns all available chain IDs for a mmCIF file.
+ *
+ *@param   void
+ *@return  vector of strings
+ */
+vector<string>
+MmcifLoader::getAllChains() {
+    ChainCollector collector;
+    scan(collector);
+    return collector.chains;
+}
+
+// MODIFIERS:
+
+void
+MmcifLoader::setOnlyMetalHetAtoms() {
+    if (noHetAtoms) {
+        ERROR("can't load metal ions if hetAtoms option is disabled", exception);
+    }
+
+    onlyMetalHetAtoms = true;
+    noWater = true;
+}
+
+void
+MmcifLoader::setWater() {
+    if (noHetAtoms || onlyMetalHetAtoms) {
+        ERROR("can't load water if hetAtoms option is disabled\nor onlyMetalHetAtoms is enabled", exception);
+    }
+    noWater = false;
+}
+
+/**
+ *   Core function for mmCIF file parsing. Chains are loaded as
+ *   PdbLoader::loadProtein() does, named after their author chain ID.
+ * @param prot (Protein&)
+ */
+void
+MmcifLoader::loadProtein(Protein& prot) {
+
+    PRINT_NAME;
+
+    helixChain.clear();
+    sheetChain.clear();
+    helixData.clear();
+    sheetData.clear();
+
+    if (!noHAtoms)
+        AminoAcidHydrogen::loadDefaultParam();
+
+    ProteinHandler handler(*this);
+    scan(handler);
+
+    vector<string>& chainList = handler.chainList;
+    if (chainList.size() == 0) {
+        if (verbose)
+            cout << "Warning: Missing chain ID in the mmCIF, assuming the same chain for the entire file.\n";
+        chainList.push_back(handler.lastName);
+    }
+
+    for (unsigned int i = 0; i < chainList.size(); i++) {
+        bool loadChain = false;
+        if (allChains) {
+            // chains interrupted by other chains are listed again
+            loadChain = (find(chainList.begin(), chainList.begin() + i,
+                    chainList[i]) == chainList.begin() + i);
+        } else
+            loadChain = (chainList[i] == chain)
+            && (find(chainList.begin(), chainList.begin() + i,
+                chainList[i]) == chainList.begin() + i);
+
+        if (loadChain) {
+            ChainData*& data = handler.chains[chainList[i]];
+            if (data == NULL)
+                data = new ChainData();
+            finishChain(*data, chainList[i], handler.name, prot);
+            delete data;
+            data = NULL;
+        }
+    }
+}
+
+// HELPERS:
+
+/**
+ *   Tokenizes the input and passes its tables to h. A loop gives one
+ *   row per group of values; consecutive "_category.item value" pairs of
+ *   the same category give a table of one row. Values of loop rows point
+ *   into the line buffer, which is only grown when a row spans lines.
+ * @param h (Handler&)
+ */
+void
+MmcifLoader::scan(Handler& h) {
+
+    Pairs pairs; // consecutive "_category.item value" pairs
+
+    Reader reader(input);
+    string buffer; // current line, after the ones of an unfinished row
+    vector<Token> lineTokens;
+    vector<Token> tokens; // values of the unfinished loop row
+    vector<Value> values;
+
+    bool header = false; // reading the items of a loop
+    bool inLoop = false; // reading the rows of a loop
+    string category;
+    vector<string> items;
+
+    bool more = true;
+    while (more) {
+        if (tokens.empty())
+            buffer.clear();
+        else
+            buffer += '\n';
+        string::size_type i = buffer.size();
+        if (!reader.getLine(buffer))
+            break;
+
+        lineTokens.clear();
+        if ((i < buffer.size()) && (buffer[i] == ';')) {
+            // text field, up to the next line starting with ';'
+            Token t = {i + 1, 0, true, false};
+            string::size_type next;
+            for (;;) {
+                buffer += '\n';
+                next = buffer.size();
+                if (!reader.getLine(buffer))
+                    ERROR("Unterminated text field in mmCIF input.", exception);
+                if ((next < buffer.size()) && (buffer[next] == ';'))
+                    break;
+            }
+            t.length = next - 1 - t.start;
+            lineTokens.push_back(t);
+            i = next + 1;
+        }
+
+        // split the line
+        while (i < buffer.size()) {
+            while ((i < buffer.size()) && isspace(buffer[i]))
+                i++;
+            if ((i >= buffer.size()) || (buffer[i] == '#'))
+                break;
+            Token t = {i, 0, false, false};
+            if ((buffer[i] == '\'') || (buffer[i] == '"')) {
+                // a quote closes the value only if followed by white space
+                char q = buffer[i];
+                t.start = ++i;
+                while ((i < buffer.size()) && !((buffer[i] == q)
+                        && ((i + 1 == buffer.size()) || isspace(buffer[i + 1]))))
+                    i++;
+                t.length = i - t.start;
+                t.quoted = true;
+                i++;
+            } else {
+                while ((i < buffer.size()) && !isspace(buffer[i]))
+                    i++;
+                t.length = i - t.start;
+                t.null = (t.length == 1) && ((buffer[t.start] == '.') || (buffer[t.start] == '?'));
+            }
+            lineTokens.push_back(t);
+        }
+
+        for (unsigned int k = 0; more && (k < lineTokens.size()); k++) {
+            const Token& t = lineTokens[k];
+            const char* text = buffer.data() + t.start;
+            bool pairPending = (pairs.values.size() < pairs.items.size());
+
+            if (!t.quoted && (text[0] == '_')) {
+                if (pairPending)
+                    ERROR("mmCIF item without value: " + pairs.items.back(), exception);
+                if (!tokens.empty())
+                    ERROR("Incomplete mmCIF loop row in " + category, exception);
+                const char* dot = static_cast<const char*> (memchr(text, '.', t.length));
+                unsigned int n = (dot == NULL) ? t.length : dot - text;
+                string cat(text, n);
+                string item = (dot == NULL) ? "" : string(dot + 1, t.length - n - 1);
+                if (header) {
+                    if (items.empty())
+                        category = cat;
+                    items.push_back(item);
+                    continue;
+                }
+                inLoop = false;
+                if (cat != pairs.category)
+                    more = pairs.flush(h);
+                pairs.category = cat;
+                pairs.items.push_back(item);
+                continue;
+            }
+
+            if (!t.quoted && (t.length >= 5) && ((strncasecmp(text, "loop_", 5) == 0)
+                    || (strncasecmp(text, "data_", 5) == 0))) {
+                if (pairPending)
+                    ERROR("mmCIF item without value: " + pairs.items.back(), exception);
+                if (!tokens.empty())
+                    ERROR("Incomplete mmCIF loop row in " + category, exception);
+                more = pairs.flush(h);
+                inLoop = false;
+                header = (tolower(text[0]) == 'l');
+                items.clear();
+                if (!header)
+                    h.block(string(text + 5, t.length - 5));
+                continue;
+            }
+
+            if (pairPending) {
+                pairs.values.push_back(string(text, t.length));
+                pairs.null.push_back(t.null);
+                continue;
+            }
+            if (header) {
+                if (items.empty())
+                    ERROR("mmCIF loop without items.", exception);
+                header = false;
+                inLoop = true;
+                h.columns(category, items);
+            }
+            if (!inLoop)
+                ERROR("Unexpected mmCIF value: " + string(text, t.length), exception);
+
+            tokens.push_back(t);
+            if (tokens.size() == items.size()) {
+                values.resize(tokens.size());
+                for (unsigned int j = 0; j < tokens.size(); j++) {
+                    values[j].text = buffer.data() + tokens[j].start;
+                    values[j].length = tokens[j].length;
+                    values[j].null = tokens[j].null;
+                }
+                more = h.row(&values[0]);
+                tokens.clear();
+            }
+        }
+    }
+
+    if (more && (pairs.values.size() == pairs.items.size()))
+        pairs.flush(h);
+}
+
+/**
+ *    Assigns the secondary structure from _struct_conf and
+ *  _struct_sheet_range. If not present uses Spacer's
+ *  setStateFromTorsionAngles().
+ *@param   Spacer reference
+ *@param   chainName (const string&)
+ */
+void
+MmcifLoader::assignSecondary(Spacer& sp, const string& chainName) {
+    if (helixData.size() + sheetData.size() == 0) {
+        sp.setStateFromTorsionAngles();
+        return;
+    }
+
+    for (unsigned int i = 0; i < helixData.size(); i++)
+        if (helixChain[i] == chainName)
+            for (int j = helixData[i].first; j <= helixData[i].second; j++) {
+                // important: keep ifs separated to avoid errors
+                if (j < sp.maxPdbNumber())
+                    if (!sp.isGap(sp.getIndexFromPdbNumber(j)))
+                        sp.getAmino(sp.getIndexFromPdbNumber(j)).setState(HELIX);
+            }
+
+    for (unsigned int i = 0; i < sheetData.size(); i++)
+        if (sheetChain[i] == chainName)
+            for (int j = sheetData[i].first; j <= sheetData[i].second; j++) {
+                // important: keep ifs separated to avoid errors
+                if (j < sp.maxPdbNumber())
+                    if (!sp.isGap(sp.getIndexFromPdbNumber(j)))
+                        sp.getAmino(sp.getIndexFromPdbNumber(j)).setState(STRAND);
+            }
+}
+
+/**
+ *   Adds the atom of an _atom_site row to the residue or ligand being
+ *   read, as PdbLoader::parsePDBline() does for a PDB line.
+ * @param data (ChainData&)
+ * @param site (const AtomSite&) columns of the row
+ * @param values (const Value*) the row
+ */
+void
+MmcifLoader::addAtom(ChainData& data, const AtomSite& site, const Value* values) {
+    // skip alternative locations other than the selected one
+    if (site.has(AtomSite::ALT)) {
+        const Value& alt = site.get(values, AtomSite::ALT);
+        if (!alt.null && (alt.text[0] != altAtom))
+            return;
+    }
+
+    const Value& x = site.get(values, AtomSite::X);
+    const Value& y = site.get(values, AtomSite::Y);
+    const Value& z = site.get(values, AtomSite::Z);
+    vgVector3<double> coord;
+    coord.x = stodDEF(x.text, x.length);
+    coord.y = stodDEF(y.text, y.length);
+    coord.z = stodDEF(z.text, z.length);
+
+    int atNum = 0;
+    if (site.has(AtomSite::ID))
+        atNum = stoiDEF(site.get(values, AtomSite::ID).text, site.get(values, AtomSite::ID).length);
+    double bfac = 0.0;
+    if (site.has(AtomSite::BFAC) && !site.get(values, AtomSite::BFAC).null)
+        bfac = stodDEF(site.get(values, AtomSite::BFAC).text, site.get(values, AtomSite::BFAC).length);
+
+    const Value& atom = site.get(values, AtomSite::ATOM);
+    const Value& comp = site.get(values, AtomSite::COMP);
+    string atType(atom.text, atom.length);
+    string aaType(comp.text, comp.length);
+    // take care of deuterium atoms
+    if (atType == "D")
+        atType = "H";
+
+    bool hetAtom = site.has(AtomSite::GROUP)
+            && equals(site.get(values, AtomSite::GROUP).text,
+            site.get(values, AtomSite::GROUP).length, "HETATM");
+
+    Atom at;
+    at.setNumber(atNum);
+    at.setType(atType);
+    at.setCoords(coord);
+    at.setBFac(bfac);
+
+    // Ligand object (includes DNA/RNA in "ATOM" records)
+    if (hetAtom || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
+        if ((!noWater) || (aaType != "HOH")) {
+            data.lig->addAtom(at);
+            data.lig->setType(aaType);
+        }
+    }        // AminoAcid
+    else if (aaType == "ACE") { // skip N-terminal ACE groups
+        if (verbose)
+            cout << "Warning: Skipping N-terminal ACE group " << data.oldAaNum << " " << atNum << ".\n";
+    } else if (site.has(AtomSite::INS) && !site.get(values, AtomSite::INS).null) {
+        // skip inserted residues
+        if (verbose)
+            cout << "Warning: Skipping extraneous amino acid entry " << data.oldAaNum << " " << atNum << " "
+                << string(site.get(values, AtomSite::INS).text, site.get(values, AtomSite::INS).length) << ".\n";
+    } else {
+        data.aa->setType(aaType);
+        data.aa->getSideChain().setType(aaType);
+
+        if (!noHAtoms || isHeavyAtom(at.getCode())) {
+            if (!PdbLoader::inSideChain(*data.aa, at))
+                data.aa->addAtom(at);
+            else
+                data.aa->getSideChain().addAtom(at);
+        }
+    }
+}
+
+/**
+ *   Inserts the residue and the ligand being read into the chain, or
+ *   deletes them if empty or not loaded.
+ * @param data (ChainData&)
+ */
+void
+MmcifLoader::insertResidue(ChainData& data) {
+    Spacer* sp = data.sp;
+    AminoAcid* aa = data.aa;
+    Ligand* lig = data.lig;
+    data.aa = NULL;
+    data.lig = NULL;
+
+    // Skip the first empty AminoAcid
+    if ((aa != NULL) && (aa->size() > 0) && (aa->getType1L() != 'X')) {
+        if (sp->sizeAmino() == 0) {
+            sp->setStartOffset(data.oldAaNum - 1);
+        } else {
+            // Add gaps
+            for (int i = sp->maxPdbNumber() + 1; i < data.oldAaNum; i++) {
+                sp->addGap(i);
+            }
+        }
+        sp->insertComponent(aa);
+    } else
+        delete aa;
+
+    // Ligand
+    if ((lig != NULL) && (lig->size() > 0)
+            && ((!onlyMetalHetAtoms) || (lig->isSimpleMetalIon()))) { // skip not metal ions
+        data.ls->insertComponent(lig);
+    } else
+        delete lig;
+}
+
+/**
+ *   Completes the Spacer of a chain with PdbLoader::completeChain(),
+ *   assigns its secondary structure and adds it to the protein together
+ *   with its LigandSet.
+ * @param data (ChainData&) the chain, emptied
+ * @param chainName (const string&)
+ * @param name (const string&) Spacer type
+ * @param prot (Protein&)
+ */
+void
+MmcifLoader::finishChain(ChainData& data, const string& chainName,
+        const string& name, Protein& prot) {
+
+    if (verbose)
+        cout << "\nLoading chain: ->" << chainName << "<-\n";
+
+    // last residue/ligand
+    insertResidue(data);
+
+    Spacer* sp = data.sp;
+    LigandSet* ls = data.ls;
+    data.sp = NULL;
+    data.ls = NULL;
+    if (name != "")
+        sp->setType(name);
+
+    if (verbose)
+        cout << "Parsing done\n";
+
+    ////////////////////////////////////////////////////////////////////
+    // Spacer processing
+    if (!PdbLoader::completeChain(*sp, chainName, noConnection, noHAtoms,
+            noSecondary, verbose))
+        valid = false;
+
+    // assign secondary structure from torsion angles
+    if ((sp->sizeAmino() > 0) && (!noSecondary)) {
+        assignSecondary(*sp, chainName);
+        if (verbose)
+            cout << "Torsional SS assigned\n";
+    }
+
+    ////////////////////////////////////////////////////////////////////
+    // Load data into protein object
+    Polymer* pol = new Polymer();
+    pol->insertComponent(sp);
+    if (verbose)
+        cout << "Loaded AminoAcids: " << sp->size() << "\n";
+
+    if (!(noHetAtoms)) {
+        if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
+            pol->insertComponent(ls);
+            if (verbose)
+                cout << "Loaded Ligands: " << ls->size() << "\n";
+        } else {
+            if (verbose)
+                cout << "Warning: No ligands in chain: " << chainName << ".\n";
+            delete ls;
+        }
+    } else
+        delete ls;
+
+    prot.addChain(chainName);
+    prot.insertComponent(pol);
+}
@@ -0,0 +1,210 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MMCIF_LOADER_H_
+#define _MMCIF_LOADER_H_
+
+// Includes:
+#include <utility>
+#include <Loader.h>
+#include <AminoAcid.h>
+#include <Spacer.h>
+#include <LigandSet.h>
+#include <Protein.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Loads components (Spacer, LigandSet, Protein) in PDBx/mmCIF format.
+     *
+     *  The _atom_site loop is streamed row by row, so large assemblies
+     *  (more than 99,999 atoms, multi-character chain IDs) can be loaded
+     *  without holding the file in memory. Only the rows of the selected
+     *  chains and model are converted. Gzip compressed input is detected
+     *  and decompressed on the fly when Victor is built with zlib.
+     * */
+    class MmcifLoader : public Loader {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        /**
+         *   Constructor.
+         * @param _input = the mmCIF file object, plain or gzip compressed
+         * @param _permissive = if true, allows loading residues with missing atoms
+         * @param _noHAtoms = if true, doesn't load Hydrogens
+         * @param _noHetAtoms = if true, doesn't load het atoms
+         * @param _noSecondary = if true, doesn't load secondary structure (neither the one calculated from torsional angles nor the DSSP)
+         * @param _noConnection = if true, doesn't connect residues
+         * @param _noWater = if true, doesn't load water atoms
+         * @param _verb = if true, verbose mode
+         * @param _allChains = if true, loads all chains
+         * @param _onlyMetal = if true, load only metals as ligands
+         */
+        MmcifLoader(istream& _input = cin, bool _permissive = false,
+                bool _noHAtoms = false, bool _noHetAtoms = false, bool _noSecondary = false,
+                bool _noConnection = false, bool _noWater = true,
+                bool _verb = true, bool _allChains = false, bool _onlyMetal = false)
+        : input(_input), permissive(_permissive), valid(true),
+        noHAtoms(_noHAtoms), noHetAtoms(_noHetAtoms), onlyMetalHetAtoms(_onlyMetal),
+        noSecondary(_noSecondary), noConnection(_noConnection), noWater(_noWater),
+        verbose(_verb), allChains(_allChains), chain(""), model(999), altAtom('A') {
+        }
+
+        // this class uses the implicit copy operator.
+
+        virtual ~MmcifLoader() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+
+        bool isValid() {
+            return valid;
+        }
+        unsigned int getMaxModels();
+        vector<string> getAllChains();
+
+        // MODIFIERS:
+
+        void setPermissive() {
+            permissive = true;
+        }
+
+        void setNonPermissive() {
+            permissive = false;
+        }
+
+        void setVerbose() {
+            verbose = true;
+        }
+
+        void setNoVerbose() {
+            verbose = false;
+        }
+
+        void setChain(const string& _ch) {
+            chain = _ch;
+        }
+
+        void setModel(unsigned int _mod) {
+            model = _mod;
+        }
+
+        void setAltAtom(char _a) {
+            altAtom = _a;
+        }
+
+        void setNoHAtoms() {
+            noHAtoms = true;
+        }
+
+        void setNoHetAtoms() {
+            noHetAtoms = true;
+        }
+        void setOnlyMetalHetAtoms();
+
+        void setNoSecondary() {
+            noSecondary = true;
+        }
+
+        void setWithSecondary() {
+            noSecondary = false;
+        }
+
+        void setNoConnection() {
+            noConnection = true;
+        }
+
+        void setWithConnection() {
+            noConnection = false;
+        }
+
+        void setWater();
+
+        void setAllChains() {
+            allChains = true;
+        }
+
+        virtual void loadProtein(Protein& prot);
+
+    protected:
+
+        /// A token of the file: points into the reader's buffer.
+        struct Value {
+            const char* text;
+            unsigned int length;
+            bool null; ///< unquoted '.' or '?'
+        };
+
+        /// Receives the tables read by scan().
+        class Handler {
+        public:
+            virtual ~Handler() {
+            }
+            /// A new data block starts.
+            virtual void block(const string& name) {
+            }
+            /// A table of category with the given items starts.
+            virtual void columns(const string& category, const vector<string>& items) = 0;
+            /// One row of the current table; returning false stops the scan.
+            virtual bool row(const Value* values) = 0;
+        };
+
+        class Reader;
+        struct Token;
+        struct Pairs;
+        class AtomSite;
+        class ChainCollector;
+        class ProteinHandler;
+        class ModelCounter;
+        struct ChainData;
+
+        // HELPERS:
+        void scan(Handler& h);
+        void assignSecondary(Spacer& sp, const string& chainName);
+        void addAtom(ChainData& data, const AtomSite& site, const Value* values);
+        void insertResidue(ChainData& data);
+        void finishChain(ChainData& data, const string& chainName,
+                const string& name, Protein& prot);
+
+        // ATTRIBUTES 
+    private:
+        istream& input; //input stream
+        bool permissive; //
+        bool valid; //
+        bool noHAtoms; //
+        bool noHetAtoms; //hetatms contain water, simpleMetalIons and cofactors
+        bool onlyMetalHetAtoms; //with this flag we select only 2nd cathegory
+        bool noSecondary;
+        bool noConnection; //skip connecting aminoacids
+        bool noWater; // 
+        bool verbose;
+        bool allChains; //
+        string chain; //chain ID to be loaded, empty for the first one
+        unsigned int model; //model number to be loaded
+        char altAtom; //ID of alternate atoms to be loaded
+
+        vector<string> helixChain; // chain of each helixData element
+        vector<string> sheetChain;
+
+        vector<pair<int, int> > helixData; //first and last residue
+        vector<pair<int, int> > sheetData;
+
+    };
+
+}} //namespace
+#endif //_MMCIF_LOADER_H_
@@ -0,0 +1,330 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//Includes:
+#include <NeighborGrid.h>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Upper bound on the number of cells, relative to the number of atoms,
+// before the cells are made larger than the cutoff.
+static const unsigned int MAX_CELLS_PER_ATOM = 8;
+static const unsigned int MIN_CELLS = 4096;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Creates an empty grid, to be filled by build().
+ *@param cutoff cell side, i.e. the distance most queries will use
+ *@param filter atoms of each residue to be put in the grid
+ */
+NeighborGrid::NeighborGrid(double cutoff, AtomFilter filter) : cutoff(cutoff),
+filter(filter), cellSize(cutoff) {
+    PRECOND(cutoff > 0.0, exception);
+    dim[0] = dim[1] = dim[2] = 1;
+    head.assign(1, -1);
+    residueStart.push_back(0);
+}
+
+/**
+ *  Creates the grid of the atoms of a spacer.
+ *@param sp spacer
+ *@param cutoff cell side, i.e. the distance most queries will use
+ *@param filter atoms of each residue to be put in the grid
+ */
+NeighborGrid::NeighborGrid(Spacer& sp, double cutoff, AtomFilter filter) :
+cutoff(cutoff), filter(filter), cellSize(cutoff) {
+    PRECOND(cutoff > 0.0, exception);
+    build(sp);
+}
+
+NeighborGrid::~NeighborGrid() {
+    PRINT_NAME;
+}
+
+// PREDICATES:
+
+/**
+ *  Calls the visitor for every pair of atoms closer than r. Each pair is
+ *  reported once, pairs of atoms of the same residue included.
+ *@param r distance (any value, although r <= cutoff is the fastest)
+ *@param visitor callback
+ *@return void
+ */
+void
+NeighborGrid::forEachPairWithin(double r, PairVisitor& visitor) const {
+    const double r2 = r * r;
+    const int span = static_cast<int> (ceil(r / cellSize));
+    const int dx = dim[0], dy = dim[1], dz = dim[2];
+
+    for (unsigned int i = 0; i < atoms.size(); i++) {
+        int cx = cell[i] % dx;
+        int cy = (cell[i] / dx) % dy;
+        int cz = cell[i] / (dx * dy);
+
+        for (int z = max(0, cz - span); z <= min(dz - 1, cz + span); z++)
+            for (int y = max(0, cy - span); y <= min(dy - 1, cy + span); y++)
+                for (int x = max(0, cx - span); x <= min(dx - 1, cx + span); x++)
+                    for (int j = head[(z * dy + y) * dx + x]; j >= 0; j = next[j]) {
+                        if (static_cast<unsigned int> (j) <= i)
+                            continue;
+                        double d2 = (coords[i] - coords[j]).square();
+                        if (d2 <= r2)
+                            visitor.visit(i, j, sqrt(d2));
+                    }
+    }
+}
+
+/**
+ *  Collects the atoms within distance r of a point, in no particular order.
+ *@param pos point
+ *@param r distance (any value, although r <= cutoff is the fastest)
+ *@param result indices of the atoms found
+ *@return void
+ */
+void
+NeighborGrid::neighborsOf(const vgVector3<double>& pos, double r,
+        vector<unsigned int>& result) const {
+    result.clear();
+    const double r2 = r * r;
+    const int span = static_cast<int> (ceil(r / cellSize));
+    const int dx = dim[0], dy = dim[1], dz = dim[2];
+    int cx = pCellIndex(pos.x, 0);
+    int cy = pCellIndex(pos.y, 1);
+    int cz = pCellIndex(pos.z, 2);
+
+    for (int z = max(0, cz - span); z <= min(dz - 1, cz + span); z++)
+        for (int y = max(0, cy - span); y <= min(dy - 1, cy + span); y++)
+            for (int x = max(0, cx - span); x <= min(dx - 1, cx + span); x++)
+                for (int j = head[(z * dy + y) * dx + x]; j >= 0; j = next[j])
+                    if ((pos - coords[j]).square() <= r2)
+                        result.push_back(j);
+}
+
+// MODIFIERS:
+
+/**
+ *  (Re)builds the grid from the atoms of a spacer. The grid covers the
+ *  current bounding box of the atoms; atoms moved outside it by later
+ *  updates are kept in the border cells, which only costs some speed.
+ *@param sp spacer
+ *@return void
+ */
+void
+NeighborGrid::build(Spacer& sp) {
+    atoms.clear();
+    atomResidue.clear();
+    coords.clear();
+    residueStart.clear();
+
+    vector<Atom*> selected;
+    for (unsigned int r = 0; r < sp.sizeAmino(); r++) {
+        residueStart.push_back(atoms.size());
+        selected.clear();
+        selectAtoms(sp.getAmino(r), filter, selected);
+        for (unsigned int k = 0; k < selected.size(); k++)
+            pAdd(*selected[k], r);
+    }
+    residueStart.push_back(atoms.size());
+
+    // bounding box
+    vgVector3<double> lo(0.0, 0.0, 0.0), hi(0.0, 0.0, 0.0);
+    for (unsigned int i = 0; i < coords.size(); i++)
+        for (unsigned int k = 0; k < 3; k++) {
+            if ((i == 0) || (coords[i][k] < lo[k]))
+                lo[k] = coords[i][k];
+            if ((i == 0) || (coords[i][k] > hi[k]))
+                hi[k] = coords[i][k];
+        }
+
+    // very sparse selections in large boxes get cells bigger than cutoff
+    const double maxCells = max(MIN_CELLS,
+            MAX_CELLS_PER_ATOM * static_cast<unsigned int> (atoms.size()));
+    cellSize = cutoff;
+    for (;;) {
+        double n = 1.0;
+        for (unsigned int k = 0; k < 3; k++) {
+            dim[k] = static_cast<unsigned int> ((hi[k] - lo[k]) / cellSize) + 1;
+            n *= dim[k];
+        }
+        if (n <= maxCells)
+            break;
+        cellSize *= 2.0;
+    }
+    origin = lo;
+
+    head.assign(dim[0] * dim[1] * dim[2], -1);
+    next.assign(atoms.size(), -1);
+    prev.assign(atoms.size(), -1);
+    cell.assign(atoms.size(), 0);
+    for (unsigned int i = 0; i < atoms.size(); i++) {
+        cell[i] = pCellOf(coords[i]);
+        pLink(i);
+    }
+}
+
+/**
+ *  Reads again the coordinates of all atoms and moves them to their new
+ *  cells.
+ *@return void
+ */
+void
+NeighborGrid::update() {
+    for (unsigned int i = 0; i < atoms.size(); i++)
+        pUpdateAtom(i);
+}
+
+/**
+ *  Reads again the coordinates of the atoms of residues first to last
+ *  (included), e.g. after a loop has been remodelled.
+ *@param first index of the first residue moved
+ *@param last index of the last residue moved
+ *@return void
+ */
+void
+NeighborGrid::update(unsigned int first, unsigned int last) {
+    PRECOND((first <= last) && (last + 1 < residueStart.size()), exception);
+    for (unsigned int i = residueStart[first]; i < residueStart[last + 1]; i++)
+        pUpdateAtom(i);
+}
+
+/**
+ *  Reads again the coordinates of the atoms of the given residues.
+ *@param residues indices of the residues moved
+ *@return void
+ */
+void
+NeighborGrid::update(const vector<unsigned int>& residues) {
+    for (unsigned int k = 0; k < residues.size(); k++)
+        update(residues[k], residues[k]);
+}
+
+/**
+ *  Appends the atoms of a residue selected by a filter, in the order of
+ *  the residue (backbone, then side chain).
+ *@param aa residue
+ *@param filter atoms to select
+ *@param result selected atoms are appended here
+ *@return void
+ */
+void
+NeighborGrid::selectAtoms(AminoAcid& aa, AtomFilter filter,
+        vector<Atom*>& result) {
+    switch (filter) {
+        case CA_ATOMS:
+            if (aa.isMember(CA))
+                result.push_back(&aa[CA]);
+            break;
+        case CB_ATOMS:
+            if (aa.getSideChain().isMember(CB))
+                result.push_back(&aa.getSideChain()[CB]);
+            break;
+        case REPR_ATOMS:
+            if (aa.getCode() == XXX)
+                break;
+            if (aa.getCode() == GLY) {
+                if (aa.isMember(CA))
+                    result.push_back(&aa[CA]);
+            } else if (aa.getSideChain().isMember(CB))
+                result.push_back(&aa.getSideChain()[CB]);
+            break;
+        case N_ATOMS:
+            if (aa.isMember(N))
+                result.push_back(&aa[N]);
+            break;
+        case O_ATOMS:
+            if (aa.isMember(O))
+                result.push_back(&aa[O]);
+            break;
+        case BACKBONE_NO_ATOMS:
+            if (aa.isMember(N))
+                result.push_back(&aa[N]);
+            if (aa.isMember(O))
+                result.push_back(&aa[O]);
+            break;
+        case HEAVY_ATOMS:
+            for (unsigned int k = 0; k < aa.size(); k++)
+                if (!isHAtom(aa[k].getCode()))
+                    result.push_back(&aa[k]);
+            break;
+        case ALL_ATOMS:
+            for (unsigned int k = 0; k < aa.size(); k++)
+                result.push_back(&aa[k]);
+            break;
+    }
+}
+
+// HELPERS:
+
+void
+NeighborGrid::pAdd(Atom& at, unsigned int r) {
+    atoms.push_back(&at);
+    atomResidue.push_back(r);
+    coords.push_back(at.getCoords());
+}
+
+/**
+ *  Cell coordinate of a value along one axis, clamped to the grid.
+ */
+unsigned int
+NeighborGrid::pCellIndex(double v, unsigned int axis) const {
+    double t = (v - origin[axis]) / cellSize;
+    if (t <= 0.0)
+        return 0;
+    if (t >= dim[axis] - 1)
+        return dim[axis] - 1;
+    return static_cast<unsigned int> (t);
+}
+
+unsigned int
+NeighborGrid::pCellOf(const vgVector3<double>& pos) const {
+    return (pCellIndex(pos.z, 2) * dim[1] + pCellIndex(pos.y, 1)) * dim[0]
+            + pCellIndex(pos.x, 0);
+}
+
+void
+NeighborGrid::pLink(unsigned int i) {
+    prev[i] = -1;
+    next[i] = head[cell[i]];
+    if (next[i] >= 0)
+        prev[next[i]] = i;
+    head[cell[i]] = i;
+}
+
+void
+NeighborGrid::pUnlink(unsigned int i) {
+    if (prev[i] >= 0)
+        next[prev[i]] = next[i];
+    else
+        head[cell[i]] = next[i];
+    if (next[i] >= 0)
+        prev[next[i]] = prev[i];
+}
+
+void
+NeighborGrid::pUpdateAtom(unsigned int i) {
+    coords[i] = atoms[i]->getCoords();
+    unsigned int c = pCellOf(coords[i]);
+    if (c == cell[i])
+        return;
+    pUnlink(i);
+    cell[i] = c;
+    pLink(i);
+}
@@ -0,0 +1,189 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _NeighborGrid_H_
+#define _NeighborGrid_H_
+
+
+// Includes:
+#include <Spacer.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Uniform cell list over the atoms of a Spacer.
+     * 
+     *  Space is divided into cubic cells of side cutoff and every selected
+     *  atom is linked into the cell containing it, so that all atoms within
+     *  distance r of a point are found by visiting only the few cells around
+     *  it instead of the whole chain. Atoms are stored in residue order and
+     *  remember the index of their residue in the Spacer.
+     *  The grid keeps pointers to the atoms of the Spacer: when some residues
+     *  move, update() relinks only their atoms. The Spacer must not gain or
+     *  lose atoms while the grid is in use (call build() again instead).
+     * */
+
+    class NeighborGrid {
+    public:
+
+        /** Which atoms of each residue are put in the grid. */
+        enum AtomFilter {
+            CA_ATOMS, // CA
+            CB_ATOMS, // CB, residues without CB are skipped
+            REPR_ATOMS, // CB, CA for glycine (as in SolvExpos)
+            N_ATOMS, // backbone N
+            O_ATOMS, // backbone O
+            BACKBONE_NO_ATOMS, // backbone N and O
+            HEAVY_ATOMS, // all atoms but hydrogens
+            ALL_ATOMS
+        };
+
+        /** Callback for forEachPairWithin(). */
+        class PairVisitor {
+        public:
+
+            virtual ~PairVisitor() {
+            }
+            /** Called once per pair, with i < j and getResidue(i) <= getResidue(j). */
+            virtual void visit(unsigned int i, unsigned int j, double dist) = 0;
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        NeighborGrid(double cutoff = 10.0, AtomFilter filter = HEAVY_ATOMS);
+        NeighborGrid(Spacer& sp, double cutoff = 10.0, AtomFilter filter = HEAVY_ATOMS);
+        virtual ~NeighborGrid();
+
+        // PREDICATES:
+        unsigned int size() const;
+        double getCutoff() const;
+        AtomFilter getFilter() const;
+
+        Atom& getAtom(unsigned int i) const;
+        unsigned int getResidue(unsigned int i) const; // index in the Spacer
+        const vgVector3<double>& getCoords(unsigned int i) const;
+        unsigned int getResidueStart(unsigned int r) const; // first atom of r
+        unsigned int getResidueEnd(unsigned int r) const; // past last atom of r
+
+        void forEachPairWithin(double r, PairVisitor& visitor) const;
+        void neighborsOf(const vgVector3<double>& pos, double r,
+                vector<unsigned int>& result) const;
+        void neighborsOf(Atom& at, double r, vector<unsigned int>& result) const;
+
+        // MODIFIERS:
+        void build(Spacer& sp);
+        void update();
+        void update(unsigned int first, unsigned int last);
+        void update(const vector<unsigned int>& residues);
+
+        static void selectAtoms(AminoAcid& aa, AtomFilter filter,
+                vector<Atom*>& result);
+
+    protected:
+
+    private:
+        // HELPERS:
+        void pAdd(Atom& at, unsigned int r);
+        unsigned int pCellIndex(double v, unsigned int axis) const;
+        unsigned int pCellOf(const vgVector3<double>& pos) const;
+        void pLink(unsigned int i);
+        void pUnlink(unsigned int i);
+        void pUpdateAtom(unsigned int i);
+
+        NeighborGrid(const NeighborGrid& orig);
+        NeighborGrid& operator=(const NeighborGrid& orig);
+
+        // ATTRIBUTES:
+        double cutoff;
+        AtomFilter filter;
+
+        vector<Atom*> atoms;
+        vector<unsigned int> atomResidue; // residue of each atom
+        vector<vgVector3<double> > coords; // positions at the last update
+        vector<unsigned int> residueStart; // first atom of each residue, +1 sentinel
+
+        vgVector3<double> origin; // lower corner of the grid
+        double cellSize;
+        unsigned int dim[3]; // number of cells per axis
+        vector<int> head; // first atom of each cell, -1 if empty
+        vector<int> next; // doubly linked list of the atoms in a cell
+        vector<int> prev;
+        vector<unsigned int> cell; // cell of each atom
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                NeighborGrid
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    NeighborGrid::size() const {
+        return atoms.size();
+    }
+
+    inline double
+    NeighborGrid::getCutoff() const {
+        return cutoff;
+    }
+
+    inline NeighborGrid::AtomFilter
+    NeighborGrid::getFilter() const {
+        return filter;
+    }
+
+    inline Atom&
+    NeighborGrid::getAtom(unsigned int i) const {
+        PRECOND(i < atoms.size(), exception);
+        return *atoms[i];
+    }
+
+    inline unsigned int
+    NeighborGrid::getResidue(unsigned int i) const {
+        PRECOND(i < atomResidue.size(), exception);
+        return atomResidue[i];
+    }
+
+    inline const vgVector3<double>&
+    NeighborGrid::getCoords(unsigned int i) const {
+        PRECOND(i < coords.size(), exception);
+        return coords[i];
+    }
+
+    inline unsigned int
+    NeighborGrid::getResidueStart(unsigned int r) const {
+        PRECOND(r + 1 < residueStart.size(), exception);
+        return residueStart[r];
+    }
+
+    inline unsigned int
+    NeighborGrid::getResidueEnd(unsigned int r) const {
+        PRECOND(r + 1 < residueStart.size(), exception);
+        return residueStart[r + 1];
+    }
+
+    inline void
+    NeighborGrid::neighborsOf(Atom& at, double r, vector<unsigned int>& result) const {
+        neighborsOf(at.getCoords(), r, result);
+    }
+
+}} //namespace
+
+#endif
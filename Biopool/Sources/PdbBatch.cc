@@ -0,0 +1,99 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <PdbBatch.h>
+#include <fstream>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// ---------------------------------------------------------------------------
+//                               PdbBatch::PdbJob
+// -----------------x-------------------x-------------------x-----------------
+
+/**
+ *   Loads one file and runs the task on it.
+ */
+class PdbBatch::PdbJob : public BatchJob {
+public:
+
+    PdbJob(StructureTask& _task, const string& _fileName) : task(_task),
+    fileName(_fileName), prot() {
+    }
+
+    virtual bool load() {
+        ifstream in(fileName.c_str());
+        if (!in)
+            return false;
+        PdbLoader pl(in);
+        pl.setThreads(1); // the batch already keeps every core busy
+        task.configure(pl);
+        prot.load(pl);
+        return pl.isValid() && (prot.sizeProtein() > 0);
+    }
+
+    virtual void run(ostream& os) {
+        task.process(fileName, prot, os);
+    }
+
+private:
+    StructureTask& task;
+    string fileName;
+    Protein prot;
+};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Starts the threads of a batch.
+ *@param task function applied to each structure
+ *@param threads threads processing structures, 0 = one per available CPU
+ *@param ioThreads threads parsing files
+ */
+PdbBatch::PdbBatch(StructureTask& task, unsigned int threads,
+        unsigned int ioThreads) : task(task), runner(threads, ioThreads) {
+}
+
+PdbBatch::~PdbBatch() {
+    PRINT_NAME;
+}
+
+// MODIFIERS:
+
+/**
+ *  Processes the files and writes their output to os, in the order of 
+ *  the list.
+ *@param files PDB files, e.g. from BatchRunner::readList() or 
+ *      BatchRunner::readDirectory()
+ *@param os output stream
+ *@return void
+ */
+void
+PdbBatch::run(const vector<string>& files, ostream& os) {
+    runner.run(files, *this, os);
+}
+
+/**
+ *  Creates the job of a file, for the BatchRunner.
+ *@param fileName PDB file
+ *@return job
+ */
+BatchJob*
+PdbBatch::create(const string& fileName) {
+    return new PdbJob(task, fileName);
+}
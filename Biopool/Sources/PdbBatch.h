@@ -0,0 +1,111 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _PDB_BATCH_H_
+#define _PDB_BATCH_H_
+
+
+// Includes:
+#include <BatchRunner.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <Debug.h>
+#include <string>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Per-structure function of a batch application.
+     * 
+     *  A single task object serves all the files of a batch, so parameters
+     *  and potentials are loaded once, when the task is built. configure()
+     *  and process() are called concurrently from several threads and 
+     *  must only read the state shared between calls.
+     * */
+    class StructureTask {
+    public:
+
+        virtual ~StructureTask() {
+        }
+
+        /// Sets the options of the loader of each file (I/O thread).
+
+        virtual void configure(PdbLoader& pl) {
+            pl.setNoHAtoms();
+            pl.setNoVerbose();
+        }
+
+        /// Processes a loaded structure; the output goes to os (worker thread).
+        virtual void process(const string& fileName, Protein& prot,
+                ostream& os) = 0;
+    };
+
+    /**@brief Runs a StructureTask on a list of PDB files.
+     * 
+     *  Files are parsed on I/O threads and processed on a work-stealing 
+     *  ThreadPool, see BatchRunner; the output of each file is written in
+     *  the order of the list. Files that cannot be opened or are not valid
+     *  PDB files are skipped and listed by getFailed().
+     * */
+    class PdbBatch : public BatchJobFactory {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        PdbBatch(StructureTask& task, unsigned int threads = 0,
+                unsigned int ioThreads = 2);
+        virtual ~PdbBatch();
+
+        // PREDICATES:
+        unsigned int getThreads() const;
+        const vector<string>& getFailed() const;
+
+        // MODIFIERS:
+        void run(const vector<string>& files, ostream& os = cout);
+        virtual BatchJob* create(const string& fileName);
+
+    private:
+        class PdbJob;
+
+        // not copyable: the batch owns its threads
+        PdbBatch(const PdbBatch& orig);
+        PdbBatch& operator=(const PdbBatch& orig);
+
+        // ATTRIBUTES:
+        StructureTask& task;
+        BatchRunner runner;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                    PdbBatch
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    PdbBatch::getThreads() const {
+        return runner.getThreads();
+    }
+
+    inline const vector<string>&
+    PdbBatch::getFailed() const {
+        return runner.getFailed();
+    }
+
+}} //namespace
+#endif //_PDB_BATCH_H_
@@ -25,6 +25,10 @@
 #include <Ligand.h>
 #include <Nucleotide.h>
 #include <AminoAcidHydrogen.h>
+#include <algorithm>
+#include <ctype.h>
+#include <sstream>
+#include <ThreadPool.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -153,7 +157,7 @@ PdbLoader::getAllChains() {
 }
 
 /**
- *    Private helper function to set bond structure after loading the spacer.
+ *    Helper function to set bond structure after loading the spacer.
  *@param   Spacer reference
  *@return  bool
  */
@@ -169,7 +173,7 @@ bool PdbLoader::setBonds(Spacer& sp) {
 }
 
 /**
- *    Private helper function to determine if atom is backbone or sidechain. 
+ *    Helper function to determine if atom is backbone or sidechain. 
  *@param   Spacer reference
  *@return  bool
  */
@@ -184,22 +188,102 @@ bool PdbLoader::inSideChain(const AminoAcid& aa, const Atom& at) {
     return true; // rest of aminoacid is its sidechain
 }
 
+/**
+ *    Completes a parsed chain: removes incomplete residues, connects the 
+ *  residues, fixes the leading N atom and adds hydrogens and DSSP as
+ *  requested. Used by all the loaders of Spacers from coordinate files;
+ *  the secondary structure of the file is assigned by the caller.
+ *@param   Spacer reference
+ *@param   chainName name of the chain, for messages
+ *@param   noConnection, noHAtoms, noSecondary, verbose loader options
+ *@return  false if the residues could not be connected
+ */
+bool
+PdbLoader::completeChain(Spacer& sp, const string& chainName,
+        bool noConnection, bool noHAtoms, bool noSecondary, bool verbose) {
+    bool connected = true;
+
+    if (sp.sizeAmino() > 0) {
+
+        // correct ''fuzzy'' (i.e. incomplete) residues
+        for (unsigned int j = 0; j < sp.sizeAmino(); j++) {
+            if ((!sp.getAmino(j).isMember(O)) ||
+                    (!sp.getAmino(j).isMember(C)) ||
+                    (!sp.getAmino(j).isMember(CA)) ||
+                    (!sp.getAmino(j).isMember(N))) {
+
+                // remove residue
+                sp.deleteComponent(&(sp.getAmino(j)));
+
+                // Add a gap for removed residues
+                sp.addGap(sp.getStartOffset() + j + 1);
+
+                if (verbose) {
+                    cout << "Warning: Residue number " << sp.getPdbNumberFromIndex(j) << " is incomplete and had to be removed.\n";
+                }
+            }
+        }
+        if (verbose)
+            cout << "Removed incomplete residues\n";
+
+        // connect aminoacids
+        if (!noConnection) {
+            if (!setBonds(sp)) { // connect atoms...
+                connected = false;
+                if (verbose)
+                    cout << "Warning: Fail to connect residues in chain: " << chainName << ".\n";
+            }
+            if (verbose)
+                cout << "Connected residues\n";
+        }
+
+
+        // correct position of leading N atom
+        sp.setTrans(sp.getAmino(0)[N].getTrans());
+        vgVector3<double> tmp(0.0, 0.0, 0.0);
+        sp.getAmino(0)[N].setTrans(tmp);
+        sp.getAmino(0).adjustLeadingN();
+        if (verbose)
+            cout << "Fixed leading N atom\n";
+
+        // Add H atoms
+        if (!noHAtoms) {
+            for (unsigned int j = 0; j < sp.sizeAmino(); j++) {
+                AminoAcidHydrogen::setHydrogen(&(sp.getAmino(j)), false); // second argument is VERBOSE
+            }
+            if (verbose)
+                cout << "H assigned\n";
+
+            if (!noSecondary) {
+                sp.setDSSP(false); // argument is VERBOSE
+                if (verbose)
+                    cout << "DSSP assigned\n";
+            }
+        }
+    } else {
+        if (verbose)
+            cout << "Warning: No residues in chain: " << chainName << ".\n";
+    }
+    return connected;
+}
+
 
 /**
  *    Try to assigns the secondary structure from the PDB header. If not present
  *  uses Spacer's setStateFromTorsionAngles().
  *@param   Spacer reference
+ *@param   chain identifier of sp
  */
 
 
-void PdbLoader::assignSecondary(Spacer& sp) {
+void PdbLoader::assignSecondary(Spacer& sp, char id) {
     if (helixData.size() + sheetData.size() == 0) {
         sp.setStateFromTorsionAngles();
         return;
     }
 
     for (unsigned int i = 0; i < helixData.size(); i++) {
-        if (helixCode[i] == chain) {
+        if (helixCode[i] == id) {
             for (int j = helixData[i].first; j <= const_cast<int&> (helixData[i].second); j++) {
                 // important: keep ifs separated to avoid errors
                 if (j < sp.maxPdbNumber())
@@ -210,7 +294,7 @@ void PdbLoader::assignSecondary(Spacer& sp) {
     }
 
     for (unsigned int i = 0; i < sheetData.size(); i++)
-        if (sheetCode[i] == chain)
+        if (sheetCode[i] == id)
             for (int j = sheetData[i].first; j <= const_cast<int&> (sheetData[i].second); j++) {
                 // important: keep ifs separated to avoid errors
                 if (j < sp.maxPdbNumber())
@@ -250,7 +334,57 @@ PdbLoader::loadSpacer(Spacer& sp){
  */
 
 /**
- *   Core function for PDB file parsing. 
+ *   Residues and ligands of one chain, collected while parsing.
+ */
+struct PdbLoader::ChainData {
+
+    ChainData() : sp(new Spacer()), ls(new LigandSet()), aa(new AminoAcid()),
+    lig(new Ligand()), oldAaNum(-100000), connected(true) {
+    }
+
+    Spacer* sp;
+    LigandSet* ls;
+    AminoAcid* aa; // residue being read
+    Ligand* lig; // ligand being read
+    int oldAaNum; // number of the residue being read
+    bool connected; // setBonds() succeeded
+};
+
+/**
+ *   Chains to be built by loadProtein(), possibly in parallel threads.
+ */
+class PdbLoader::ChainLoop : public ThreadPool::Loop {
+public:
+
+    virtual void run(unsigned int i, unsigned int worker) {
+        ComponentArena::Scope scope(arena);
+        loader->processChain(*data[i], ids[i]);
+    }
+
+    PdbLoader* loader;
+    vector<ChainData*> data;
+    vector<char> ids;
+    ComponentArena* arena;
+};
+
+/**
+ *   Renumbers the atoms of sp numbered after first, i.e. the H atoms added
+ *   while building the chain, in residue order from last + 1. The numbers 
+ *   they got depend on how the chains were interleaved, these do not.
+ */
+static void
+sRenumberAdded(Spacer& sp, long first, long& last) {
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        for (unsigned int j = 0; j < aa.size(); j++)
+            if (static_cast<long> (aa[j].getNumber()) > first)
+                aa[j].setNumber(++last);
+    }
+}
+
+/**
+ *   Core function for PDB file parsing. The file is read once into memory
+ *   and all requested chains are collected in a single pass over it.
  * @param prot (Protein&)
  */
 
@@ -259,34 +393,129 @@ PdbLoader::loadProtein(Protein& prot) {
 
     PRINT_NAME;
 
-    vector<char> chainList = getAllChains();
-
-    if (chainList.size() == 0) {
-        if (verbose)
-            cout << "Warning: Missing chain ID in the PDB, assuming the same chain for the entire file.\n";
-        chainList.push_back(char(' '));
-    }
+    // residues, ligands and chains are allocated in one go
+    ComponentArena::Scope scope(prot.getArena());
 
+    string buffer;
+    readBuffer(buffer);
 
     unsigned int readingModel = model;
     bool loadChain = false;
 
     helixCode = "";
     sheetCode = "";
+    helixData.clear();
+    sheetData.clear();
+
+
+    if (!noHAtoms)
+        AminoAcidHydrogen::loadDefaultParam();
+
+    // chains of the first model, in order of appearance (see getAllChains())
+    vector<char> chainList;
+    char lastChain = ' ';
+    unsigned int modelLines = 0;
+
+    // only chain is parsed when it is known in advance, otherwise every
+    // chain is parsed until the first ATOM record names the default one
+    char wanted = allChains ? ' ' : chain;
+    vector<ChainData*> chains(256, static_cast<ChainData*> (NULL));
+
+    int start, end;
+    string name = "";
+
+    string::size_type pos = 0;
+    const char* line;
+    unsigned int len;
+
+    // read all lines
+    while (nextLine(buffer, pos, line, len)) {
+
+        if (hasTag(line, len, "MODEL"))
+            modelLines++;
+        if ((modelLines <= 1) && hasTag(line, len, "ATOM")
+                && (column(line, len, 21) != lastChain)) {
+            lastChain = column(line, len, 21);
+            chainList.push_back(lastChain);
+            if ((!allChains) && (wanted == ' '))
+                wanted = lastChain;
+        }
+
+        if (hasTag(line, len, "HEADER")) {
+            if (name == "")
+                name = string(line, len);
+        } else if (hasTag(line, len, "MODEL ")) {
+            readingModel = stouiDEF(line + 6, field(len, 6, 10));
+            if (readingModel > model)
+                break;
+            // Get only the first model if not specified
+            if (model == 999) {
+                model = readingModel;
+            }
+        }
+
+            // read helix entry
+        else if (hasTag(line, len, "HELIX ")) {
+            start = stoiDEF(line + 21, field(len, 21, 4));
+            end = stoiDEF(line + 33, field(len, 33, 4));
+
+            helixData.push_back(pair<const int, int>(start, end));
+            helixCode += column(line, len, 19);
+        }            // read sheet entry
+        else if (hasTag(line, len, "SHEET ")) {
+            start = stoiDEF(line + 22, field(len, 22, 4));
+            end = stoiDEF(line + 33, field(len, 33, 4));
 
+            sheetData.push_back(pair<const int, int>(start, end));
+            sheetCode += column(line, len, 21);
+        }
+
+            // Parse one line of the "ATOM" and "HETATM" fields
+        else if (hasTag(line, len, "ATOM  ") || hasTag(line, len, "HETATM")) {
+
+            char chainID = column(line, len, 21);
+            if ((wanted == ' ') || (chainID == wanted)) {
+
+                if ((model == 999) || (model == readingModel)) {
+                    ChainData*& data = chains[static_cast<unsigned char> (chainID)];
+                    if (data == NULL)
+                        data = new ChainData();
+
+                    int aaNum = stoiDEF(line + 22, field(len, 22, 4));
+
+                    // Insert the previous residue and ligand
+                    if (aaNum != data->oldAaNum) {
+                        insertResidue(*data);
+                        data->aa = new AminoAcid();
+                        data->lig = new Ligand();
+                    }
 
-    string path = "data/AminoAcidHydrogenData.txt";
-    const char* inputFile = getenv("VICTOR_ROOT");
-    if (inputFile == NULL)
-        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
+                    data->oldAaNum = parsePDBline(line, len,
+                            hasTag(line, len, "HETATM"), data->lig, data->aa);
+
+                } // end model check
+            } // end chain check
+        }
+    }
+
+    if (chainList.size() == 0) {
+        if (verbose)
+            cout << "Warning: Missing chain ID in the PDB, assuming the same chain for the entire file.\n";
+        chainList.push_back(char(' '));
+    }
 
-    AminoAcidHydrogen::loadParam(((string) inputFile + path).c_str());
+    // chains to load, in order
+    ChainLoop loop;
+    loop.loader = this;
+    loop.arena = ComponentArena::getCurrent();
 
     for (unsigned int i = 0; i < chainList.size(); i++) {
         loadChain = false;
         // Load all chains
         if (allChains) {
-            loadChain = true;
+            // chains interrupted by other chains are listed again
+            loadChain = (find(chainList.begin(), chainList.begin() + i,
+                    chainList[i]) == chainList.begin() + i);
         } else {
             // Load only first chain
             if (chain == ' ') {
@@ -300,302 +529,220 @@ PdbLoader::loadProtein(Protein& prot) {
         }
 
         if (loadChain) {
-
-            if (verbose) {
-                cout << "\nLoading chain: ->" << chainList[i] << "<-\n";
-            }
             setChain(chainList[i]);
 
-            input.clear(); // reset file to previous content 
-            input.seekg(0, ios::beg);
-
-            Spacer* sp = new Spacer();
-            LigandSet* ls = new LigandSet();
-
-            string atomLine;
-            atomLine = readLine(input);
-
-            int aaNum = -100000; // infinite negative
-            int oldAaNum = -100000;
-            //int lastAa = -10000;
-
-            AminoAcid* aa = new AminoAcid();
-            Ligand* lig = new Ligand();
-
-
-            int start, end;
-
-            string name = "";
-            string tag = "";
-
-            // read all lines
-            do {
+            ChainData*& data = chains[static_cast<unsigned char> (chainList[i])];
+            if (data == NULL)
+                data = new ChainData();
 
-                tag = atomLine.substr(0, 6);
-
-                if ((tag == "HEADER") && (name == "")) {
-                    name = atomLine;
-                    sp->setType(name);
-                } else if (tag == "MODEL ") {
-                    readingModel = stouiDEF(atomLine.substr(6, 10));
-                    if (readingModel > model)
-                        break;
-                    // Get only the first model if not specified
-                    if (model == 999) {
-                        model = readingModel;
-                    }
-                }
-
-                    // read helix entry
-                else if (tag == "HELIX ") {
-                    start = stoiDEF(atomLine.substr(21, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
-
-                    helixData.push_back(pair<const int, int>(start, end));
-                    helixCode += atomLine.substr(19, 1).c_str()[0];
-                }                    // read sheet entry
-                else if (tag == "SHEET ") {
-                    start = stoiDEF(atomLine.substr(22, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
-
-                    sheetData.push_back(pair<const int, int>(start, end));
-                    sheetCode += atomLine.substr(21, 1).c_str()[0];
-                }
-
-                    // Parse one line of the "ATOM" and "HETATM" fields
-                else if ((tag == "ATOM  ") || (tag == "HETATM")) {
-
-                    char chainID = atomLine.substr(21, 1)[0];
-                    if (chainList[i] == chainID) {
-
-                        if ((model == 999) || (model == readingModel)) {
-                            aaNum = stoiDEF(atomLine.substr(22, 4));
-
-                            // Insert the Ligand object into LigandSet
-                            if (aaNum != oldAaNum) {
-                                // Print some indexes for the debug
-                                /* 
-                                cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
-                                     << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
-                                     << sp->maxPdbNumber() << " aaNum:" << aaNum  
-                                     << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
-                                 */
-                                if ((aa->size() > 0) && (aa->getType1L() != 'X')) { // Skip the first empty AminoAcid
-                                    if (sp->sizeAmino() == 0) {
-                                        sp->setStartOffset(oldAaNum - 1);
-                                    } else {
-                                        // Add gaps
-                                        //for (int i = lastAa+1; i < oldAaNum; i++){
-                                        for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
-                                            sp->addGap(i);
-                                        }
-
-                                    }
-
-                                    sp->insertComponent(aa);
-
-                                }
-
-                                // Ligand
-                                if (lig->size() > 0) {
-
-                                    if (onlyMetalHetAtoms) {
-                                        if (lig->isSimpleMetalIon()) { // skip not metal ions  
-                                            ls->insertComponent(lig);
-                                        }
-                                    } else {
-                                        ls->insertComponent(lig);
-                                    }
-                                }
-
-                                aa = new AminoAcid();
-                                lig = new Ligand();
-                            }
-
-                            oldAaNum = parsePDBline(atomLine, tag, lig, aa);
-
-                        } // end model check
-                    } // end chain check
-                }
-                atomLine = readLine(input);
-
-            } while (input);
-
-            
-            /*
-            // Print some indexes for the debug
-            cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
-                << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
-                << sp->maxPdbNumber() << " aaNum:" << aaNum  
-                << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
-             */
-            
             // last residue/ligand
-            // AminoAcid
-            if ((aa->size() > 0) && (aa->getType1L() != 'X')) {
-                if (sp->sizeAmino() == 0) {
-                    sp->setStartOffset(oldAaNum - 1);
-                } else {
-                    // Add gaps
-                    //for (int i = lastAa+1; i < oldAaNum; i++){
-                    for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
-                        sp->addGap(i);
-                    }
-                }
-                sp->insertComponent(aa);
-
+            insertResidue(*data);
+            if (name != "")
+                data->sp->setType(name);
 
-            }
-            // Ligand
-            if (lig->size() > 0) {
-                if (onlyMetalHetAtoms) {
-                    if (lig->isSimpleMetalIon()) { // skip not metal ions  
-                        ls->insertComponent(lig);
-                    }
-                } else {
-                    ls->insertComponent(lig);
-                }
-            }
-            if (verbose)
-                cout << "Parsing done\n";
-
-            ////////////////////////////////////////////////////////////////////
-            // Spacer processing
-            if (sp->sizeAmino() > 0) {
-
-                // correct ''fuzzy'' (i.e. incomplete) residues
-                for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
-                    if ((!sp->getAmino(j).isMember(O)) ||
-                            (!sp->getAmino(j).isMember(C)) ||
-                            (!sp->getAmino(j).isMember(CA)) ||
-                            (!sp->getAmino(j).isMember(N))) {
-
-                        // remove residue
-                        sp->deleteComponent(&(sp->getAmino(j)));
+            loop.data.push_back(data);
+            loop.ids.push_back(chainList[i]);
+            data = NULL;
+        }
+    } // chains iteration
 
-                        // Add a gap for removed residues
-                        sp->addGap(sp->getStartOffset() + j + 1);
+    // build the chains, concurrently unless messages are printed
+    long first = Identity::getLastNumber();
+    ThreadPool::forEach(loop.data.size(), loop, verbose ? 1 : threads);
+    long last = first;
+    for (unsigned int i = 0; i < loop.data.size(); i++)
+        sRenumberAdded(*loop.data[i]->sp, first, last);
+
+    ////////////////////////////////////////////////////////////////////////
+    // Load data into protein object
+    for (unsigned int i = 0; i < loop.data.size(); i++) {
+        Spacer* sp = loop.data[i]->sp;
+        LigandSet* ls = loop.data[i]->ls;
+        if (!loop.data[i]->connected)
+            valid = false;
+        delete loop.data[i];
+
+        Polymer* pol = new Polymer();
+        pol->insertComponent(sp);
+        if (verbose)
+            cout << "Loaded AminoAcids: " << sp->size() << "\n";
 
-                        if (verbose) {
-                            cout << "Warning: Residue number " << sp->getPdbNumberFromIndex(j) << " is incomplete and had to be removed.\n";
-                        }
-                    }
-                }
+        if (!(noHetAtoms)) {
+            if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
+                pol->insertComponent(ls);
                 if (verbose)
-                    cout << "Removed incomplete residues\n";
-
-                // connect aminoacids
-                if (!noConnection) {
-
-                    if (!setBonds(*sp)) { // connect atoms...
-                        valid = false;
-                        if (verbose)
-                            cout << "Warning: Fail to connect residues in chain: " << chainList[i] << ".\n";
-                    }
-                    if (verbose)
-                        cout << "Connected residues\n";
-                }
-
-
-                // correct position of leading N atom
-                sp->setTrans(sp->getAmino(0)[N].getTrans());
-                vgVector3<double> tmp(0.0, 0.0, 0.0);
-                sp->getAmino(0)[N].setTrans(tmp);
-                sp->getAmino(0).adjustLeadingN();
+                    cout << "Loaded Ligands: " << ls->size() << "\n";
+            } else {
                 if (verbose)
-                    cout << "Fixed leading N atom\n";
+                    cout << "Warning: No ligands in chain: " << loop.ids[i] << ".\n";
+            }
+        }
 
+        prot.addChain(loop.ids[i]);
+        prot.insertComponent(pol);
+    }
 
+    // chains parsed before the default chain was known
+    for (unsigned int i = 0; i < chains.size(); i++)
+        if (chains[i] != NULL) {
+            delete chains[i]->aa;
+            delete chains[i]->lig;
+            delete chains[i]->sp;
+            delete chains[i]->ls;
+            delete chains[i];
+        }
+}
 
-                // Add H atoms
-                if (!noHAtoms) {
-                    for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
-                        AminoAcidHydrogen::setHydrogen(&(sp->getAmino(j)), false); // second argument is VERBOSE
-                    }
-                    if (verbose)
-                        cout << "H assigned\n";
+/**
+ *   Loads the amino acids of all models of the selected chain (the first
+ *   chain if none is selected) in a single pass. Atoms are filtered as in
+ *   loadProtein(); ligands and nucleotides are skipped. Every model must
+ *   contain the atoms of the first one, which define the topology.
+ * @param ens (Ensemble&)
+ */
+void
+PdbLoader::loadEnsemble(Ensemble& ens) {
 
-                    if (!noSecondary) {
-                        sp->setDSSP(false); // argument is VERBOSE
-                        if (verbose)
-                            cout << "DSSP assigned\n";
-                    }
-                }
+    PRINT_NAME;
 
-                // assign secondary structure from torsion angles
-                if (!noSecondary) {
-                    assignSecondary(*sp);
-                    if (verbose)
-                        cout << "Torsional SS assigned\n";
-                }
+    string buffer;
+    readBuffer(buffer);
+    ens.clear();
+
+    char wanted = chain;
+    int current = -1; // model being read
+    int residue = -1; // residue being read
+    int oldAaNum = -100000; // infinite negative
+    unsigned int modelAtoms = 0; // atoms read in the current model
+    vector<bool> seen; // atoms read in the current model
+
+    string::size_type pos = 0;
+    const char* line;
+    unsigned int len;
+
+    // read all lines
+    while (nextLine(buffer, pos, line, len)) {
+
+        if (hasTag(line, len, "MODEL ")) {
+            if ((current > 0) && (modelAtoms != ens.sizeAtoms()))
+                ERROR("Atoms of model " + itosDEF(ens.getModelNumber(current))
+                    + " differ from the first model.", exception);
+            current = ens.addModel(stouiDEF(line + 6, field(len, 6, 10)));
+            residue = -1;
+            oldAaNum = -100000;
+            modelAtoms = 0;
+            seen.assign(ens.sizeAtoms(), false);
+            continue;
+        }
 
-            } else {
-                if (verbose)
-                    cout << "Warning: No residues in chain: " << chainList[i] << ".\n";
-            }
+        if (!hasTag(line, len, "ATOM  "))
+            continue;
 
-            ////////////////////////////////////////////////////////////////////
-            // Load data into protein object
-            Polymer* pol = new Polymer();
-            pol->insertComponent(sp);
-            if (verbose)
-                cout << "Loaded AminoAcids: " << sp->size() << "\n";
-
-            if (!(noHetAtoms)) {
-                if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
-                    pol->insertComponent(ls);
-                    if (verbose)
-                        cout << "Loaded Ligands: " << ls->size() << "\n";
-                } else {
-                    if (verbose)
-                        cout << "Warning: No ligands in chain: " << chainList[i] << ".\n";
-                }
-            }
+        char chainID = column(line, len, 21);
+        if (wanted == ' ')
+            wanted = chainID;
+        if (chainID != wanted)
+            continue;
 
-            prot.addChain(chainList[i]);
-            prot.insertComponent(pol);
+        // skip alternative residues, see parsePDBline()
+        if (column(line, len, 26) != ' ')
+            continue;
 
+        string atType = "";
+        for (unsigned int i = 11; i < 17; i++) {
+            if (column(line, len, i) != ' ')
+                atType += line[i];
+        }
+        string aaType = "";
+        for (unsigned int i = 17; i < 20; i++) {
+            if (column(line, len, i) != ' ')
+                aaType += line[i];
+        }
+        if ((aaType == "ACE") || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType)))
+            continue;
+        if (atType == "D")
+            atType = "H";
+        if (noHAtoms && !isHeavyAtom(AtomTranslator(atType)))
+            continue;
+
+        // atoms before the first MODEL record
+        if (current < 0)
+            current = ens.addModel(1);
+
+        int aaNum = stoiDEF(line + 22, field(len, 22, 4));
+        if (aaNum != oldAaNum) {
+            oldAaNum = aaNum;
+            if (current == 0)
+                residue = ens.addResidue(aaNum, aaType);
+            else if ((++residue >= static_cast<int> (ens.sizeResidues()))
+                    || (ens.getResidueNumber(residue) != aaNum))
+                ERROR("Residues of model " + itosDEF(ens.getModelNumber(current))
+                    + " differ from the first model.", exception);
+        }
 
+        int atom = ens.findAtom(residue, atType);
+        if (current == 0) {
+            if (atom >= 0)
+                continue; // alternate location of an atom already read
+            atom = ens.addAtom(atType);
+        } else {
+            if (atom < 0)
+                ERROR("Atoms of model " + itosDEF(ens.getModelNumber(current))
+                    + " differ from the first model.", exception);
+            if (seen[atom])
+                continue;
+            seen[atom] = true;
+        }
+        modelAtoms++;
 
-        } // end loadChain
-    } // chains iteration
+        vgVector3<double> coord;
+        coord.x = stodDEF(line + 30, field(len, 30, 8));
+        coord.y = stodDEF(line + 38, field(len, 38, 8));
+        coord.z = stodDEF(line + 46, field(len, 46, 8));
+        ens.setCoords(current, atom, coord);
+    }
 
+    if ((current > 0) && (modelAtoms != ens.sizeAtoms()))
+        ERROR("Atoms of model " + itosDEF(ens.getModelNumber(current))
+            + " differ from the first model.", exception);
 }
 
 /**
- *   Parse a single line of a PDB file.
- * @param atomLine (string) the whole PDB line as it is
- * @param tag (string) = the first field (keyword) in a PDB line
+ *   Parse a single line of a PDB file, in place.
+ * @param atomLine (const char*) the whole PDB line as it is
+ * @param length (unsigned int) length of the line
+ * @param hetAtom (bool) = true for "HETATM" lines, false for "ATOM" lines
  * @param lig (Ligand) pointer
  * @param aa (AminoAcid) pointer
  * @return Residue number read from the PDB line (int)
  */
 int
-PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa) {
+PdbLoader::parsePDBline(const char* atomLine, unsigned int length, bool hetAtom,
+        Ligand* lig, AminoAcid* aa) {
 
-    int atNum = stoiDEF(atomLine.substr(6, 5)); // stoi convert from string to int
-    //char altAtID = atomLine.substr(16,1)[0];    // "Alternate location indicator"               
-    int aaNum = stoiDEF(atomLine.substr(22, 4));
-    char altAaID = atomLine.substr(26, 1)[0]; // "Code for insertion of residues"
+    int atNum = stoiDEF(atomLine + 6, field(length, 6, 5)); // convert from chars to int
+    //char altAtID = column(atomLine, length, 16);    // "Alternate location indicator"
+    int aaNum = stoiDEF(atomLine + 22, field(length, 22, 4));
+    char altAaID = column(atomLine, length, 26); // "Code for insertion of residues"
     vgVector3<double> coord;
-    coord.x = stodDEF(atomLine.substr(30, 8));
-    coord.y = stodDEF(atomLine.substr(38, 8));
-    coord.z = stodDEF(atomLine.substr(46, 8));
+    coord.x = stodDEF(atomLine + 30, field(length, 30, 8));
+    coord.y = stodDEF(atomLine + 38, field(length, 38, 8));
+    coord.z = stodDEF(atomLine + 46, field(length, 46, 8));
     double bfac = 0.0;
-    if (atomLine.length() >= 66) {
-        if (atomLine.substr(60, 6) != "      ") { // empty bfac
-            bfac = stodDEF(atomLine.substr(60, 6));
+    if (length >= 66) {
+        if (strncmp(atomLine + 60, "      ", 6) != 0) { // empty bfac
+            bfac = stodDEF(atomLine + 60, 6);
         }
     }
     string atType = "";
-    for (int i = 11; i < 17; i++) {
-        if (atomLine[i] != ' ')
-            atType.append(atomLine.substr(i, 1));
+    for (unsigned int i = 11; i < 17; i++) {
+        if (column(atomLine, length, i) != ' ')
+            atType += atomLine[i];
     }
     string aaType = "";
-    for (int i = 17; i < 20; i++) {
-        if (atomLine[i] != ' ')
-            aaType.append(atomLine.substr(i, 1));
+    for (unsigned int i = 17; i < 20; i++) {
+        if (column(atomLine, length, i) != ' ')
+            aaType += atomLine[i];
     }
     // take care of deuterium atoms
     if (atType == "D") {
@@ -604,27 +751,27 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
     }
 
     // Initialize the Atom object
-    Atom* at = new Atom();
-    at->setNumber(atNum);
-    at->setType(atType);
-    at->setCoords(coord);
-    //at->setCoords(stod(atomLine.substr(30,8)),stod(atomLine.substr(38,8)),stod(atomLine.substr(46,8)));
-    at->setBFac(bfac);
+    Atom at;
+    at.setNumber(atNum);
+    at.setType(atType);
+    at.setCoords(coord);
+    //at.setCoords(stod(atomLine.substr(30,8)),stod(atomLine.substr(38,8)),stod(atomLine.substr(46,8)));
+    at.setBFac(bfac);
 
     // Ligand object (includes DNA/RNA in "ATOM" field)
-    if ((tag == "HETATM") || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
+    if (hetAtom || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
 
         if (noWater) {
             if (!(aaType == "HOH")) {
-                lig->addAtom(*at);
+                lig->addAtom(at);
                 lig->setType(aaType);
             }
         } else {
-            lig->addAtom(*at);
+            lig->addAtom(at);
             lig->setType(aaType);
         }
     }        // AminoAcid
-    else if ((tag == "ATOM  ")) {
+    else {
 
         // skip N-terminal ACE groups
         if (aaType != "ACE") {
@@ -638,12 +785,12 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 aa->setType(aaType);
                 aa->getSideChain().setType(aaType);
 
-                if (!noHAtoms || isHeavyAtom(at->getCode())) {
+                if (!noHAtoms || isHeavyAtom(at.getCode())) {
 
-                    if (!inSideChain(*aa, *at))
-                        aa->addAtom(*at);
+                    if (!inSideChain(*aa, at))
+                        aa->addAtom(at);
                     else {
-                        aa->getSideChain().addAtom(*at);
+                        aa->getSideChain().addAtom(at);
                     }
                 }
             }
@@ -653,6 +800,231 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 cout << "Warning: Skipping N-terminal ACE group " << aaNum << " " << atNum << ".\n";
         }
     }
-    delete at;
     return aaNum;
 }
+
+/**
+ *   Loads the amino acids of the selected chain (the first one if none is
+ *   selected, all of them after setAllChains()) into a compact read-only
+ *   structure, in a single pass and without building any Atom. Only the
+ *   first model (or the selected one) is read. Atoms are filtered as in
+ *   loadProtein(), except that incomplete residues are kept; ligands and
+ *   nucleotides are skipped.
+ * @param cs (CompactStructure&)
+ */
+void
+PdbLoader::loadCompact(CompactStructure& cs) {
+
+    PRINT_NAME;
+
+    string buffer;
+    readBuffer(buffer);
+    cs.clear();
+
+    char wanted = allChains ? ' ' : chain;
+    unsigned int wantedModel = model;
+    unsigned int readingModel = model;
+    char oldChain = ' ';
+    int oldAaNum = -100000; // infinite negative
+    int residue = -1; // residue being read
+
+    string::size_type pos = 0;
+    const char* line;
+    unsigned int len;
+
+    // read all lines
+    while (nextLine(buffer, pos, line, len)) {
+
+        if (hasTag(line, len, "MODEL ")) {
+            readingModel = stouiDEF(line + 6, field(len, 6, 10));
+            if (wantedModel == 999)
+                wantedModel = readingModel;
+            if (readingModel > wantedModel)
+                break;
+            continue;
+        }
+        if (hasTag(line, len, "ENDMDL") && (readingModel == wantedModel))
+            break;
+
+        if (!hasTag(line, len, "ATOM  "))
+            continue;
+        if ((wantedModel != 999) && (readingModel != wantedModel))
+            continue;
+
+        char chainID = column(line, len, 21);
+        if ((!allChains) && (wanted == ' '))
+            wanted = chainID;
+        if ((!allChains) && (chainID != wanted))
+            continue;
+
+        // skip alternative residues, see parsePDBline()
+        if (column(line, len, 26) != ' ')
+            continue;
+        // keep only the selected alternate location
+        char alt = column(line, len, 16);
+        if ((alt != ' ') && (alt != altAtom))
+            continue;
+
+        string aaType = "";
+        for (unsigned int i = 17; i < 20; i++) {
+            if (column(line, len, i) != ' ')
+                aaType += line[i];
+        }
+        AminoAcidCode aaCode = aminoAcidThreeLetterTranslator(aaType);
+        if (aaCode == XXX)
+            continue; // ACE, nucleotides and unknown residues
+
+        string atType = ""; // columns 13-16, column 17 is the altloc
+        for (unsigned int i = 12; i < 16; i++) {
+            if (column(line, len, i) != ' ')
+                atType += line[i];
+        }
+        if (atType == "D")
+            atType = "H";
+        AtomCode atCode = AtomTranslator(atType);
+        if (noHAtoms && !isHeavyAtom(atCode))
+            continue;
+
+        int aaNum = stoiDEF(line + 22, field(len, 22, 4));
+        if ((residue < 0) || (chainID != oldChain)) {
+            cs.addChain(chainID);
+            oldChain = chainID;
+            oldAaNum = -100000;
+        }
+        if (aaNum != oldAaNum) {
+            residue = cs.addResidue(aaNum, aaCode);
+            oldAaNum = aaNum;
+        }
+
+        vgVector3<double> coord;
+        coord.x = stodDEF(line + 30, field(len, 30, 8));
+        coord.y = stodDEF(line + 38, field(len, 38, 8));
+        coord.z = stodDEF(line + 46, field(len, 46, 8));
+        double bfac = 0.0;
+        if ((len >= 66) && (strncmp(line + 60, "      ", 6) != 0))
+            bfac = stodDEF(line + 60, 6);
+        cs.addAtom(atCode, coord, bfac);
+    }
+}
+
+/**
+ *   Reads the whole input stream into buffer.
+ * @param buffer (string&)
+ */
+void
+PdbLoader::readBuffer(string& buffer) {
+    input.clear(); // reset file to previous content
+    input.seekg(0, ios::end);
+    streamoff size = input.tellg();
+    input.seekg(0, ios::beg);
+
+    if (size > 0) {
+        buffer.resize(size);
+        input.read(&buffer[0], size);
+        buffer.resize(input.gcount());
+    } else {
+        // not seekable
+        input.clear();
+        ostringstream os;
+        os << input.rdbuf();
+        buffer = os.str();
+    }
+}
+
+/**
+ *   Finds the next line of buffer starting at pos. As readLine() does,
+ *   leading white space, blank lines and '#' comment lines are skipped.
+ * @param buffer (const string&)
+ * @param pos (string::size_type&) start of the search, set past the line
+ * @param line (const char*&) set to the first character of the line
+ * @param length (unsigned int&) set to the length of the line
+ * @return false at end of buffer
+ */
+bool
+PdbLoader::nextLine(const string& buffer, string::size_type& pos,
+        const char*& line, unsigned int& length) {
+    const string::size_type size = buffer.size();
+
+    for (;;) {
+        while ((pos < size) && isspace(buffer[pos]))
+            pos++;
+        if (pos >= size)
+            return false;
+        if (buffer[pos] != '#')
+            break;
+        while ((pos < size) && (buffer[pos] != '\n'))
+            pos++;
+    }
+
+    string::size_type endLine = pos;
+    while ((endLine < size) && (buffer[endLine] != '\n') && (buffer[endLine] != '\r'))
+        endLine++;
+
+    line = buffer.data() + pos;
+    length = endLine - pos;
+    pos = endLine;
+    return true;
+}
+
+/**
+ *   Inserts the residue and the ligand being read into the chain, or
+ *   deletes them if empty or not loaded.
+ * @param data (ChainData&)
+ */
+void
+PdbLoader::insertResidue(ChainData& data) {
+    Spacer* sp = data.sp;
+    AminoAcid* aa = data.aa;
+    Ligand* lig = data.lig;
+    data.aa = NULL;
+    data.lig = NULL;
+
+    // Skip the first empty AminoAcid
+    if ((aa != NULL) && (aa->size() > 0) && (aa->getType1L() != 'X')) {
+        if (sp->sizeAmino() == 0) {
+            sp->setStartOffset(data.oldAaNum - 1);
+        } else {
+            // Add gaps
+            for (int i = sp->maxPdbNumber() + 1; i < data.oldAaNum; i++) {
+                sp->addGap(i);
+            }
+        }
+        sp->insertComponent(aa);
+    } else
+        delete aa;
+
+    // Ligand
+    if ((lig != NULL) && (lig->size() > 0)
+            && ((!onlyMetalHetAtoms) || (lig->isSimpleMetalIon()))) { // skip not metal ions
+        data.ls->insertComponent(lig);
+    } else
+        delete lig;
+}
+
+/**
+ *   Builds a parsed chain: removes incomplete residues, connects the
+ *   residues and adds hydrogens and secondary structure as requested.
+ *   Chains are independent, so this runs concurrently on different chains.
+ * @param data (ChainData&)
+ * @param id chain identifier, for messages
+ */
+void
+PdbLoader::processChain(ChainData& data, char id) {
+    Spacer* sp = data.sp;
+
+    if (verbose) {
+        cout << "\nLoading chain: ->" << id << "<-\n";
+        cout << "Parsing done\n";
+    }
+
+    if (!completeChain(*sp, string(1, id), noConnection, noHAtoms,
+            noSecondary, verbose))
+        data.connected = false;
+
+    // assign secondary structure from torsion angles
+    if ((sp->sizeAmino() > 0) && (!noSecondary)) {
+        assignSecondary(*sp, id);
+        if (verbose)
+            cout << "Torsional SS assigned\n";
+    }
+}
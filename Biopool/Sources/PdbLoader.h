@@ -25,6 +25,8 @@
 #include <Spacer.h>
 #include <LigandSet.h>
 #include <Protein.h>
+#include <Ensemble.h>
+#include <CompactStructure.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -63,7 +65,7 @@ namespace Victor { namespace Biopool {
         allChains(_allChains), chain(' '), model(999), altAtom('A'), helixCode(_NULL),
         //sheetCode(_NULL), helixData(), sheetData(), onlyMetalHetAtoms(_onlyMetal), 
         sheetCode(_NULL), onlyMetalHetAtoms(_onlyMetal),
-        noNucleotideChains(_noNucleotideChains) {
+        noNucleotideChains(_noNucleotideChains), threads(0) {
         }
 
         // this class uses the implicit copy operator.
@@ -144,23 +146,59 @@ namespace Victor { namespace Biopool {
             allChains = true;
         }
 
+        /// Chains built concurrently by loadProtein(), 0 for one per core.
+        void setThreads(unsigned int _threads) {
+            threads = _threads;
+        }
+
 
 
         //virtual void loadSpacer(Spacer& sp);
         //virtual void loadLigandSet(LigandSet& l);
         virtual void loadProtein(Protein& prot);
+        void loadEnsemble(Ensemble& ens); // all models in a single pass
+        void loadCompact(CompactStructure& cs); // read-only, single pass
 
 
 
         //virtual void loadNucleotideChainSet(NucleotideChainSet& ns); //new class, new code by Damiano
 
+        // HELPERS shared with the other structure loaders:
+        static bool setBonds(Spacer& sp);
+        static bool inSideChain(const AminoAcid& aa, const Atom& at);
+        static bool completeChain(Spacer& sp, const string& chainName,
+                bool noConnection, bool noHAtoms, bool noSecondary, bool verbose);
+
     protected:
         // HELPERS:
-        bool setBonds(Spacer& sp);
-        bool inSideChain(const AminoAcid& aa, const Atom& at);
         void loadSecondary();
-        void assignSecondary(Spacer& sp);
-        int parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa);
+        void assignSecondary(Spacer& sp, char id);
+        int parsePDBline(const char* atomLine, unsigned int length, bool hetAtom,
+                Ligand* lig, AminoAcid* aa);
+
+        struct ChainData;
+        class ChainLoop;
+        void processChain(ChainData& data, char id);
+        void readBuffer(string& buffer);
+        static bool nextLine(const string& buffer, string::size_type& pos,
+                const char*& line, unsigned int& length);
+        void insertResidue(ChainData& data);
+
+        /// True if line starts with tag.
+        static bool hasTag(const char* line, unsigned int length, const char* tag) {
+            unsigned int n = strlen(tag);
+            return (length >= n) && (strncmp(line, tag, n) == 0);
+        }
+
+        /// Character at column i of line, blank past its end.
+        static char column(const char* line, unsigned int length, unsigned int i) {
+            return (i < length) ? line[i] : ' ';
+        }
+
+        /// Width of the field of line starting at column i, clipped to its end.
+        static unsigned int field(unsigned int length, unsigned int i, unsigned int width) {
+            return (i >= length) ? 0 : ((length - i < width) ? length - i : width);
+        }
 
 
 
@@ -189,6 +227,7 @@ namespace Victor { namespace Biopool {
         vector<pair<int, int> > helixData; //inizio e fine dell'elica
         vector<pair<int, int> > sheetData;
 
+        unsigned int threads; // chains built concurrently, 0 = one per core
     };
 
 }} //namespace
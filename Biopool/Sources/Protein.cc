@@ -17,25 +17,54 @@
 
 // Includes:
 #include <Protein.h>
+#include <ThreadPool.h>
 #include <iostream>
 using namespace std;
 using namespace Victor; using namespace Victor::Biopool;
 
 using namespace Victor::Biopool;
 
+// Global constants, typedefs, etc. (to avoid):
+
+/**
+ *  Body of setDSSP(): assigns the secondary structure of chain i.
+ */
+class DSSPLoop : public ThreadPool::Loop {
+public:
+
+    DSSPLoop(Protein& prot, bool verbose) : prot(prot), verbose(verbose) {
+    }
+
+    virtual void run(unsigned int i, unsigned int worker) {
+        Spacer* sp = prot.getSpacer(i);
+        if (sp->sizeAmino() > 0)
+            sp->setDSSP(verbose);
+    }
+
+private:
+    Protein& prot;
+    bool verbose;
+};
+
 // CONSTRUCTORS/DESTRUCTOR:
 
-Protein::Protein() : Polymer(1, 1) {
+Protein::Protein() : Polymer(1, 1), arena(NULL) {
     PRINT_NAME;
 }
 
-Protein::Protein(const Protein& orig) {
+Protein::Protein(const Protein& orig) : arena(NULL) {
     PRINT_NAME;
     this->copy(orig);
 }
 
+/**
+ *  The arena is released here, its memory goes back to the heap at once
+ *  when the chains are deleted by ~Polymer().
+ */
 Protein::~Protein() {
     PRINT_NAME;
+    if (arena != NULL)
+        arena->release();
 }
 
 // PREDICATES:
@@ -112,6 +141,19 @@ Protein::getChainNum(char c) {
             return i;
     ERROR("Chain not found", exception);
 }
+/**
+ *   Returns the chain index by its full name, e.g. a multi-character
+ *   mmCIF chain ID.
+ * @param name (const string&) chain name
+ * @return The chain index in the chains vector
+ */
+unsigned int
+Protein::getChainNum(const string& name) {
+    for (unsigned int i = 0; i < chainNames.size(); i++)
+        if (chainNames[i] == name)
+            return i;
+    ERROR("Chain not found", exception);
+}
 /**
  *   Returns the chainID by index
  * @param i (unsigned int) index
@@ -123,6 +165,28 @@ Protein::getChainLetter(unsigned int i) {
         ERROR("Index out of range", exception);
     return chains[i];
 }
+/**
+ *   Returns the full chain name by index
+ * @param i (unsigned int) index
+ * @return The chain name (string)
+ */
+string
+Protein::getChainName(unsigned int i) {
+    if (i >= chainNames.size())
+        ERROR("Index out of range", exception);
+    return chainNames[i];
+}
+
+/**
+ *   Arena the chains of this protein are allocated from when loading.
+ * @return pointer to the arena, owned by the protein
+ */
+ComponentArena*
+Protein::getArena() {
+    if (arena == NULL)
+        arena = new ComponentArena();
+    return arena;
+}
 
 // MODIFIERS:
 
@@ -142,9 +206,24 @@ void //not finished because Component::copy is not finished too
 Protein::copy(const Protein& orig) {
     PRINT_NAME;
     chains = orig.chains;
+    chainNames = orig.chainNames;
     Polymer::copy(orig);
 }
 
+/**
+ *  Assigns the DSSP secondary structure of every chain (see
+ *  Spacer::setDSSP). Chains are independent, so they are processed by
+ *  parallel threads, unless verbose output is requested.
+ *@param verbose print the assignment of each residue
+ *@param threads number of threads, 0 = one per available CPU
+ */
+void
+Protein::setDSSP(bool verbose, unsigned int threads) {
+    // messages are printed in chain order
+    DSSPLoop loop(*this, verbose);
+    ThreadPool::forEach(sizeProtein(), loop, verbose ? 1 : threads);
+}
+
 Protein*
 Protein::clone() {
     Protein* tmp = new Protein;
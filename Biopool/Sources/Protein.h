@@ -23,6 +23,7 @@
 #include <Polymer.h>
 #include <Spacer.h>
 #include <LigandSet.h>
+#include <ComponentArena.h>
 
 namespace Victor { namespace Biopool { 
     
@@ -55,13 +56,17 @@ namespace Victor { namespace Biopool {
 
         const unsigned int sizeProtein() const;
         unsigned int getChainNum(char c);
+        unsigned int getChainNum(const string& name);
         char getChainLetter(unsigned int i);
+        string getChainName(unsigned int i); // full ID, may be longer than a letter
         vector <char> getAllChains();
+        ComponentArena* getArena();
 
         void save(Saver& s); // data saver                  
 
         // MODIFIERS:
         void addChain(char c);
+        void addChain(const string& name);
         void insertComponent(Component* c);
         void setChainSelection();
         void removeComponent(Component* c);
@@ -69,6 +74,7 @@ namespace Victor { namespace Biopool {
 
         void copy(const Protein& orig);
         void load(Loader& l); // data loader                 
+        void setDSSP(bool verbose = false, unsigned int threads = 0);
 
         virtual Protein* clone();
 
@@ -83,6 +89,8 @@ namespace Victor { namespace Biopool {
         // ATTRIBUTES 
     private:
         vector<char> chains;
+        vector<string> chainNames; // parallel to chains
+        ComponentArena* arena; // memory for the loaded chains, created on demand
         
     };
     // ---------------------------------------------------------------------------
@@ -107,6 +115,12 @@ namespace Victor { namespace Biopool {
 
     inline void Protein::addChain(char c) {
         chains.push_back(c);
+        chainNames.push_back(string(1, c));
+    }
+
+    inline void Protein::addChain(const string& name) {
+        chains.push_back(name.empty() ? ' ' : name[0]);
+        chainNames.push_back(name);
     }
 
     inline void Protein::load(Loader& l) {
@@ -0,0 +1,272 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <RmsdMatrix.h>
+#include <ThreadPool.h>
+#include <algorithm>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Models per block: a pair of blocks of small models fits in L1/L2.
+static const unsigned int BLOCK_SIZE = 32;
+
+/**
+ *  Pairs of blocks processed by the build() threads.
+ */
+class RmsdLoop : public ThreadPool::Loop {
+public:
+    virtual void run(unsigned int b, unsigned int worker);
+
+    const float* coords;
+    const double* halfNorm;
+    float* rmsd;
+    unsigned int nAtoms;
+    unsigned int nModels;
+    vector<pair<unsigned int, unsigned int> > blocks;
+};
+
+/**
+ *  RMSD of two centred models stored as x[n], y[n], z[n].
+ */
+static double
+sPairRmsd(const float* a, const float* b, unsigned int n, double e0) {
+    const float *ax = a, *ay = a + n, *az = a + 2 * n;
+    const float *bx = b, *by = b + n, *bz = b + 2 * n;
+    double sxx = 0.0, sxy = 0.0, sxz = 0.0, syx = 0.0, syy = 0.0, syz = 0.0,
+            szx = 0.0, szy = 0.0, szz = 0.0;
+    for (unsigned int k = 0; k < n; k++) {
+        double rx = ax[k], ry = ay[k], rz = az[k];
+        double mx = bx[k], my = by[k], mz = bz[k];
+        sxx += mx * rx;
+        sxy += mx * ry;
+        sxz += mx * rz;
+        syx += my * rx;
+        syy += my * ry;
+        syz += my * rz;
+        szx += mz * rx;
+        szy += mz * ry;
+        szz += mz * rz;
+    }
+    double inner[9] = {sxx, sxy, sxz, syx, syy, syz, szx, szy, szz};
+    return Superposition::qcpRmsd(inner, e0, n);
+}
+
+void
+RmsdLoop::run(unsigned int b, unsigned int worker) {
+    const unsigned long models = nModels;
+    const unsigned long stride = 3 * static_cast<unsigned long> (nAtoms);
+
+    unsigned int iStart = blocks[b].first * BLOCK_SIZE;
+    unsigned int jStart = blocks[b].second * BLOCK_SIZE;
+    unsigned int iEnd = min(iStart + BLOCK_SIZE, nModels);
+    unsigned int jEnd = min(jStart + BLOCK_SIZE, nModels);
+    for (unsigned long i = iStart; i < iEnd; i++) {
+        const float* a = coords + i * stride;
+        // row i starts at pair (i, i + 1), modular arithmetic for i = 0
+        unsigned long row = i * models - (i * (i + 1)) / 2 - i - 1;
+        for (unsigned long j = max(static_cast<unsigned long> (jStart), i + 1);
+                j < jEnd; j++)
+            rmsd[row + j] = static_cast<float> (sPairRmsd(a, coords + j * stride,
+                nAtoms, halfNorm[i] + halfNorm[j]));
+    }
+}
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+RmsdMatrix::RmsdMatrix() : nAtoms(0), built(false) {
+    PRINT_NAME;
+}
+
+RmsdMatrix::~RmsdMatrix() {
+    PRINT_NAME;
+}
+
+
+// PREDICATES:
+
+/**
+ *  Models within a given RMSD of model i, e.g. to grow clusters.
+ *@param i model
+ *@param cutoff RMSD cutoff (included)
+ *@param result indices of the neighbours, i excluded
+ *@return void
+ */
+void
+RmsdMatrix::getNeighbors(unsigned int i, double cutoff,
+        vector<unsigned int>& result) const {
+    PRECOND(built && (i < size()), exception);
+    result.clear();
+    for (unsigned int j = 0; j < size(); j++)
+        if ((j != i) && (getRmsd(i, j) <= cutoff))
+            result.push_back(j);
+}
+
+
+// MODIFIERS:
+
+void
+RmsdMatrix::clear() {
+    nAtoms = 0;
+    coords.clear();
+    halfNorm.clear();
+    rmsd.clear();
+    built = false;
+}
+
+/**
+ *  Adds the coordinates of a view as a new model. All models must have
+ *  the same number of atoms, in corresponding order.
+ *@param view coordinates
+ *@return index of the model
+ */
+unsigned int
+RmsdMatrix::addModel(const CoordinateView<double>& view) {
+    unsigned int m = pNewModel(view.size());
+    float* x = &coords[m * 3 * static_cast<unsigned long> (nAtoms)];
+    for (unsigned int k = 0; k < nAtoms; k++) {
+        x[k] = static_cast<float> (view.getX()[k]);
+        x[nAtoms + k] = static_cast<float> (view.getY()[k]);
+        x[2 * nAtoms + k] = static_cast<float> (view.getZ()[k]);
+    }
+    pFinishModel(m);
+    return m;
+}
+
+unsigned int
+RmsdMatrix::addModel(const CoordinateView<float>& view) {
+    unsigned int m = pNewModel(view.size());
+    float* x = &coords[m * 3 * static_cast<unsigned long> (nAtoms)];
+    for (unsigned int k = 0; k < nAtoms; k++) {
+        x[k] = view.getX()[k];
+        x[nAtoms + k] = view.getY()[k];
+        x[2 * nAtoms + k] = view.getZ()[k];
+    }
+    pFinishModel(m);
+    return m;
+}
+
+/**
+ *  Adds the selected atoms of a spacer as a new model.
+ *@param sp spacer
+ *@param filter atoms of each residue to use (CA by default)
+ *@return index of the model
+ */
+unsigned int
+RmsdMatrix::addModel(Spacer& sp, NeighborGrid::AtomFilter filter) {
+    CoordinateView<double> view(sp, filter);
+    return addModel(view);
+}
+
+/**
+ *  Adds all models of an ensemble.
+ *@param ens ensemble
+ *@param code atoms to use (CA by default), X for all atoms
+ *@return void
+ */
+void
+RmsdMatrix::addModels(const Ensemble& ens, AtomCode code) {
+    vector<unsigned int> selected;
+    for (unsigned int a = 0; a < ens.sizeAtoms(); a++)
+        if ((code == X) || (ens.getAtomCode(a) == code))
+            selected.push_back(a);
+
+    for (unsigned int e = 0; e < ens.sizeModels(); e++) {
+        unsigned int m = pNewModel(selected.size());
+        float* x = &coords[m * 3 * static_cast<unsigned long> (nAtoms)];
+        const double* c = ens.getModelCoords(e);
+        for (unsigned int k = 0; k < nAtoms; k++) {
+            x[k] = static_cast<float> (c[3 * selected[k]]);
+            x[nAtoms + k] = static_cast<float> (c[3 * selected[k] + 1]);
+            x[2 * nAtoms + k] = static_cast<float> (c[3 * selected[k] + 2]);
+        }
+        pFinishModel(m);
+    }
+}
+
+/**
+ *  Computes the RMSD of all pairs of models.
+ *@param threads number of threads, 0 = one per available CPU
+ *@return void
+ */
+void
+RmsdMatrix::build(unsigned int threads) {
+    unsigned long n = size();
+    rmsd.assign(n * (n - (n > 0 ? 1 : 0)) / 2, 0.0f);
+    built = true;
+    if (n < 2)
+        return;
+
+    RmsdLoop loop;
+    loop.coords = &coords[0];
+    loop.halfNorm = &halfNorm[0];
+    loop.rmsd = &rmsd[0];
+    loop.nAtoms = nAtoms;
+    loop.nModels = n;
+    unsigned int nBlocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (unsigned int bi = 0; bi < nBlocks; bi++)
+        for (unsigned int bj = bi; bj < nBlocks; bj++)
+            loop.blocks.push_back(pair<unsigned int, unsigned int>(bi, bj));
+
+    ThreadPool::forEach(loop.blocks.size(), loop, threads);
+}
+
+
+// HELPERS:
+
+/**
+ *  Makes room for a new model of n atoms.
+ */
+unsigned int
+RmsdMatrix::pNewModel(unsigned int n) {
+    if (size() == 0)
+        nAtoms = n;
+    if ((n != nAtoms) || (n == 0))
+        ERROR("RmsdMatrix: all models must have the same, non-zero number of atoms.",
+            exception);
+    built = false;
+    rmsd.clear();
+    unsigned int m = size();
+    coords.resize((m + 1) * 3 * static_cast<unsigned long> (nAtoms));
+    halfNorm.push_back(0.0);
+    return m;
+}
+
+/**
+ *  Centres a model just added and stores its squared norm.
+ */
+void
+RmsdMatrix::pFinishModel(unsigned int m) {
+    float* x = &coords[m * 3 * static_cast<unsigned long> (nAtoms)];
+    for (unsigned int c = 0; c < 3; c++) {
+        float* v = x + c * nAtoms;
+        double center = 0.0;
+        for (unsigned int k = 0; k < nAtoms; k++)
+            center += v[k];
+        center /= nAtoms;
+        for (unsigned int k = 0; k < nAtoms; k++)
+            v[k] = static_cast<float> (v[k] - center);
+    }
+    double g = 0.0;
+    for (unsigned int k = 0; k < 3 * nAtoms; k++)
+        g += static_cast<double> (x[k]) * x[k];
+    halfNorm[m] = 0.5 * g;
+}
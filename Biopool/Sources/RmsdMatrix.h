@@ -0,0 +1,130 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _RmsdMatrix_H_
+#define _RmsdMatrix_H_
+
+
+// Includes:
+#include <Superposition.h>
+#include <Ensemble.h>
+#include <Debug.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief All-vs-all optimal superposition RMSD of a set of models.
+     * 
+     *  Models (decoys, loop candidates, ensemble members) with the same
+     *  number of corresponding atoms are added one by one; each is centred
+     *  once and stored as float x/y/z arrays. build() computes the RMSD of
+     *  every pair with QCP (see Superposition) in parallel threads, working
+     *  on blocks of models that stay in cache. The result is kept as the 
+     *  upper triangle in single precision, i.e. 200 MB for 10000 models.
+     * */
+
+    class RmsdMatrix {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        RmsdMatrix();
+        virtual ~RmsdMatrix();
+
+        // PREDICATES:
+        unsigned int size() const; // number of models
+        unsigned int sizeAtoms() const;
+        bool isBuilt() const;
+
+        double getRmsd(unsigned int i, unsigned int j) const;
+        const vector<float>& getUpperTriangle() const; // row by row, i < j
+        void getNeighbors(unsigned int i, double cutoff,
+                vector<unsigned int>& result) const;
+
+        // MODIFIERS:
+        void clear();
+        unsigned int addModel(const CoordinateView<double>& view);
+        unsigned int addModel(const CoordinateView<float>& view);
+        unsigned int addModel(Spacer& sp,
+                NeighborGrid::AtomFilter filter = NeighborGrid::CA_ATOMS);
+        void addModels(const Ensemble& ens, AtomCode code = CA);
+
+        void build(unsigned int threads = 0);
+
+    protected:
+
+    private:
+        // HELPERS:
+        unsigned int pNewModel(unsigned int n);
+        void pFinishModel(unsigned int m);
+
+        RmsdMatrix(const RmsdMatrix& orig);
+        RmsdMatrix& operator=(const RmsdMatrix& orig);
+
+        // ATTRIBUTES:
+        unsigned int nAtoms;
+        vector<float> coords; // per model x[n], y[n], z[n], centred
+        vector<double> halfNorm; // half the squared norm of each model
+        vector<float> rmsd; // upper triangle
+        bool built;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                 RmsdMatrix
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int
+    RmsdMatrix::size() const {
+        return halfNorm.size();
+    }
+
+    inline unsigned int
+    RmsdMatrix::sizeAtoms() const {
+        return nAtoms;
+    }
+
+    inline bool
+    RmsdMatrix::isBuilt() const {
+        return built;
+    }
+
+    inline double
+    RmsdMatrix::getRmsd(unsigned int i, unsigned int j) const {
+        PRECOND(built && (i < size()) && (j < size()), exception);
+        if (i == j)
+            return 0.0;
+        if (i > j) {
+            unsigned int tmp = i;
+            i = j;
+            j = tmp;
+        }
+        unsigned long n = size();
+        return rmsd[i * n - (static_cast<unsigned long> (i) * (i + 1)) / 2 + (j - i - 1)];
+    }
+
+    inline const vector<float>&
+    RmsdMatrix::getUpperTriangle() const {
+        return rmsd;
+    }
+
+}} //namespace
+
+#endif
@@ -60,13 +60,19 @@ Spacer& SeqConstructor::makeSpacer(string type, unsigned int n) {
     AminoAcid aa;
     searchReference(aa, type);
 
+    IntCoordConverter icc;
     for (unsigned int i = 0; i < n; i++) {
         AminoAcid* tmpAA = new AminoAcid(aa);
-        AminoAcid* tmpPrev = i ? &(sp->getAmino(i - 1)) : NULL;
-        buildAminoAcid(*tmpAA, tmpPrev);
+        tmpAA->setBondsFromPdbCode(false);
+        if (i)
+            icc.connectStructure(*tmpAA, sp->getAmino(i - 1));
         sp->insertComponent(tmpAA);
     }
 
+    // apply standard torsion angles to the whole chain at once
+    vector<double> phi(n, -63), psi(n, -42), omega(n, 180);
+    icc.setTorsionAngles(*sp, phi, psi, omega);
+
     return *sp;
 }
 
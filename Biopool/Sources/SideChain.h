@@ -112,6 +112,7 @@ namespace Victor { namespace Biopool {
         AminoAcid* backboneRef; // reference to backbone (aminoacid) of this
 
         friend class AminoAcid;
+        friend class SpacerSnapshot;
     };
 
     // ---------------------------------------------------------------------------
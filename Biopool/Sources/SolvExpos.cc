@@ -18,6 +18,10 @@
 
 using namespace Victor; using namespace Victor::Biopool;
 
+static const double CUTOFF = 10; // Angstrom, between representative atoms
+static const unsigned int NGB_MIN = 20; // CORE above this many neighbours
+static const double NGB_MAX = 30; // accessibility is 0 from here on
+
 SolvExpos::SolvExpos(){
 }
 SolvExpos::~SolvExpos(){
@@ -73,8 +77,6 @@ Atom& SolvExpos::getReprAtom(AminoAcid &amino) {
 unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
 
         const unsigned int start, const unsigned int end) {
-    const double CUTOFF = 10; // Angstrom
-
     AminoAcid& ta = chain.getAmino(tgt);
     Atom& tr = getReprAtom(ta);
 
@@ -98,6 +100,34 @@ unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
     return tot;
 }
 
+/**
+ *  Same as above, but only visits the residues near the target.
+ *@param grid: NeighborGrid of chain with the REPR_ATOMS filter.
+ *       chain, tgt, start, end: as above.
+ *@return number of residues, in the fragment, that are neighbour to the target
+    residue.
+ */
+unsigned int SolvExpos::getNumNeighbours(const NeighborGrid& grid, Spacer &chain,
+        const unsigned int tgt, const unsigned int start, const unsigned int end) {
+    PRECOND(grid.getFilter() == NeighborGrid::REPR_ATOMS, exception);
+    Atom& tr = getReprAtom(chain.getAmino(tgt));
+
+    vector<unsigned int> ngb;
+    grid.neighborsOf(tr, CUTOFF, ngb);
+
+    unsigned int tot = 0;
+    for (unsigned int k = 0; k < ngb.size(); k++) {
+        unsigned int i = grid.getResidue(ngb[k]);
+        if ((i >= start) && (i < end))
+            tot++;
+    }
+
+    if ((tgt >= start) && (tgt < end))
+        tot--;
+
+    return tot;
+}
+
 /**
  *  in the case of a C-terminal fragment, 'end' is assumed to be the index of
  *    a fictitious residue after the entire protein chain.
@@ -114,13 +144,23 @@ unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
  */
 SolvExpos::SolvExposEnum SolvExpos::getSolvExpos(Spacer &chain, const unsigned int tgt,
         const unsigned int start, const unsigned int end) {
-    const unsigned int NGB_MIN = 20;
-
     unsigned int ngb = getNumNeighbours(chain, tgt, start, end);
 
     return (ngb > NGB_MIN) ? CORE : EXPOSED;
 }
 
+/**
+ *  Same as above, counting the neighbours with a NeighborGrid of chain
+ *    (REPR_ATOMS filter), which is much faster when called for every residue.
+ */
+SolvExpos::SolvExposEnum SolvExpos::getSolvExpos(const NeighborGrid& grid,
+        Spacer &chain, const unsigned int tgt, const unsigned int start,
+        const unsigned int end) {
+    unsigned int ngb = getNumNeighbours(grid, chain, tgt, start, end);
+
+    return (ngb > NGB_MIN) ? CORE : EXPOSED;
+}
+
 /**
  *  when delimiting a C-terminal fragment, tgtE and envE are assumed to be
  *    the index of a fictitious residue after the entire protein chain.
@@ -151,9 +191,10 @@ vector<SolvExpos::SolvExposEnum>* SolvExpos::getSolvExposVec(Spacer& chain,
         const unsigned int envS, const unsigned int envE) {
     const unsigned int tgtNum = tgtE - tgtS;
     vector<SolvExpos::SolvExposEnum>* seVec = new vector<SolvExpos::SolvExposEnum>(tgtNum);
+    NeighborGrid grid(chain, CUTOFF, NeighborGrid::REPR_ATOMS);
 
     for (unsigned int t = 0; t < tgtNum; ++t)
-        (*seVec)[t] = getSolvExpos(chain, tgtS + t, envS, envE);
+        (*seVec)[t] = getSolvExpos(grid, chain, tgtS + t, envS, envE);
 
     return seVec;
 }
@@ -178,13 +219,22 @@ vector<SolvExpos::SolvExposEnum>* SolvExpos::getSolvExposVec(Spacer& chain,
  */
 double SolvExpos::getSolvAccess(Spacer &chain, unsigned int tgt,
         unsigned int start, unsigned int end) {
-    const double NGB_MAX = 30;
-
     double ngb = (double) getNumNeighbours(chain, tgt, start, end);
 
     return (NGB_MAX - min(ngb, NGB_MAX)) / NGB_MAX;
 }
 
+/**
+ *  Same as above, counting the neighbours with a NeighborGrid of chain
+ *    (REPR_ATOMS filter), which is much faster when called for every residue.
+ */
+double SolvExpos::getSolvAccess(const NeighborGrid& grid, Spacer &chain,
+        unsigned int tgt, unsigned int start, unsigned int end) {
+    double ngb = (double) getNumNeighbours(grid, chain, tgt, start, end);
+
+    return (NGB_MAX - min(ngb, NGB_MAX)) / NGB_MAX;
+}
+
 /**
  *   Get Solvent accessibility vector
  *    when delimiting a C-terminal fragment, tgtE and envE are assumed to be
@@ -215,9 +265,10 @@ vector<double> SolvExpos::getSolvAccessVec(Spacer &chain, unsigned int tgtS,
     const unsigned int tgtNum = tgtE - tgtS;
 
     vector<double> seVec(tgtNum);
+    NeighborGrid grid(chain, CUTOFF, NeighborGrid::REPR_ATOMS);
 
     for (unsigned int t = 0; t < tgtNum; ++t)
-        seVec[t] = getSolvAccess(chain, tgtS + t, envS, envE);
+        seVec[t] = getSolvAccess(grid, chain, tgtS + t, envS, envE);
 
     return seVec;
 }
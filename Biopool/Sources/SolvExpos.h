@@ -18,6 +18,7 @@
 #define __SolvExpos_H__
 
 #include <Spacer.h>
+#include <NeighborGrid.h>
 
 namespace Victor { namespace Biopool { 
 
@@ -33,6 +34,9 @@ namespace Victor { namespace Biopool {
         
         SolvExposEnum getSolvExpos(Spacer &chain, const unsigned int tgt,
                 const unsigned int start, const unsigned int end);
+        SolvExposEnum getSolvExpos(const NeighborGrid& grid, Spacer &chain,
+                const unsigned int tgt, const unsigned int start,
+                const unsigned int end);
 
         vector<SolvExposEnum>* getSolvExposVec(Spacer &chain,
                 const unsigned int tgtS, const unsigned int tgtE,
@@ -40,6 +44,8 @@ namespace Victor { namespace Biopool {
 
         double getSolvAccess(Spacer &chain, unsigned int tgt,
                 unsigned int start, unsigned int end);
+        double getSolvAccess(const NeighborGrid& grid, Spacer &chain,
+                unsigned int tgt, unsigned int start, unsigned int end);
 
         vector<double> getSolvAccessVec(Spacer &chain,
                 unsigned int tgtS, unsigned int tgtE,
@@ -50,6 +56,9 @@ namespace Victor { namespace Biopool {
 
         unsigned int getNumNeighbours(Spacer &chain, const unsigned int tgt,
                 const unsigned int start, const unsigned int end);
+        unsigned int getNumNeighbours(const NeighborGrid& grid, Spacer &chain,
+                const unsigned int tgt, const unsigned int start,
+                const unsigned int end);
 
 
         
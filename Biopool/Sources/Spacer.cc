@@ -16,6 +16,8 @@
 
 // Includes:
 #include <Spacer.h>
+#include <NeighborGrid.h>
+#include <SurfaceArea.h>
 #include <Debug.h>
 #include <IntCoordConverter.h>
 #include <limits.h>
@@ -251,6 +253,19 @@ vector<pair<unsigned int, unsigned int> > Spacer::getStrandData() {
     return strandData;
 }
 
+/**
+ *  Solvent accessible surface area of every residue (Shrake-Rupley, 
+ *  heavy atoms, see SurfaceArea).
+ *@param probe radius of the solvent probe
+ *@param threads number of threads
+ *@return area of each residue in A^2
+ */
+vector<double> Spacer::getSASA(double probe, unsigned int threads) {
+    SurfaceArea sa(probe);
+    sa.calculate(*this, threads);
+    return sa.getResidueAreas();
+}
+
 
 
 // MODIFIERS:
@@ -1422,39 +1437,32 @@ bool Spacer::NMRGetMinimumCADistanceVector(const string &strFileName, vector<dou
 
     PdbLoader pdb(nmrFile);
     pdb.setNoHAtoms();
-    vector<Spacer*> arr;
-    // Remember that models go from [1..models] and not [0..models-1].
-    // We load in N spacers all the models stored in the NMR file.
+    // All the models stored in the NMR file are read in a single pass.
     // In this way we can make statistics over Ca distances.
-    unsigned int models = pdb.getMaxModelsFast();
-    for (unsigned int modelNumber = 1; modelNumber <= models; ++modelNumber) {
-        pdb.setModel(modelNumber);
-        Spacer *psp = new Spacer;
-        if (!psp)
-            return false;
-        psp->load(pdb);
-        arr.push_back(psp);
-    }
+    Ensemble ens;
+    pdb.loadEnsemble(ens);
     // First of all I read all the information about Ca distances,
     // but only if we were able to read at least one model from the NMR file.
-    if (arr.size() == 0) {
+    if (ens.sizeModels() == 0) {
         cerr << "No NMR information loaded" << endl;
         return false;
     }
 
+    // Residues are taken as PdbLoader puts them in a Spacer: known amino
+    // acids with a complete backbone.
     vector< vector< vgVector3<double> > > coords;
-    unsigned int length = arr[0]->sizeAmino();
-    for (unsigned int pos = 0; pos < length; ++pos) {
+    for (unsigned int r = 0; r < ens.sizeResidues(); ++r) {
+        int ca = ens.findAtom(r, CA);
+        if ((aminoAcidThreeLetterTranslator(ens.getResidueType(r)) == XXX)
+                || (ens.findAtom(r, N) < 0) || (ca < 0)
+                || (ens.findAtom(r, C) < 0) || (ens.findAtom(r, O) < 0))
+            continue;
+
         vector< vgVector3<double> > tmp;
-        for (vector<Spacer*>::iterator it = arr.begin(); it != arr.end(); ++it)
-            tmp.push_back((*it)->getAmino(pos)[CA].getCoords());
+        for (unsigned int m = 0; m < ens.sizeModels(); ++m)
+            tmp.push_back(ens.getCoords(m, ca));
         coords.push_back(tmp);
     }
-
-
-    // We delete the memory used by the spacers.
-    for (vector<Spacer*>::iterator it = arr.begin(); it != arr.end(); ++it)
-        delete *it;
     // Now I calculate the minimum distance, for each position, between every
     // Ca pair.
     for (vector< vector< vgVector3<double> > >::iterator it = coords.begin(); it != coords.end(); ++it) {
@@ -1482,9 +1490,27 @@ bool Spacer::NMRGetMinimumCADistanceVector(const string &strFileName, vector<dou
     return true;
 }
 
+// Maximum N-O distance and H-N-O angle of a backbone H bond
+static const double HBOND_MAX_DISTANCE = 5.2;
+static const double HBOND_MAX_ANGLE = 63.0;
+
+/**
+ *  Marks residues i and j as a bridge. Only i == j is excluded: the former
+ *  all-pairs loop tested fabs(i - j) > 2 on unsigned values, which let
+ *  every other pair through, and this is kept so assignments do not change.
+ */
+static void sSetBridge(vector<set<char> >& ss, unsigned int i, unsigned int j) {
+    if (i != j) {
+        ss[i].insert('B');
+        ss[j].insert('B');
+    }
+}
+
 /**
  *  Set the state from H bonds. 
  * H bond definition: Kabsch, Sander, Biopolymers. 1983 Dec;22(12):2577-637.
+ * Only the N atoms within HBOND_MAX_DISTANCE of each O are tested (through
+ * a NeighborGrid), and the bonds are kept as a sparse per residue list.
  */
 
 void Spacer::getBackboneHbonds() {
@@ -1492,12 +1518,12 @@ void Spacer::getBackboneHbonds() {
 
     // Variables for H bonds
     vgVector3<double> bondVector; // H-N----O=C
-    double distance;
     vgVector3<double> DCoords; // Donor  (N)
     vgVector3<double> ACoords; // Acceptor (O)
-    vgVector3<double> HCoords; // Hydrogen
     vgVector3<double> HVector;
     double Hangle; // HNO angle (D-H-A)
+    NeighborGrid donors(*this, HBOND_MAX_DISTANCE, NeighborGrid::N_ATOMS);
+    vector<unsigned int> ngb;
 
     // Varibles for Bends
     vgVector3<double> CA1Coords;
@@ -1506,44 +1532,33 @@ void Spacer::getBackboneHbonds() {
     vgVector3<double> postVector; // CA(i+2) -->  CA(i) 
     double Sangle;
 
-    // Initialize H bonds matrix
-    backboneHbonds = new bool*[sizeAmino()];
-    for (unsigned int i = 0; i < sizeAmino(); i++) {
-        backboneHbonds[i] = new bool[sizeAmino()];
-        for (unsigned int j = 0; j < sizeAmino(); j++) {
-            backboneHbonds[i][j] = false;
-        }
-    }
-
-    // Initialize ss vector
-    for (unsigned int i = 0; i < sizeAmino(); i++) {
-        set<char> tmp;
-        ss.push_back(tmp);
-    }
+    // Initialize H bonds and ss vector
+    backboneHbonds.assign(sizeAmino(), vector<unsigned int>());
+    ss.assign(sizeAmino(), set<char>());
 
     // Get H bonds for the backbone
     for (unsigned int i = 0; i < (sizeAmino()); i++) {
-        for (unsigned int j = 0; j < sizeAmino(); j++) {
-            if ((i != j) &&
-                    (getAmino(j).isMember(N)) &&
-                    (getAmino(j).isMember(H)) &&
-                    (getAmino(i).isMember(O))) {
+        if (getAmino(i).isMember(O)) {
+            ACoords = getAmino(i)[O].getCoords();
+            donors.neighborsOf(ACoords, HBOND_MAX_DISTANCE, ngb);
 
-                ACoords = getAmino(i)[O].getCoords();
-                HCoords = getAmino(j)[H].getCoords();
-                DCoords = getAmino(j)[N].getCoords();
+            for (unsigned int k = 0; k < ngb.size(); k++) {
+                unsigned int j = donors.getResidue(ngb[k]);
+                if ((i == j) || (!getAmino(j).isMember(H)))
+                    continue;
+
+                DCoords = donors.getCoords(ngb[k]);
 
                 HVector = getAmino(j)[H].getTrans();
                 bondVector = icc.calculateTrans(DCoords, ACoords);
                 Hangle = RAD2DEG * icc.getAngle(bondVector, HVector);
 
-                distance = getAmino(j)[N].distance(getAmino(i)[O]);
-
-                if ((Hangle <= 63.0) && (distance <= 5.2)) {
+                if (Hangle <= HBOND_MAX_ANGLE) {
                     // It is important to preserve the direction
-                    backboneHbonds[i][j] = true; // Rigth,   O ---> H-N
+                    backboneHbonds[i].push_back(j); // Rigth,   O ---> H-N
                 }
             }
+            sort(backboneHbonds[i].begin(), backboneHbonds[i].end());
         }
 
         // Calculate bends
@@ -1561,6 +1576,17 @@ void Spacer::getBackboneHbonds() {
     }
 }
 
+/**
+ *  Tells whether the N-H of residue don binds the O of residue acc.
+ *  Valid after getBackboneHbonds().
+ *@param acc acceptor (O) residue index
+ *@param don donor (N-H) residue index
+ *@return bool
+ */
+bool Spacer::hasBackboneHbond(unsigned int acc, unsigned int don) const {
+    return binary_search(backboneHbonds[acc].begin(), backboneHbonds[acc].end(), don);
+}
+
 
 /**
  *  Set the secondary structure (states) from H bonds.
@@ -1600,57 +1626,30 @@ void Spacer::setDSSP(bool verbose) {
     // It also calculate bends
     getBackboneHbonds();
 
-    // calculate n-Turns and bridges
-    for (unsigned int i = 0; i < sizeAmino(); i++) {
-        for (unsigned int j = 0; j < sizeAmino(); j++) {
+    // calculate n-Turns and bridges. Every pattern contains at least one
+    // H bond, so only the bonds in the sparse lists are visited: (a,b) below
+    // is an H bond O(a) ---> H-N(b).
+    const unsigned int n = sizeAmino();
+    for (unsigned int a = 0; a < n; a++) {
+        for (unsigned int k = 0; k < backboneHbonds[a].size(); k++) {
+            unsigned int b = backboneHbonds[a][k];
             // Helices
-            if (backboneHbonds[i][j]) {
-                if (j == (i + 3)) {
-                    for (unsigned int l = i + 1; l < j; l++) {
-                        ss[l].insert('3');
-                        ss[l].insert('T');
-                    }
-                }
-                if (j == (i + 4)) {
-                    for (unsigned int l = i + 1; l < j; l++) {
-                        ss[l].insert('4');
-                        ss[l].insert('T');
-                    }
-                }
-                if (j == (i + 5)) {
-                    for (unsigned int l = i + 1; l < j; l++) {
-                        ss[l].insert('5');
-                        ss[l].insert('T');
-                    }
-                }
-            }
-            // Bridges
-            if ( fabs(i - j) > 2) { // Avoid overlapping stretches of 3 residues
-                // Parallel bridges
-                if ((i > 0) && (i < (sizeAmino() - 1))) {
-                    if ((backboneHbonds[i - 1][j]) && (backboneHbonds[j][i + 1])) {
-                        ss[i].insert('B');
-                        ss[j].insert('B');
-                    }
-                }
-                if ((j > 0) && (j < (sizeAmino() - 1))) {
-                    if ((backboneHbonds[j - 1][i]) && (backboneHbonds[i][j + 1])) {
-                        ss[i].insert('B');
-                        ss[j].insert('B');
-                    }
-                }
-                // Antiparallel bridges
-                if ((backboneHbonds[i][j]) && (backboneHbonds[j][i])) {
-                    ss[i].insert('B');
-                    ss[j].insert('B');
-                }
-                if ((j > 0) && (j < (sizeAmino() - 1)) && (i > 0) && (i < (sizeAmino() - 1))) {
-                    if ((backboneHbonds[i - 1][j + 1]) && (backboneHbonds[j - 1][i + 1])) {
-                        ss[i].insert('B');
-                        ss[j].insert('B');
-                    }
+            if ((b >= a + 3) && (b <= a + 5)) {
+                char turn = '0' + (b - a);
+                for (unsigned int l = a + 1; l < b; l++) {
+                    ss[l].insert(turn);
+                    ss[l].insert('T');
                 }
             }
+            // Parallel bridge (i-1,j) && (j,i+1) with i = a + 1, j = b
+            if ((a + 2 < n) && hasBackboneHbond(b, a + 2))
+                sSetBridge(ss, a + 1, b);
+            // Antiparallel bridge (i,j) && (j,i) with i = a, j = b
+            if (hasBackboneHbond(b, a))
+                sSetBridge(ss, a, b);
+            // Antiparallel bridge (i-1,j+1) && (j-1,i+1) with i = a + 1, j = b - 1
+            if ((a + 2 < n) && (b > 1) && hasBackboneHbond(b - 2, a + 2))
+                sSetBridge(ss, a + 1, b - 1);
         }
     }
 
@@ -1663,8 +1662,9 @@ void Spacer::setDSSP(bool verbose) {
             for (unsigned int l = 0; l < turns.size(); l++) {
                 set<char> ::iterator it = ss[i].find(turns[l]);
                 if (it != ss[i].end()) { // found a n-turn
-                    char pos_s = *it;
-                    int pos = atoi(&(pos_s));
+                    int pos = *it - '0';
+                    if (i + pos - 1 >= sizeAmino())
+                        continue;
                     set<char> ::iterator it1 = ss[i + pos - 1].find(turns[l]);
                     if (it1 != ss[i + pos - 1].end()) { // found the same n-turn after n-1 positions
                         bool helixBreak = false;
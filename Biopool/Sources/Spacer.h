@@ -86,6 +86,7 @@ namespace Victor { namespace Biopool {
 
         vector<pair<unsigned int, unsigned int> > getHelixData();
         vector<pair<unsigned int, unsigned int> > getStrandData();
+        vector<double> getSASA(double probe = 1.4, unsigned int threads = 1);
 
         // MODIFIERS:
 
@@ -211,6 +212,7 @@ namespace Victor { namespace Biopool {
         void modifySubSpacerList(Spacer*, int);
         void updateSubSpacerList();
         void getBackboneHbonds(); // backbone H bonds (for SS)
+        bool hasBackboneHbond(unsigned int acc, unsigned int don) const;
 
         // ATTRIBUTES
 
@@ -221,7 +223,8 @@ namespace Victor { namespace Biopool {
         pair<unsigned int, unsigned int> getSubSpacerListEntry(unsigned int);
         pair<unsigned int, unsigned int> getSubSpacerListEntry(unsigned int) const;
 
-        bool **backboneHbonds;
+        // for each residue, the residues whose N-H binds its O (sorted)
+        vector<vector<unsigned int> > backboneHbonds;
         vector<set<char > > ss;
 
     private:
@@ -0,0 +1,192 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <SpacerSnapshot.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Takes the base snapshot of a spacer, after synchronising it.
+ *@param sp spacer
+ */
+SpacerSnapshot::SpacerSnapshot(Spacer& sp) : sp(&sp) {
+    sp.sync();
+    for (unsigned int r = 0; r < sp.sizeAmino(); r++) {
+        residueStart.push_back(atoms.size());
+        AminoAcid& aa = sp.getAmino(r);
+        for (unsigned int k = 0; k < aa.size(); k++)
+            atoms.push_back(&aa[k]);
+    }
+    residueStart.push_back(atoms.size());
+    first = sp.sizeAmino();
+    commit();
+}
+
+SpacerSnapshot::~SpacerSnapshot() {
+    PRINT_NAME;
+}
+
+
+// MODIFIERS:
+
+/**
+ *  Records the atoms of the touched residues that differ from the base.
+ *@return delta of the current state against the base
+ */
+SpacerSnapshot::Delta
+SpacerSnapshot::getDelta() const {
+    Delta d;
+    d.first = first;
+    if (!isModified())
+        return d;
+
+    AtomState state;
+    for (unsigned int i = residueStart[first]; i < atoms.size(); i++) {
+        pRead(*atoms[i], state);
+        if (!pEqual(state, base[i])) {
+            d.atoms.push_back(i);
+            d.states.push_back(state);
+        }
+    }
+    d.residues.resize(baseResidues.size() - first);
+    for (unsigned int r = first; r < baseResidues.size(); r++)
+        pReadResidue(r, d.residues[r - first]);
+    return d;
+}
+
+/**
+ *  Restores the base and then the state recorded in a delta. The delta
+ *  must have been taken from the current base.
+ *@param d delta
+ *@return void
+ */
+void
+SpacerSnapshot::apply(const Delta& d) {
+    rollback();
+    if (d.first >= baseResidues.size())
+        return;
+    for (unsigned int k = 0; k < d.atoms.size(); k++)
+        pWrite(*atoms[d.atoms[k]], d.states[k]);
+    for (unsigned int r = d.first; r < baseResidues.size(); r++)
+        pWriteResidue(r, d.residues[r - d.first]);
+    first = d.first;
+}
+
+/**
+ *  Restores the base state of the touched residues.
+ *@return void
+ */
+void
+SpacerSnapshot::rollback() {
+    if (!isModified())
+        return;
+    for (unsigned int i = residueStart[first]; i < atoms.size(); i++)
+        pWrite(*atoms[i], base[i]);
+    for (unsigned int r = first; r < baseResidues.size(); r++)
+        pWriteResidue(r, baseResidues[r]);
+    first = baseResidues.size();
+}
+
+/**
+ *  Makes the current state the new base. Deltas taken before are no
+ *  longer valid.
+ *@return void
+ */
+void
+SpacerSnapshot::commit() {
+    unsigned int from = (baseResidues.empty()) ? 0 : first;
+    base.resize(atoms.size());
+    baseResidues.resize(sp->sizeAmino());
+    for (unsigned int i = residueStart[min(from, sp->sizeAmino())]; i < atoms.size(); i++)
+        pRead(*atoms[i], base[i]);
+    for (unsigned int r = from; r < baseResidues.size(); r++)
+        pReadResidue(r, baseResidues[r]);
+    first = baseResidues.size();
+}
+
+/**
+ *  Independent copy of the spacer in its current state.
+ *@return new spacer, to be deleted by the caller
+ */
+Spacer*
+SpacerSnapshot::materialize() const {
+    return static_cast<Spacer*> (sp->clone());
+}
+
+/**
+ *  Independent copy of the spacer with a delta applied. The snapshot is
+ *  rolled back to the base afterwards.
+ *@param d delta
+ *@return new spacer, to be deleted by the caller
+ */
+Spacer*
+SpacerSnapshot::materialize(const Delta& d) {
+    apply(d);
+    Spacer* copy = materialize();
+    rollback();
+    return copy;
+}
+
+
+// HELPERS:
+
+void
+SpacerSnapshot::pRead(const Atom& at, AtomState& state) {
+    state.coords = at.coords;
+    state.trans = at.trans;
+    state.rot = at.rot;
+    state.modified = at.modified;
+}
+
+void
+SpacerSnapshot::pWrite(Atom& at, const AtomState& state) {
+    at.coords = state.coords;
+    at.trans = state.trans;
+    at.rot = state.rot;
+    at.modified = state.modified;
+}
+
+void
+SpacerSnapshot::pReadResidue(unsigned int r, ResidueState& state) const {
+    const AminoAcid& aa = sp->getAmino(r);
+    state.phi = aa.phi;
+    state.psi = aa.psi;
+    state.omega = aa.omega;
+    state.chi = aa.sideChain.chi;
+}
+
+void
+SpacerSnapshot::pWriteResidue(unsigned int r, const ResidueState& state) {
+    AminoAcid& aa = sp->getAmino(r);
+    aa.phi = state.phi;
+    aa.psi = state.psi;
+    aa.omega = state.omega;
+    aa.sideChain.chi = state.chi;
+}
+
+bool
+SpacerSnapshot::pEqual(const AtomState& a, const AtomState& b) {
+    return (a.modified == b.modified) && (a.coords == b.coords)
+            && (a.trans == b.trans) && (a.rot == b.rot);
+}
@@ -0,0 +1,199 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _SpacerSnapshot_H_
+#define _SpacerSnapshot_H_
+
+
+// Includes:
+#include <Spacer.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <matrix3.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Cheap undo for trial modifications of a Spacer.
+     * 
+     *  Taking a snapshot records the internal state of every atom (coords,
+     *  relative translation and rotation) and the cached torsion angles 
+     *  once. Trial modifications are then done on the Spacer itself; a 
+     *  torsion change or any other edit of residue i can only affect 
+     *  residues i and following, so the snapshot remembers the first 
+     *  residue touched and rollback() restores only that suffix, without 
+     *  copying or reallocating anything.
+     *  A promising trial can be kept as a Delta, which holds only the atoms
+     *  that actually differ from the base, and later applied again or 
+     *  materialized as an independent Spacer.
+     *  Edits other than the setPhi/setPsi/setOmega/setChi wrappers must be
+     *  announced with touch(). The Spacer must not gain or lose atoms while
+     *  the snapshot is in use.
+     * */
+
+    class SpacerSnapshot {
+    public:
+
+        /** Internal state of an atom. */
+        struct AtomState {
+            vgVector3<double> coords;
+            vgVector3<double> trans;
+            vgMatrix3<double> rot;
+            bool modified;
+        };
+
+        /** Cached torsion angles of a residue. */
+        struct ResidueState {
+            double phi, psi, omega;
+            vector<double> chi;
+        };
+
+        /** Atoms of a trial that differ from the base. */
+        class Delta {
+        public:
+
+            Delta() : first(0) {
+            }
+
+            unsigned int size() const {
+                return atoms.size();
+            }
+
+            unsigned int getFirstResidue() const {
+                return first;
+            }
+
+        private:
+            friend class SpacerSnapshot;
+            unsigned int first; // first residue touched
+            vector<unsigned int> atoms;
+            vector<AtomState> states;
+            vector<ResidueState> residues; // from first to the end
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        SpacerSnapshot(Spacer& sp);
+        virtual ~SpacerSnapshot();
+
+        // PREDICATES:
+        Spacer& getSpacer() const;
+        unsigned int sizeAtoms() const;
+        bool isModified() const;
+        unsigned int getFirstModified() const; // sizeAmino() if unmodified
+
+        // MODIFIERS:
+        void touch(unsigned int residue);
+        void setPhi(unsigned int residue, double a);
+        void setPsi(unsigned int residue, double a);
+        void setOmega(unsigned int residue, double a);
+        void setChi(unsigned int residue, unsigned int n, double a);
+
+        Delta getDelta() const;
+        void apply(const Delta& d);
+        void rollback();
+        void commit();
+        Spacer* materialize() const;
+        Spacer* materialize(const Delta& d);
+
+    protected:
+
+    private:
+        // HELPERS:
+        static void pRead(const Atom& at, AtomState& state);
+        static void pWrite(Atom& at, const AtomState& state);
+        void pReadResidue(unsigned int r, ResidueState& state) const;
+        void pWriteResidue(unsigned int r, const ResidueState& state);
+        static bool pEqual(const AtomState& a, const AtomState& b);
+
+        SpacerSnapshot(const SpacerSnapshot& orig);
+        SpacerSnapshot& operator=(const SpacerSnapshot& orig);
+
+        // ATTRIBUTES:
+        Spacer* sp;
+        vector<Atom*> atoms; // residue order
+        vector<unsigned int> residueStart; // first atom of each residue, +1 sentinel
+        vector<AtomState> base;
+        vector<ResidueState> baseResidues;
+        unsigned int first; // first residue touched since the base was taken
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               SpacerSnapshot
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline Spacer&
+    SpacerSnapshot::getSpacer() const {
+        return *sp;
+    }
+
+    inline unsigned int
+    SpacerSnapshot::sizeAtoms() const {
+        return atoms.size();
+    }
+
+    inline bool
+    SpacerSnapshot::isModified() const {
+        return first < baseResidues.size();
+    }
+
+    inline unsigned int
+    SpacerSnapshot::getFirstModified() const {
+        return first;
+    }
+
+    // MODIFIERS:
+
+    /** Announces that residue (and possibly the following ones) is modified. */
+    inline void
+    SpacerSnapshot::touch(unsigned int residue) {
+        PRECOND(residue < baseResidues.size(), exception);
+        if (residue < first)
+            first = residue;
+    }
+
+    inline void
+    SpacerSnapshot::setPhi(unsigned int residue, double a) {
+        touch(residue);
+        sp->getAmino(residue).setPhi(a);
+    }
+
+    inline void
+    SpacerSnapshot::setPsi(unsigned int residue, double a) {
+        touch(residue);
+        sp->getAmino(residue).setPsi(a);
+    }
+
+    inline void
+    SpacerSnapshot::setOmega(unsigned int residue, double a) {
+        touch(residue);
+        sp->getAmino(residue).setOmega(a);
+    }
+
+    inline void
+    SpacerSnapshot::setChi(unsigned int residue, unsigned int n, double a) {
+        touch(residue);
+        sp->getAmino(residue).setChi(n, a);
+    }
+
+}} //namespace
+
+#endif
@@ -0,0 +1,368 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <Superposition.h>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+static const unsigned int QCP_MAX_ITERATIONS = 50;
+static const double QCP_PRECISION = 1e-11;
+static const unsigned int JACOBI_MAX_SWEEPS = 50;
+
+/**
+ *  Centre of a set of points.
+ */
+template <class T>
+static vgVector3<double>
+sCenter(const T* x, const T* y, const T* z, unsigned int n) {
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (unsigned int k = 0; k < n; k++) {
+        sx += x[k];
+        sy += y[k];
+        sz += z[k];
+    }
+    return vgVector3<double>(sx / n, sy / n, sz / n);
+}
+
+/**
+ *  Inner products of two centred sets: inner[3 * a + b] is the sum of
+ *  mobile coordinate a times reference coordinate b. Returns half the sum 
+ *  of the squared norms of both sets (E0 of the QCP paper).
+ */
+template <class T>
+static double
+sInnerProducts(const T* rx, const T* ry, const T* rz, const vgVector3<double>& rc,
+        const T* mx, const T* my, const T* mz, const vgVector3<double>& mc,
+        unsigned int n, double inner[9]) {
+    double sxx = 0.0, sxy = 0.0, sxz = 0.0, syx = 0.0, syy = 0.0, syz = 0.0,
+            szx = 0.0, szy = 0.0, szz = 0.0, g = 0.0;
+    const double rcx = rc.x, rcy = rc.y, rcz = rc.z;
+    const double mcx = mc.x, mcy = mc.y, mcz = mc.z;
+    for (unsigned int k = 0; k < n; k++) {
+        double ax = rx[k] - rcx, ay = ry[k] - rcy, az = rz[k] - rcz;
+        double bx = mx[k] - mcx, by = my[k] - mcy, bz = mz[k] - mcz;
+        sxx += bx * ax;
+        sxy += bx * ay;
+        sxz += bx * az;
+        syx += by * ax;
+        syy += by * ay;
+        syz += by * az;
+        szx += bz * ax;
+        szy += bz * ay;
+        szz += bz * az;
+        g += ax * ax + ay * ay + az * az + bx * bx + by * by + bz * bz;
+    }
+    inner[0] = sxx;
+    inner[1] = sxy;
+    inner[2] = sxz;
+    inner[3] = syx;
+    inner[4] = syy;
+    inner[5] = syz;
+    inner[6] = szx;
+    inner[7] = szy;
+    inner[8] = szz;
+    return 0.5 * g;
+}
+
+/**
+ *  Key matrix whose largest eigenvalue/eigenvector give the optimal
+ *  rotation as a quaternion (Horn 1987).
+ */
+static void
+sKeyMatrix(const double s[9], double k[4][4]) {
+    k[0][0] = s[0] + s[4] + s[8];
+    k[0][1] = s[5] - s[7];
+    k[0][2] = s[6] - s[2];
+    k[0][3] = s[1] - s[3];
+    k[1][1] = s[0] - s[4] - s[8];
+    k[1][2] = s[1] + s[3];
+    k[1][3] = s[6] + s[2];
+    k[2][2] = -s[0] + s[4] - s[8];
+    k[2][3] = s[5] + s[7];
+    k[3][3] = -s[0] - s[4] + s[8];
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < i; j++)
+            k[i][j] = k[j][i];
+}
+
+static double
+sDet3(double a, double b, double c, double d, double e, double f,
+        double g, double h, double i) {
+    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+static double
+sDet4(const double k[4][4]) {
+    double det = 0.0;
+    for (unsigned int c = 0; c < 4; c++) {
+        unsigned int c0 = (c == 0) ? 1 : 0;
+        unsigned int c1 = (c <= 1) ? 2 : 1;
+        unsigned int c2 = (c <= 2) ? 3 : 2;
+        double minor = sDet3(k[1][c0], k[1][c1], k[1][c2], k[2][c0], k[2][c1],
+                k[2][c2], k[3][c0], k[3][c1], k[3][c2]);
+        det += ((c % 2 == 0) ? 1.0 : -1.0) * k[0][c] * minor;
+    }
+    return det;
+}
+
+/**
+ *  Eigenvalues and eigenvectors (columns of v) of a symmetric 4x4 matrix
+ *  by cyclic Jacobi rotations. a is destroyed.
+ */
+static void
+sJacobi4(double a[4][4], double v[4][4], double d[4]) {
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++)
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+
+    for (unsigned int sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++) {
+        double off = 0.0;
+        for (unsigned int p = 0; p < 3; p++)
+            for (unsigned int q = p + 1; q < 4; q++)
+                off += a[p][q] * a[p][q];
+        if (off < 1e-30)
+            break;
+
+        for (unsigned int p = 0; p < 3; p++)
+            for (unsigned int q = p + 1; q < 4; q++) {
+                if (a[p][q] == 0.0)
+                    continue;
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = ((theta >= 0.0) ? 1.0 : -1.0)
+                        / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                for (unsigned int r = 0; r < 4; r++) {
+                    double arp = a[r][p], arq = a[r][q];
+                    a[r][p] = c * arp - s * arq;
+                    a[r][q] = s * arp + c * arq;
+                }
+                for (unsigned int r = 0; r < 4; r++) {
+                    double apr = a[p][r], aqr = a[q][r];
+                    a[p][r] = c * apr - s * aqr;
+                    a[q][r] = s * apr + c * aqr;
+                }
+                for (unsigned int r = 0; r < 4; r++) {
+                    double vrp = v[r][p], vrq = v[r][q];
+                    v[r][p] = c * vrp - s * vrq;
+                    v[r][q] = s * vrp + c * vrq;
+                }
+            }
+    }
+    for (unsigned int i = 0; i < 4; i++)
+        d[i] = a[i][i];
+}
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+Superposition::Superposition() : rms(0.0), rot(1), refCenter(0, 0, 0),
+mobCenter(0, 0, 0) {
+    PRINT_NAME;
+}
+
+Superposition::~Superposition() {
+    PRINT_NAME;
+}
+
+
+// PREDICATES:
+
+/**
+ *  Minimal RMSD between two sets of n points, without computing the
+ *  rotation.
+ *@return RMSD
+ */
+double
+Superposition::rmsd(const double* rx, const double* ry, const double* rz,
+        const double* mx, const double* my, const double* mz, unsigned int n) {
+    if (n == 0)
+        return 0.0;
+    double inner[9];
+    double e0 = sInnerProducts(rx, ry, rz, sCenter(rx, ry, rz, n), mx, my, mz,
+            sCenter(mx, my, mz, n), n, inner);
+    return qcpRmsd(inner, e0, n);
+}
+
+double
+Superposition::rmsd(const float* rx, const float* ry, const float* rz,
+        const float* mx, const float* my, const float* mz, unsigned int n) {
+    if (n == 0)
+        return 0.0;
+    double inner[9];
+    double e0 = sInnerProducts(rx, ry, rz, sCenter(rx, ry, rz, n), mx, my, mz,
+            sCenter(mx, my, mz, n), n, inner);
+    return qcpRmsd(inner, e0, n);
+}
+
+/**
+ *  Minimal RMSD from the inner products of two centred sets (QCP). The 
+ *  largest eigenvalue of the key matrix is found by Newton iteration on
+ *  its characteristic polynomial, starting from the upper bound e0.
+ *@param inner sum of mobile coordinate a times reference coordinate b, 
+ *      at position 3 * a + b
+ *@param e0 half the sum of the squared norms of both centred sets
+ *@param n number of points
+ *@return RMSD
+ */
+double
+Superposition::qcpRmsd(const double inner[9], double e0, unsigned int n) {
+    if (n == 0)
+        return 0.0;
+    double k[4][4];
+    sKeyMatrix(inner, k);
+
+    // K is traceless: det(lambda - K) = l^4 + c2 l^2 + c1 l + c0
+    double k2[4][4];
+    double trK2 = 0.0, trK3 = 0.0;
+    for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++) {
+            double sum = 0.0;
+            for (unsigned int l = 0; l < 4; l++)
+                sum += k[i][l] * k[l][j];
+            k2[i][j] = sum;
+        }
+    for (unsigned int i = 0; i < 4; i++) {
+        trK2 += k2[i][i];
+        for (unsigned int l = 0; l < 4; l++)
+            trK3 += k2[i][l] * k[l][i];
+    }
+    double c2 = -0.5 * trK2;
+    double c1 = -trK3 / 3.0;
+    double c0 = sDet4(k);
+
+    double lambda = e0;
+    for (unsigned int it = 0; it < QCP_MAX_ITERATIONS; it++) {
+        double l2 = lambda * lambda;
+        double f = (l2 + c2) * l2 + c1 * lambda + c0;
+        double df = 4.0 * l2 * lambda + 2.0 * c2 * lambda + c1;
+        if (df == 0.0)
+            break;
+        double delta = f / df;
+        lambda -= delta;
+        if (fabs(delta) < QCP_PRECISION * fabs(lambda))
+            break;
+    }
+
+    double msd = 2.0 * (e0 - lambda) / n;
+    return (msd > 0.0) ? sqrt(msd) : 0.0;
+}
+
+
+// MODIFIERS:
+
+/**
+ *  Computes the rotation and translation moving the mobile set onto the
+ *  reference set with minimal RMSD.
+ *@return RMSD
+ */
+double
+Superposition::superimpose(const double* rx, const double* ry, const double* rz,
+        const double* mx, const double* my, const double* mz, unsigned int n) {
+    PRECOND(n > 0, exception);
+    double inner[9];
+    refCenter = sCenter(rx, ry, rz, n);
+    mobCenter = sCenter(mx, my, mz, n);
+    double e0 = sInnerProducts(rx, ry, rz, refCenter, mx, my, mz, mobCenter,
+            n, inner);
+    pSetRotation(inner);
+    rms = qcpRmsd(inner, e0, n);
+    return rms;
+}
+
+double
+Superposition::superimpose(const float* rx, const float* ry, const float* rz,
+        const float* mx, const float* my, const float* mz, unsigned int n) {
+    PRECOND(n > 0, exception);
+    double inner[9];
+    refCenter = sCenter(rx, ry, rz, n);
+    mobCenter = sCenter(mx, my, mz, n);
+    double e0 = sInnerProducts(rx, ry, rz, refCenter, mx, my, mz, mobCenter,
+            n, inner);
+    pSetRotation(inner);
+    rms = qcpRmsd(inner, e0, n);
+    return rms;
+}
+
+/**
+ *  Moves the coordinates of a view with the last superposition. Call
+ *  scatter() on the view to move its atoms.
+ *@param view coordinates in the mobile frame
+ *@return void
+ */
+void
+Superposition::apply(CoordinateView<double>& view) const {
+    double* x = view.getX();
+    double* y = view.getY();
+    double* z = view.getZ();
+    for (unsigned int i = 0; i < view.size(); i++) {
+        vgVector3<double> v = transform(vgVector3<double>(x[i], y[i], z[i]));
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+}
+
+void
+Superposition::apply(CoordinateView<float>& view) const {
+    float* x = view.getX();
+    float* y = view.getY();
+    float* z = view.getZ();
+    for (unsigned int i = 0; i < view.size(); i++) {
+        vgVector3<double> v = transform(vgVector3<double>(x[i], y[i], z[i]));
+        x[i] = static_cast<float> (v.x);
+        y[i] = static_cast<float> (v.y);
+        z[i] = static_cast<float> (v.z);
+    }
+}
+
+
+// HELPERS:
+
+/**
+ *  Rotation matrix from the quaternion of the largest eigenvalue of the
+ *  key matrix.
+ */
+void
+Superposition::pSetRotation(const double inner[9]) {
+    double k[4][4], v[4][4], d[4];
+    sKeyMatrix(inner, k);
+    sJacobi4(k, v, d);
+
+    unsigned int best = 0;
+    for (unsigned int i = 1; i < 4; i++)
+        if (d[i] > d[best])
+            best = i;
+    double q0 = v[0][best], q1 = v[1][best], q2 = v[2][best], q3 = v[3][best];
+    double norm = q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3;
+    if (norm == 0.0) {
+        rot = vgMatrix3<double>(1);
+        return;
+    }
+
+    rot.x = vgVector3<double>(q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3,
+            2.0 * (q1 * q2 - q0 * q3), 2.0 * (q1 * q3 + q0 * q2)) * (1.0 / norm);
+    rot.y = vgVector3<double>(2.0 * (q1 * q2 + q0 * q3),
+            q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3, 2.0 * (q2 * q3 - q0 * q1)) * (1.0 / norm);
+    rot.z = vgVector3<double>(2.0 * (q1 * q3 - q0 * q2), 2.0 * (q2 * q3 + q0 * q1),
+            q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3) * (1.0 / norm);
+}
@@ -0,0 +1,167 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _Superposition_H_
+#define _Superposition_H_
+
+
+// Includes:
+#include <CoordinateView.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <matrix3.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Optimal (least squares) superposition of two sets of points.
+     * 
+     *  The rotation minimising the RMSD is the eigenvector of the largest 
+     *  eigenvalue of a 4x4 key matrix built from the inner products of the 
+     *  two centred sets (quaternion form of Kabsch, Horn 1987). When only
+     *  the RMSD is needed the eigenvalue is found by Newton iteration on the
+     *  characteristic polynomial (QCP, Theobald 2005), without computing 
+     *  the rotation.
+     *  Coordinates are given as contiguous x/y/z arrays (see CoordinateView);
+     *  the inner products are plain loops over them, which the compiler 
+     *  vectorises.
+     * */
+
+    class Superposition {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        Superposition();
+        virtual ~Superposition();
+
+        // PREDICATES:
+        double getRmsd() const;
+        const vgMatrix3<double>& getRotation() const;
+        const vgVector3<double>& getReferenceCenter() const;
+        const vgVector3<double>& getMobileCenter() const;
+        vgVector3<double> transform(const vgVector3<double>& v) const;
+
+        static double rmsd(const double* rx, const double* ry, const double* rz,
+                const double* mx, const double* my, const double* mz, unsigned int n);
+        static double rmsd(const float* rx, const float* ry, const float* rz,
+                const float* mx, const float* my, const float* mz, unsigned int n);
+        static double rmsd(const CoordinateView<double>& ref,
+                const CoordinateView<double>& mob);
+        static double rmsd(const CoordinateView<float>& ref,
+                const CoordinateView<float>& mob);
+
+        static double qcpRmsd(const double inner[9], double e0, unsigned int n);
+
+        // MODIFIERS:
+        double superimpose(const double* rx, const double* ry, const double* rz,
+                const double* mx, const double* my, const double* mz, unsigned int n);
+        double superimpose(const float* rx, const float* ry, const float* rz,
+                const float* mx, const float* my, const float* mz, unsigned int n);
+        double superimpose(const CoordinateView<double>& ref,
+                const CoordinateView<double>& mob);
+        double superimpose(const CoordinateView<float>& ref,
+                const CoordinateView<float>& mob);
+
+        void apply(CoordinateView<double>& view) const;
+        void apply(CoordinateView<float>& view) const;
+
+    protected:
+
+    private:
+        // HELPERS:
+        void pSetRotation(const double inner[9]);
+
+        // ATTRIBUTES:
+        double rms;
+        vgMatrix3<double> rot; // applied to the centred mobile set
+        vgVector3<double> refCenter;
+        vgVector3<double> mobCenter;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               Superposition
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    /** RMSD after the last superimpose(). */
+    inline double
+    Superposition::getRmsd() const {
+        return rms;
+    }
+
+    /** Rotation to be applied to the mobile set after centring it. */
+    inline const vgMatrix3<double>&
+    Superposition::getRotation() const {
+        return rot;
+    }
+
+    inline const vgVector3<double>&
+    Superposition::getReferenceCenter() const {
+        return refCenter;
+    }
+
+    inline const vgVector3<double>&
+    Superposition::getMobileCenter() const {
+        return mobCenter;
+    }
+
+    /** Moves a point of the mobile frame onto the reference frame. */
+    inline vgVector3<double>
+    Superposition::transform(const vgVector3<double>& v) const {
+        return rot * (v - mobCenter) + refCenter;
+    }
+
+    inline double
+    Superposition::rmsd(const CoordinateView<double>& ref,
+            const CoordinateView<double>& mob) {
+        PRECOND(ref.size() == mob.size(), exception);
+        return rmsd(ref.getX(), ref.getY(), ref.getZ(), mob.getX(), mob.getY(),
+                mob.getZ(), ref.size());
+    }
+
+    inline double
+    Superposition::rmsd(const CoordinateView<float>& ref,
+            const CoordinateView<float>& mob) {
+        PRECOND(ref.size() == mob.size(), exception);
+        return rmsd(ref.getX(), ref.getY(), ref.getZ(), mob.getX(), mob.getY(),
+                mob.getZ(), ref.size());
+    }
+
+    // MODIFIERS:
+
+    inline double
+    Superposition::superimpose(const CoordinateView<double>& ref,
+            const CoordinateView<double>& mob) {
+        PRECOND(ref.size() == mob.size(), exception);
+        return superimpose(ref.getX(), ref.getY(), ref.getZ(), mob.getX(),
+                mob.getY(), mob.getZ(), ref.size());
+    }
+
+    inline double
+    Superposition::superimpose(const CoordinateView<float>& ref,
+            const CoordinateView<float>& mob) {
+        PRECOND(ref.size() == mob.size(), exception);
+        return superimpose(ref.getX(), ref.getY(), ref.getZ(), mob.getX(),
+                mob.getY(), mob.getZ(), ref.size());
+    }
+
+}} //namespace
+
+#endif
@@ -0,0 +1,298 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+//Includes:
+#include <SurfaceArea.h>
+#include <ThreadPool.h>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor; using namespace Victor::Biopool;
+
+// Bondi van der Waals radii
+static const double RADIUS_C = 1.70;
+static const double RADIUS_N = 1.55;
+static const double RADIUS_O = 1.52;
+static const double RADIUS_S = 1.80;
+static const double RADIUS_H = 1.10;
+static const double RADIUS_MAX = 1.80;
+
+// Neighbours are tested in blocks of this size between early exits.
+static const unsigned int OCCLUSION_BLOCK = 16;
+
+/**
+ *  Residues processed by the calculate() threads. Only reads the grid, 
+ *  and writes the areas of the atoms of its residue.
+ */
+class SurfaceArea::ResidueLoop : public ThreadPool::Loop {
+public:
+
+    ResidueLoop(SurfaceArea& sa, unsigned int threads) : sa(sa),
+    scratch(threads) {
+    }
+
+    virtual void run(unsigned int r, unsigned int worker) {
+        Scratch& s = scratch[worker];
+        for (unsigned int i = sa.grid.getResidueStart(r);
+                i < sa.grid.getResidueEnd(r); i++)
+            sa.pCalculateAtom(i, s.ngb, s.nx, s.ny, s.nz, s.nr2);
+    }
+
+private:
+
+    struct Scratch {
+        vector<unsigned int> ngb;
+        vector<double> nx, ny, nz, nr2;
+    };
+
+    SurfaceArea& sa;
+    vector<Scratch> scratch; // work vectors of each worker
+};
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Sets up the calculator.
+ *@param probe radius of the solvent probe (water: 1.4 A)
+ *@param points points per atom sphere
+ *@param withHydrogens include hydrogens (if loaded)
+ */
+SurfaceArea::SurfaceArea(double probe, unsigned int points, bool withHydrogens) :
+probe(probe), withHydrogens(withHydrogens),
+grid(2.0 * (RADIUS_MAX + probe),
+withHydrogens ? NeighborGrid::ALL_ATOMS : NeighborGrid::HEAVY_ATOMS),
+maxRadius(RADIUS_MAX) {
+    PRECOND((probe >= 0.0) && (points > 0), exception);
+
+    // golden spiral: even coverage for any number of points
+    const double increment = M_PI * (3.0 - sqrt(5.0));
+    for (unsigned int k = 0; k < points; k++) {
+        double z = 1.0 - (2.0 * k + 1.0) / points;
+        double r = sqrt(1.0 - z * z);
+        double phi = k * increment;
+        sphere.push_back(vgVector3<double>(r * cos(phi), r * sin(phi), z));
+    }
+}
+
+SurfaceArea::~SurfaceArea() {
+    PRINT_NAME;
+}
+
+
+// PREDICATES:
+
+/**
+ *  Accessible area of a residue relative to the same residue in an
+ *  extended Gly-X-Gly peptide (Tien et al. 2013).
+ *@param r residue
+ *@return relative area, can be slightly above 1
+ */
+double
+SurfaceArea::getRelativeArea(unsigned int r) const {
+    PRECOND(r < residueArea.size(), exception);
+    return residueArea[r] / getMaxResidueArea(residueCode[r]);
+}
+
+double
+SurfaceArea::getTotalArea() const {
+    double total = 0.0;
+    for (unsigned int i = 0; i < atomArea.size(); i++)
+        total += atomArea[i];
+    return total;
+}
+
+/**
+ *  Van der Waals radius from the element, i.e. the first letter of the
+ *  atom name which is not a digit.
+ *@param atomName PDB atom name
+ *@return radius
+ */
+double
+SurfaceArea::getElementRadius(const string& atomName) {
+    for (unsigned int k = 0; k < atomName.size(); k++) {
+        if (isdigit(atomName[k]) || (atomName[k] == ' '))
+            continue;
+        switch (atomName[k]) {
+            case 'C':
+                return RADIUS_C;
+            case 'N':
+                return RADIUS_N;
+            case 'O':
+                return RADIUS_O;
+            case 'S':
+                return RADIUS_S;
+            case 'H':
+                return RADIUS_H;
+            default:
+                return RADIUS_C;
+        }
+    }
+    return RADIUS_C;
+}
+
+/**
+ *  Maximal accessible area of a residue (theoretical values of Tien et al.
+ *  2013), used to normalise getRelativeArea().
+ *@param code residue type
+ *@return area in A^2
+ */
+double
+SurfaceArea::getMaxResidueArea(AminoAcidCode code) {
+    switch (code) {
+        case ALA: return 129.0;
+        case ARG: return 274.0;
+        case ASN: return 195.0;
+        case ASP: return 193.0;
+        case CYS: return 167.0;
+        case GLN: return 225.0;
+        case GLU: return 223.0;
+        case GLY: return 104.0;
+        case HIS: return 224.0;
+        case ILE: return 197.0;
+        case LEU: return 201.0;
+        case LYS: return 236.0;
+        case MET: return 224.0;
+        case PHE: return 240.0;
+        case PRO: return 159.0;
+        case SER: return 155.0;
+        case THR: return 172.0;
+        case TRP: return 285.0;
+        case TYR: return 263.0;
+        case VAL: return 174.0;
+        default: return 200.0;
+    }
+}
+
+
+// MODIFIERS:
+
+/**
+ *  Computes the accessible area of all atoms of a spacer.
+ *@param sp spacer
+ *@param threads number of threads working on different residues
+ *@return void
+ */
+void
+SurfaceArea::calculate(Spacer& sp, unsigned int threads) {
+    grid.build(sp);
+
+    residueCode.resize(sp.sizeAmino());
+    for (unsigned int r = 0; r < sp.sizeAmino(); r++)
+        residueCode[r] = static_cast<AminoAcidCode> (sp.getAmino(r).getCode());
+
+    radius.resize(grid.size());
+    maxRadius = 0.0;
+    for (unsigned int i = 0; i < grid.size(); i++) {
+        radius[i] = getElementRadius(grid.getAtom(i).getType());
+        maxRadius = max(maxRadius, radius[i]);
+    }
+    atomArea.assign(grid.size(), 0.0);
+    residueArea.assign(sp.sizeAmino(), 0.0);
+
+    if (threads == 0)
+        threads = 1; // not one per CPU as for ThreadPool
+    ResidueLoop loop(*this, threads);
+    ThreadPool::forEach(residueArea.size(), loop, threads);
+
+    for (unsigned int i = 0; i < atomArea.size(); i++)
+        residueArea[grid.getResidue(i)] += atomArea[i];
+}
+
+
+// HELPERS:
+
+/**
+ *  Accessible area of atom i. The work vectors are passed in to be 
+ *  reused between atoms.
+ */
+void
+SurfaceArea::pCalculateAtom(unsigned int i, vector<unsigned int>& ngb,
+        vector<double>& nx, vector<double>& ny, vector<double>& nz,
+        vector<double>& nr2) {
+    const vgVector3<double>& center = grid.getCoords(i);
+    const double ri = radius[i] + probe;
+
+    grid.neighborsOf(center, ri + maxRadius + probe, ngb);
+    nx.clear();
+    ny.clear();
+    nz.clear();
+    nr2.clear();
+    for (unsigned int k = 0; k < ngb.size(); k++) {
+        unsigned int j = ngb[k];
+        if (j == i)
+            continue;
+        double rj = radius[j] + probe;
+        vgVector3<double> d = grid.getCoords(j) - center;
+        if (d.square() >= (ri + rj) * (ri + rj))
+            continue;
+        // relative to the centre, so that points only need scaling
+        nx.push_back(d.x);
+        ny.push_back(d.y);
+        nz.push_back(d.z);
+        nr2.push_back(rj * rj);
+    }
+
+    const unsigned int n = nx.size();
+    const double* px = n ? &nx[0] : NULL;
+    const double* py = n ? &ny[0] : NULL;
+    const double* pz = n ? &nz[0] : NULL;
+    const double* pr2 = n ? &nr2[0] : NULL;
+    unsigned int lastOccluder = 0;
+    unsigned int accessible = 0;
+
+    for (unsigned int p = 0; p < sphere.size(); p++) {
+        const double sx = ri * sphere[p].x;
+        const double sy = ri * sphere[p].y;
+        const double sz = ri * sphere[p].z;
+
+        // neighbouring points are often hidden by the same atom
+        if (lastOccluder < n) {
+            double dx = sx - px[lastOccluder], dy = sy - py[lastOccluder],
+                    dz = sz - pz[lastOccluder];
+            if (dx * dx + dy * dy + dz * dz < pr2[lastOccluder])
+                continue;
+        }
+
+        bool buried = false;
+        for (unsigned int start = 0; (start < n) && !buried;
+                start += OCCLUSION_BLOCK) {
+            unsigned int end = min(start + OCCLUSION_BLOCK, n);
+            unsigned int hits = 0;
+            for (unsigned int k = start; k < end; k++) {
+                double dx = sx - px[k], dy = sy - py[k], dz = sz - pz[k];
+                hits += (dx * dx + dy * dy + dz * dz < pr2[k]);
+            }
+            if (hits) {
+                buried = true;
+                for (unsigned int k = start; k < end; k++) {
+                    double dx = sx - px[k], dy = sy - py[k], dz = sz - pz[k];
+                    if (dx * dx + dy * dy + dz * dz < pr2[k]) {
+                        lastOccluder = k;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!buried)
+            accessible++;
+    }
+
+    atomArea[i] = 4.0 * M_PI * ri * ri * accessible / sphere.size();
+}
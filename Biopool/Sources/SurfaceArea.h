@@ -0,0 +1,167 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _SurfaceArea_H_
+#define _SurfaceArea_H_
+
+
+// Includes:
+#include <NeighborGrid.h>
+#include <Debug.h>
+#include <vector3.h>
+#include <vector>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**@brief Solvent accessible surface area (Shrake & Rupley 1973).
+     * 
+     *  Every atom is inflated by the probe radius and covered with points
+     *  spread evenly on a golden spiral; a point is accessible if it lies
+     *  outside the inflated spheres of all other atoms. Only the neighbours
+     *  that can overlap the sphere are tested: they are found with a
+     *  NeighborGrid and copied into contiguous arrays, so the occlusion
+     *  test of each point is a short loop the compiler vectorises.
+     *  Atoms of different residues are independent, so residues can be
+     *  processed by parallel threads.
+     *  Radii are the Bondi van der Waals radii of the element (first letter 
+     *  of the atom name). Hydrogens are skipped unless requested.
+     * */
+
+    class SurfaceArea {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        SurfaceArea(double probe = 1.4, unsigned int points = 100,
+                bool withHydrogens = false);
+        virtual ~SurfaceArea();
+
+        // PREDICATES:
+        double getProbe() const;
+        unsigned int sizePoints() const;
+        unsigned int size() const; // atoms of the last calculation
+        unsigned int sizeResidues() const;
+
+        Atom& getAtom(unsigned int i) const;
+        unsigned int getResidue(unsigned int i) const;
+        double getRadius(unsigned int i) const;
+        double getAtomArea(unsigned int i) const;
+        double getResidueArea(unsigned int r) const;
+        double getRelativeArea(unsigned int r) const; // 0..1 of a free residue
+        double getTotalArea() const;
+        const vector<double>& getResidueAreas() const;
+
+        static double getElementRadius(const string& atomName);
+        static double getMaxResidueArea(AminoAcidCode code);
+
+        // MODIFIERS:
+        void calculate(Spacer& sp, unsigned int threads = 1);
+
+    protected:
+
+    private:
+        // HELPERS:
+        void pCalculateAtom(unsigned int i, vector<unsigned int>& ngb,
+                vector<double>& nx, vector<double>& ny, vector<double>& nz,
+                vector<double>& nr2);
+
+        class ResidueLoop;
+
+        SurfaceArea(const SurfaceArea& orig);
+        SurfaceArea& operator=(const SurfaceArea& orig);
+
+        // ATTRIBUTES:
+        double probe;
+        bool withHydrogens;
+        vector<vgVector3<double> > sphere; // unit points
+
+        NeighborGrid grid;
+        vector<AminoAcidCode> residueCode;
+        vector<double> radius; // van der Waals radius of each atom
+        vector<double> atomArea;
+        vector<double> residueArea;
+        double maxRadius;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                                SurfaceArea
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline double
+    SurfaceArea::getProbe() const {
+        return probe;
+    }
+
+    inline unsigned int
+    SurfaceArea::sizePoints() const {
+        return sphere.size();
+    }
+
+    inline unsigned int
+    SurfaceArea::size() const {
+        return atomArea.size();
+    }
+
+    inline unsigned int
+    SurfaceArea::sizeResidues() const {
+        return residueArea.size();
+    }
+
+    inline Atom&
+    SurfaceArea::getAtom(unsigned int i) const {
+        PRECOND(i < atomArea.size(), exception);
+        return grid.getAtom(i);
+    }
+
+    inline unsigned int
+    SurfaceArea::getResidue(unsigned int i) const {
+        PRECOND(i < atomArea.size(), exception);
+        return grid.getResidue(i);
+    }
+
+    inline double
+    SurfaceArea::getRadius(unsigned int i) const {
+        PRECOND(i < radius.size(), exception);
+        return radius[i];
+    }
+
+    /** Accessible area of an atom, in A^2. */
+    inline double
+    SurfaceArea::getAtomArea(unsigned int i) const {
+        PRECOND(i < atomArea.size(), exception);
+        return atomArea[i];
+    }
+
+    /** Accessible area of a residue, in A^2. */
+    inline double
+    SurfaceArea::getResidueArea(unsigned int r) const {
+        PRECOND(r < residueArea.size(), exception);
+        return residueArea[r];
+    }
+
+    inline const vector<double>&
+    SurfaceArea::getResidueAreas() const {
+        return residueArea;
+    }
+
+}} //namespace
+
+#endif
@@ -13,8 +13,16 @@
 #include <cppunit/TestCase.h>
 
 #include <Spacer.h>
+#include <CoordinateView.h>
+#include <RmsdMatrix.h>
+#include <SpacerSnapshot.h>
+#include <ContactMap.h>
+#include <BoundingVolumeTree.h>
 
 #include <PdbLoader.h>
+#include <PdbSaver.h>
+#include <FastPdbSaver.h>
+#include <sstream>
 
 using namespace std;
 using namespace Victor::Biopool;
@@ -43,6 +51,28 @@ public:
         suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test3 - loading amino acids from pdb without chain.",
                 &TestSpacer::testTestSpacer_C));
 
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test4 - coordinate view gather and scatter.",
+                &TestSpacer::testTestSpacer_D));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test5 - superposition of a rotated copy.",
+                &TestSpacer::testTestSpacer_E));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test6 - snapshot rollback and delta.",
+                &TestSpacer::testTestSpacer_F));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test7 - setting all torsion angles at once.",
+                &TestSpacer::testTestSpacer_G));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test8 - buffered saver writes the same pdb.",
+                &TestSpacer::testTestSpacer_H));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test9 - contact map against all pairs.",
+                &TestSpacer::testTestSpacer_I));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test10 - bounding volume tree clashes after a refit.",
+                &TestSpacer::testTestSpacer_J));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test11 - compact loading of alternate locations.",
+                &TestSpacer::testTestSpacer_K));
+
         return suiteOfTests;
     }
 
@@ -125,5 +155,286 @@ protected:
         CPPUNIT_ASSERT((sp->getAmino(0).size() == 7) && (sp->getAmino(1).size() == 5) && (sp->getAmino(2).size() == 11));
     }
 
+    void testTestSpacer_D() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+
+        CoordinateView<double> view(*sp);
+        CPPUNIT_ASSERT((view.sizeResidues() == sp->sizeAmino())
+                && (view.getResidueEnd(2) - view.getResidueStart(2) == 11));
+        CPPUNIT_ASSERT((view.getCode(1) == sp->getAmino(0)[1].getCode())
+                && (view.getX()[1] == sp->getAmino(0)[1].getCoords().x));
+
+        // move the second residue only
+        vgVector3<double> before = sp->getAmino(2)[CA].getCoords();
+        for (unsigned int i = view.getResidueStart(1); i < view.getResidueEnd(1); i++)
+            view.getY()[i] += 1.0;
+        CPPUNIT_ASSERT(view.scatter() == 5);
+        CPPUNIT_ASSERT(fabs(sp->getAmino(1)[CA].getCoords().y
+                - view.getY()[view.getResidueStart(1) + 1]) < 1e-9);
+        CPPUNIT_ASSERT(fabs(sp->getAmino(2)[CA].getCoords().y - before.y) < 1e-9);
+    }
+
+    void testTestSpacer_E() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/test.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+
+        CoordinateView<double> ref(*sp);
+        CoordinateView<double> mob(*sp);
+        vgMatrix3<double> rot = vgMatrix3<double>::createRotationMatrix(
+                vgVector3<double>(0.0, 0.6, 0.8), 1.0);
+        for (unsigned int i = 0; i < mob.size(); i++)
+            mob.setCoords(i, rot * mob.getCoords(i) + vgVector3<double>(3.0, -2.0, 1.0));
+        mob.getX()[0] += 1.0;
+
+        Superposition sup;
+        double rmsd = sup.superimpose(ref, mob);
+        double direct = 0.0;
+        for (unsigned int i = 0; i < mob.size(); i++) {
+            vgVector3<double> d = sup.transform(mob.getCoords(i)) - ref.getCoords(i);
+            direct += d * d;
+        }
+        direct = sqrt(direct / mob.size());
+        CPPUNIT_ASSERT((rmsd > 0.0) && (fabs(rmsd - direct) < 1e-6));
+
+        RmsdMatrix mat;
+        mat.addModel(ref);
+        mat.addModel(mob);
+        mat.addModel(ref);
+        mat.build(2);
+        CPPUNIT_ASSERT((fabs(mat.getRmsd(1, 0) - rmsd) < 1e-4)
+                && (mat.getRmsd(0, 2) < 1e-4));
+    }
+
+    void testTestSpacer_F() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+
+        CoordinateView<double> before(*sp);
+        SpacerSnapshot snapshot(*sp);
+        snapshot.setPsi(3, sp->getAmino(3).getPsi() + 40.0);
+        snapshot.setPhi(5, sp->getAmino(5).getPhi() - 25.0);
+        SpacerSnapshot::Delta delta = snapshot.getDelta();
+        CoordinateView<double> after(*sp);
+        CPPUNIT_ASSERT((delta.getFirstResidue() == 3) && (delta.size() > 0)
+                && (delta.size() < snapshot.sizeAtoms()));
+
+        snapshot.rollback();
+        CoordinateView<double> restored(*sp);
+        double maxDiff = 0.0;
+        for (unsigned int i = 0; i < before.size(); i++)
+            maxDiff = max(maxDiff, (restored.getCoords(i) - before.getCoords(i)).length());
+        CPPUNIT_ASSERT(maxDiff < 1e-9);
+
+        Spacer* copy = snapshot.materialize(delta);
+        CoordinateView<double> materialized(*copy);
+        maxDiff = 0.0;
+        for (unsigned int i = 0; i < after.size(); i++)
+            maxDiff = max(maxDiff, (materialized.getCoords(i) - after.getCoords(i)).length());
+        CPPUNIT_ASSERT((maxDiff < 1e-9) && !snapshot.isModified());
+        delete copy;
+    }
+
+    void testTestSpacer_G() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+        Spacer bulk(*sp);
+
+        unsigned int n = sp->sizeAmino();
+        vector<double> phi(n), psi(n), omega(n);
+        for (unsigned int i = 0; i < n; i++) {
+            phi[i] = -63.0 + (i % 7) * 3.0;
+            psi[i] = (i % 3 == 0) ? 999.0 : -42.0 + (i % 5);
+            omega[i] = 178.0;
+            sp->getAmino(i).setPhi(phi[i]);
+            sp->getAmino(i).setPsi(psi[i]);
+            sp->getAmino(i).setOmega(omega[i]);
+        }
+        IntCoordConverter icc;
+        icc.setTorsionAngles(bulk, phi, psi, omega);
+
+        CoordinateView<double> sequential(*sp);
+        CoordinateView<double> converted(bulk);
+        double maxDiff = 0.0;
+        for (unsigned int i = 0; i < sequential.size(); i++)
+            maxDiff = max(maxDiff, (converted.getCoords(i) - sequential.getCoords(i)).length());
+        CPPUNIT_ASSERT((sequential.size() == converted.size()) && (maxDiff < 1e-6));
+        CPPUNIT_ASSERT((fabs(bulk.getAmino(10).getPhi(true) - phi[10]) < 1e-6)
+                && (fabs(bulk.getAmino(10).getPsi(true) - psi[10]) < 1e-6));
+    }
+
+    void testTestSpacer_H() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        prot.load(pl);
+
+        ostringstream reference;
+        PdbSaver ps(reference);
+        prot.save(ps);
+        ps.endFile();
+
+        ostringstream buffered;
+        FastPdbSaver fps(buffered);
+        prot.save(fps);
+        fps.endFile();
+        CPPUNIT_ASSERT((reference.str().size() > 0)
+                && (buffered.str() == reference.str()));
+    }
+
+    void testTestSpacer_I() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        prot.load(pl);
+        Spacer& sp = *prot.getSpacer((unsigned int) 0);
+
+        ContactMap contacts(8.0, NeighborGrid::CA_ATOMS);
+        contacts.build(sp);
+        for (unsigned int k = 10; k < 15; k++)
+            sp.getAmino(k)[CA].setCoords(sp.getAmino(k)[CA].getCoords()
+                + vgVector3<double>(4.0, 0.0, 0.0));
+        contacts.update(10, 14);
+
+        unsigned int wrong = 0, count = 0;
+        for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+            for (unsigned int j = i + 1; j < sp.sizeAmino(); j++) {
+                bool inContact = sp.getAmino(i)[CA].distance(sp.getAmino(j)[CA]) <= 8.0;
+                count += inContact;
+                wrong += (inContact != contacts.isContact(i, j));
+            }
+        CPPUNIT_ASSERT((count > 0) && (wrong == 0)
+                && (contacts.sizeContacts() == count));
+
+        stringstream dump;
+        contacts.write(dump);
+        ContactMap copy;
+        copy.read(dump);
+        CPPUNIT_ASSERT((copy.getColumns() == contacts.getColumns())
+                && (copy.getDistances() == contacts.getDistances()));
+    }
+
+    void testTestSpacer_J() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer& sp = *prot.getSpacer((unsigned int) 0);
+
+        BoundingVolumeTree tree(NeighborGrid::HEAVY_ATOMS, 2);
+        tree.build(sp);
+        for (unsigned int k = 10; k < 15; k++)
+            for (unsigned int a = 0; a < sp.getAmino(k).size(); a++)
+                sp.getAmino(k)[a].setCoords(sp.getAmino(k)[a].getCoords()
+                    + vgVector3<double>(3.0, -2.0, 1.0));
+        tree.update(10, 14);
+
+        const double d = 3.0;
+        unsigned int count = 0, segment = 0;
+        for (unsigned int i = 0; i < tree.size(); i++)
+            for (unsigned int j = i + 1; j < tree.size(); j++) {
+                unsigned int ri = tree.getResidue(i), rj = tree.getResidue(j);
+                if ((rj < ri + 2) || (tree.getAtom(i).distance(tree.getAtom(j)) > d))
+                    continue;
+                count++;
+                segment += ((ri >= 10) && (ri <= 14)) || ((rj >= 10) && (rj <= 14));
+            }
+
+        vector<BoundingVolumeTree::Clash> clashes;
+        tree.findClashes(d, clashes);
+        CPPUNIT_ASSERT((count > 0) && (clashes.size() == count)
+                && tree.anyClash(d));
+        tree.findClashes(10, 14, d, clashes);
+        CPPUNIT_ASSERT((segment > 0) && (clashes.size() == segment)
+                && tree.anyClash(10, 14, d));
+    }
+
+    void testTestSpacer_K() {
+        string pdb =
+                "ATOM      1  N   ALA A   1      11.104   6.134  -6.504  1.00  0.00           N\n"
+                "ATOM      2  CA  ALA A   1      11.639   6.071  -5.147  1.00  0.00           C\n"
+                "ATOM      3  C   ALA A   1      13.149   5.992  -5.157  1.00  0.00           C\n"
+                "ATOM      4  O   ALA A   1      13.760   6.389  -6.148  1.00  0.00           O\n"
+                "ATOM      5  CB AALA A   1      11.226   7.285  -4.309  0.60  0.00           C\n"
+                "ATOM      6  CB BALA A   1      11.020   7.100  -4.500  0.40  0.00           C\n";
+
+        istringstream in(pdb);
+        PdbLoader pl(in);
+        pl.setNoVerbose();
+        CompactStructure cs;
+        pl.loadCompact(cs);
+        int cb = cs.findAtom(0, CB);
+        CPPUNIT_ASSERT((cs.sizeResidues() == 1) && (cs.sizeAtoms() == 5)
+                && (cb >= 0) && (fabs(cs.getCoords(cb).x - 11.226) < 1e-4));
+
+        istringstream inB(pdb);
+        PdbLoader plB(inB);
+        plB.setNoVerbose();
+        plB.setAltAtom('B');
+        plB.loadCompact(cs);
+        cb = cs.findAtom(0, CB);
+        CPPUNIT_ASSERT((cs.sizeAtoms() == 5) && (cb >= 0)
+                && (fabs(cs.getCoords(cb).x - 11.020) < 1e-4));
+    }
+
 
 };
@@ -22,6 +22,7 @@
 #include <string>
 #include <GetArg.h>
 #include <PdbLoader.h>
+#include <NeighborGrid.h>
 #include <PdbSaver.h>
 #include <SolvationPotential.h>
 #include <EffectiveSolvationPotential.h>
@@ -67,9 +68,14 @@ void sShowHelp(){
 
 double sHydrogen(Spacer& sp){
 	int count = 0;
+	// only the O atoms within 4 A of each N can make an H-bond
+	NeighborGrid oGrid(sp, 4.0, NeighborGrid::O_ATOMS);
+	vector<unsigned int> ngb;
 	
-	for (int i = 0; i <(int)sp.sizeAmino(); i++)
-		for (int j = 0; j < (int)sp.sizeAmino(); j++)
+	for (int i = 0; i < (int)sp.sizeAmino(); i++){
+		oGrid.neighborsOf(sp.getAmino(i)[N], 4.0, ngb);
+		for (unsigned int k = 0; k < ngb.size(); k++){
+			int j = oGrid.getResidue(ngb[k]);
 			if (fabs(i-j) > 1){
 				double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
 				double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
@@ -80,7 +86,9 @@ double sHydrogen(Spacer& sp){
 					break;
 				}
 			}
-				return count;
+		}
+	}
+	return count;
 }
 
 
@@ -21,6 +21,7 @@
 #include <GetArg.h>
 #include <PdbLoader.h>
 #include <Spacer.h>
+#include <ContactMap.h>
 using namespace Victor::Biopool; 
 using namespace Victor;
 
@@ -114,14 +115,11 @@ int main(int nArgs, char* argv[]){
   const double DISTANCE = 8.0;
   double corr = 0.0;
   
+  ContactMap contacts(DISTANCE, NeighborGrid::CA_ATOMS);
+  contacts.build(*sp);
+
    for (unsigned int i = 0; i < sp->sizeAmino(); i++) {
-      double count = 0.0;
-      for (unsigned int j = 0; j < i; j++)
-	if (sp->getAmino(i)[CA].distance(sp->getAmino(j)[CA]) <= DISTANCE)
-	  count++;
-      for (unsigned int j = i+1; j < sp->sizeAmino(); j++)
-	if (sp->getAmino(i)[CA].distance(sp->getAmino(j)[CA]) <= DISTANCE)
-	  count++;
+      double count = contacts.sizeContacts(i);
 
       if (count > cont[sp->getAmino(i).getCode()]){
 	  cout << "+";
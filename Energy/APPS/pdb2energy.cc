@@ -19,6 +19,8 @@
 #include <string>
 #include <GetArg.h>
 #include <PdbLoader.h>
+#include <PdbBatch.h>
+#include <NeighborGrid.h>
 #include <PdbSaver.h>
 #include <SolvationPotential.h>
 #include <PolarSolvationPotential.h>
@@ -49,6 +51,9 @@ void sShowHelp(){
        << "\t[-t <filename>] \t\t Output file for torsion histogram\n"
        << "\t[--comp <filename>] \t\t Output file for composite histogram\n"
        << "\t[-C] \t\t\t Cafasp evaluation mode\n"
+       << "\t[-I <filename>] \t Cafasp mode on a file list (one PDB file per line)\n"
+       << "\t[-d <directory>] \t Cafasp mode on all *.pdb files of a directory\n"
+       << "\t[-j <number>] \t\t Threads for -I and -d (default one per CPU)\n"
        << "\t[-w <value>] \t\t\t Sliding window size for histogram (def = 0)\n"
        << "\t[-v] \t\t\t Verbose mode\n"
        << "\t[--start <residue>] \t PDB residue for starting energy computation (def = first)\n"
@@ -112,24 +117,80 @@ Spacer& sp, unsigned int startRes){
 
 double sHydrogen(Spacer& sp){
   int count = 0;
-
-  for (int i = 0; i < static_cast<int>(sp.sizeAmino()); i++)
-    for (int j = 0; j < static_cast<int>(sp.sizeAmino()); j++)
-      if (fabs(i-j) > 1)	{
-	  double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
-	  double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
-	  double dist3 = sp.getAmino(i)[CA].distance(sp.getAmino(j)[O]);
-	  
-	  if ((dist <= 4.0) && (dist >= 2.0) && (dist < dist2)
-	      && (dist < dist3)) {
-	      count++;
-	      break;
-	    }
-	}
+  // only the O atoms within 4 A of each N can make an H-bond
+  NeighborGrid oGrid(sp, 4.0, NeighborGrid::O_ATOMS);
+  vector<unsigned int> ngb;
+  
+  for (int i = 0; i < static_cast<int>(sp.sizeAmino()); i++){
+    oGrid.neighborsOf(sp.getAmino(i)[N], 4.0, ngb);
+    for (unsigned int k = 0; k < ngb.size(); k++){
+      int j = oGrid.getResidue(ngb[k]);
+      if (fabs(i-j) > 1){
+        double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
+        double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
+        double dist3 = sp.getAmino(i)[CA].distance(sp.getAmino(j)[O]);
+        
+        if ((dist <= 4.0) && (dist >= 2.0) && (dist < dist2) && (dist < dist3)){
+          count++;
+          break;
+        }
+      }
+    }
+  }
   return count;
 }
 
 
+void sCafasp(const string& name, Spacer& sp, RapdfPotential& rapdf, 
+Potential& solv, TorsionPotential& tors, ostream& os){
+  long double res = rapdf.calculateEnergy(sp);
+  long double sres = solv.calculateEnergy(sp);
+  long double hres = - 1.0 *  sHydrogen(sp);
+  long double tres = tors.calculateEnergy(sp);
+  
+  long double sum = W_RAPDF * res + W_SOLV * sres + W_HYDB * hres 
+    + W_TORS * tres;
+  
+  os.setf(ios::fixed, ios::floatfield);
+  
+  os << name << "\t" << setw(9) << setprecision(4) 
+     << sum << "\t" << setw(9) << setprecision(4) << res << "\t" 
+     << setw(9) << setprecision(4) << sres << "\t" << setw(9) 
+     << setprecision(4) << hres << "\t" << setw(9) << setprecision(4) 
+     << tres << endl;
+}
+
+/**
+ *  Cafasp evaluation of each structure of a batch. The potentials are
+ *  shared by all files and threads.
+ */
+class CafaspTask : public StructureTask {
+public:
+  CafaspTask(RapdfPotential& _rapdf, Potential& _solv, TorsionPotential& _tors,
+  const string& _chainID) : rapdf(_rapdf), solv(_solv), tors(_tors), 
+  chainID(_chainID) {
+  }
+
+  virtual void configure(PdbLoader& pl){
+    pl.setNoHAtoms();
+    pl.setNoVerbose();
+    if (chainID != "!")
+      pl.setChain(chainID[0]);
+  }
+
+  virtual void process(const string& fileName, Protein& prot, ostream& os){
+    sCafasp(fileName, *prot.getSpacer(static_cast<unsigned int>(0)), rapdf, 
+    solv, tors, os);
+  }
+
+private:
+  RapdfPotential& rapdf;
+  Potential& solv;
+  TorsionPotential& tors;
+  string chainID;
+};
+
+
 int main(int nArgs, char* argv[]){ 
   if (getArg( "h", nArgs, argv)) {
       sShowHelp();
@@ -137,9 +198,10 @@ int main(int nArgs, char* argv[]){
     };
   vector<char> allCh; 
   string inputFile, outputFile, solvOut, rapdfOut, torOut, compOut, chainID;
+  string inputList, inputDir;
   bool verbose = getArg( "v", nArgs, argv);
   bool cafasp = getArg( "C", nArgs, argv);
-  unsigned int window;
+  unsigned int window, threads;
   getArg( "i", inputFile, nArgs, argv, "!");
   getArg( "o", outputFile, nArgs, argv, "!");
   getArg( "c", chainID, nArgs, argv, "!");
@@ -148,6 +210,9 @@ int main(int nArgs, char* argv[]){
   getArg( "t", torOut, nArgs, argv, "!");
   getArg( "-comp", compOut, nArgs, argv, "!");
   getArg( "w", window, nArgs, argv, 0);
+  getArg( "I", inputList, nArgs, argv, "!");
+  getArg( "d", inputDir, nArgs, argv, "!");
+  getArg( "j", threads, nArgs, argv, 0);
 
 
   int startRes, endRes;
@@ -158,10 +223,14 @@ int main(int nArgs, char* argv[]){
   bool newTorsion = getArg( "T", nArgs, argv);
   bool newSolvation = getArg( "S", nArgs, argv);
    
-  if (inputFile == "!") {
+  if ((inputFile == "!") && (inputList == "!") && (inputDir == "!")) {
       cout << "Missing file specification. Aborting. (-h for help)" << endl;
       return -1;
     }
+  if ((inputFile == "!") && (!cafasp)) {
+      cout << "File lists and directories need Cafasp mode (-C). Aborting." << endl;
+      return -1;
+    }
 
   Potential* solv = NULL;
 
@@ -177,6 +246,27 @@ int main(int nArgs, char* argv[]){
   else
     tors =  new PhiPsiOmegaChi1Chi2PreAngle(20);//ARCSTEP 20, ARCSTEP2 40 
 
+  // Many files: potentials are loaded once, files parsed and evaluated 
+  // in parallel, results written in list order
+  if (inputFile == "!") {
+      vector<string> files;
+      if (inputList != "!") {
+	  ifstream listFile(inputList.c_str());
+	  if (!listFile)
+	    ERROR("File list not found.", exception);
+	  files = BatchRunner::readList(listFile);
+	}
+      else
+	files = BatchRunner::readDirectory(inputDir, ".pdb");
+
+      CafaspTask task(rapdf, *solv, *tors, chainID);
+      PdbBatch batch(task, threads);
+      batch.run(files, cout);
+      for (unsigned int i = 0; i < batch.getFailed().size(); i++)
+	cerr << "Warning: could not evaluate " << batch.getFailed()[i] << "\n";
+      return 0;
+    }
+
   Spacer *sp;
   ifstream inFile(inputFile.c_str());
   if (!inFile)
@@ -248,22 +338,7 @@ int main(int nArgs, char* argv[]){
 	}
       
       if (cafasp)	{
-	  long double res = rapdf.calculateEnergy(*sp);
-	  long double sres = solv->calculateEnergy(*sp);
-	  long double hres = - 1.0 *  sHydrogen(*sp);
-	  long double tres = tors->calculateEnergy(*sp);
-	  
-	  long double sum = W_RAPDF * res + W_SOLV * sres + W_HYDB * hres 
-	    + W_TORS * tres;
-	  
-	  cout.setf(ios::fixed, ios::floatfield);
-	  
-	  cout << inputFile << "\t" << setw(9) << setprecision(4) 
-	       << sum << "\t" << setw(9) << setprecision(4) << res << "\t" 
-	       << setw(9) << setprecision(4) << sres << "\t" << setw(9) 
-	       << setprecision(4) << hres << "\t" << setw(9) << setprecision(4) 
-	       << tres << endl;
-	  
+	  sCafasp(inputFile, *sp, rapdf, *solv, *tors, cout);
 	  exit(0);
 	}
       
@@ -19,6 +19,7 @@
 #include <string>
 #include <GetArg.h>
 #include <PdbLoader.h>
+#include <NeighborGrid.h>
 #include <PdbSaver.h>
 #include <SolvationPotential.h>
 #include <RapdfPotential.h>
@@ -68,19 +69,26 @@ double sClashScore(Spacer& sp, unsigned int pos){
 
 double sHydrogen(Spacer& sp){
   int count = 0;
+  // only the O atoms within 4 A of each N can make an H-bond
+  NeighborGrid oGrid(sp, 4.0, NeighborGrid::O_ATOMS);
+  vector<unsigned int> ngb;
   
-  for (unsigned int i = 0; i < sp.sizeAmino(); i++)
-    for (unsigned int j = 0; j < sp.sizeAmino(); j++)
-      if (fabs(i-j) > 1)	{
-	  double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
-	  double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
-	  double dist3 = sp.getAmino(i)[CA].distance(sp.getAmino(j)[O]);
-	  
-	  if ((dist <= 4.0) && (dist >= 2.0) && (dist < dist2) && (dist < dist3))   {
-	      count++;
-	      break;
-	    }
-	}
+  for (unsigned int i = 0; i < sp.sizeAmino(); i++){
+    oGrid.neighborsOf(sp.getAmino(i)[N], 4.0, ngb);
+    for (unsigned int k = 0; k < ngb.size(); k++){
+      unsigned int j = oGrid.getResidue(ngb[k]);
+      if (fabs(i-j) > 1){
+        double dist = sp.getAmino(i)[N].distance(sp.getAmino(j)[O]);
+        double dist2 = sp.getAmino(i)[N].distance(sp.getAmino(j)[C]);
+        double dist3 = sp.getAmino(i)[CA].distance(sp.getAmino(j)[O]);
+        
+        if ((dist <= 4.0) && (dist >= 2.0) && (dist < dist2) && (dist < dist3)){
+          count++;
+          break;
+        }
+      }
+    }
+  }
   return count;
 }
 
@@ -18,6 +18,7 @@
 // Includes:
 #include <EffectiveSolvationPotential.h>
 #include <AminoAcidCode.h>
+#include <SurfaceArea.h>
 
 using namespace Victor;
 
@@ -28,7 +29,7 @@ using namespace Victor;
 /**
  *     Basic constructor, sets the efective solvation potential for a chain.
  */
-EffectiveSolvationPotential::EffectiveSolvationPotential() {
+EffectiveSolvationPotential::EffectiveSolvationPotential() : useSurfaceArea(false) {
 
     solvCoeff.resize(AminoAcid_CODE_SIZE);
 
@@ -69,6 +70,9 @@ EffectiveSolvationPotential::EffectiveSolvationPotential() {
  *@return energy value (long double)
  */
 long double EffectiveSolvationPotential::calculateEnergy(Spacer& sp) {
+    if (useSurfaceArea)
+        return pCalculateSurfaceEnergy(sp, 0, sp.sizeAmino());
+
     long double solv = 0.0;
 
     for (unsigned int i = 0; i < sp.sizeAmino(); i++)
@@ -84,6 +88,9 @@ long double EffectiveSolvationPotential::calculateEnergy(Spacer& sp) {
  */
 long double EffectiveSolvationPotential::calculateEnergy(Spacer& sp, unsigned int index1,
         unsigned int index2) {
+    if (useSurfaceArea)
+        return pCalculateSurfaceEnergy(sp, index1, index2);
+
     long double solv = 0.0;
 
     for (unsigned int i = index1; i < index2; i++)
@@ -133,6 +140,13 @@ double EffectiveSolvationPotential::pCalcFracBuried(unsigned int index, Spacer&
  *@return energy value (long double)
  */
 long double EffectiveSolvationPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
+    if (useSurfaceArea) {
+        for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+            if (&sp.getAmino(i) == &aa)
+                return pCalculateSurfaceEnergy(sp, i, i + 1);
+        return 0.0;
+    }
+
     long double energy = 0.0;
 
     for (unsigned int i = 1; i < sp.sizeAmino() - 1; i++) {
@@ -146,3 +160,26 @@ long double EffectiveSolvationPotential::calculateEnergy(AminoAcid& aa, Spacer&
     return energy;
 }
 
+/**
+ *  Calculates the energy of residues index1 to index2 (excluded) with the
+ *  buried fraction of their accessible surface, scaled to the 0..10 range
+ *  of pCalcFracBuried(). Chain ends are skipped as in calculateEnergy().
+ *@param spacer reference(Spacer&), first and past last residue
+ *@return energy value (long double)
+ */
+long double EffectiveSolvationPotential::pCalculateSurfaceEnergy(Spacer& sp,
+        unsigned int index1, unsigned int index2) {
+    SurfaceArea sa;
+    sa.calculate(sp);
+
+    long double energy = 0.0;
+    for (unsigned int i = max(index1, 1u); (i < index2) && (i + 1 < sp.sizeAmino()); i++) {
+        double fracBuried = 10.0 * (1.0 - min(1.0, sa.getRelativeArea(i)));
+
+        double sign = (isPolar(sp.getAmino(i)) ? -1.0 : 1.0);
+
+        energy += sign * fracBuried
+                * (solvCoeff[sp.getAmino(i).getCode()] - 60.0) / 29.8;
+    }
+    return energy;
+}
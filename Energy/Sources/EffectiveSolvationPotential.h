@@ -55,8 +55,18 @@ namespace Victor { namespace Energy {
                 unsigned int index2);
         virtual long double calculateEnergy(AminoAcid& aa, Spacer& sp);
 
+        bool getUseSurfaceArea() const {
+            return useSurfaceArea;
+        }
+
         // MODIFIERS:
 
+        /** Use the buried fraction of the solvent accessible surface (see
+         * SurfaceArea) instead of the CA neighbour estimate. */
+        void setUseSurfaceArea(bool use) {
+            useSurfaceArea = use;
+        }
+
         // OPERATORS:
 
     protected:
@@ -64,12 +74,15 @@ namespace Victor { namespace Energy {
         // HELPERS:
         bool isPolar(AminoAcid& aa);
         double pCalcFracBuried(unsigned int index, Spacer& sp);
+        long double pCalculateSurfaceEnergy(Spacer& sp, unsigned int index1,
+                unsigned int index2);
 
     private:
 
         // ATTRIBUTES:
 
         vector<double> solvCoeff;
+        bool useSurfaceArea;
 
     };
 
@@ -18,6 +18,7 @@
 #include <EnergyFeatures.h>
 #include <AminoAcidCode.h>
 #include <Spacer.h>
+#include <BoundingVolumeTree.h>
 
 using namespace Victor;
 
@@ -195,18 +196,21 @@ vector<double> EnergyFeatures::calculateChainBreaks(Spacer& sp) {
 }
 
 /**
- *  Returns the calculated  the clashes for the amino acids in the spacer
+ *  Returns the calculated  the clashes for the amino acids in the spacer,
+ *  i.e. the pairs of CA atoms closer than 2.75 A that are not sequence 
+ *  neighbours
  *@param reference of a Spacer(Spacer&)
  *@return  double containing the corresponding value ( double)
  */
 double EnergyFeatures::calculateClashes(Spacer& sp) {
+    BoundingVolumeTree caTree(NeighborGrid::CA_ATOMS, 2);
+    caTree.build(sp);
+    vector<BoundingVolumeTree::Clash> clashes;
+    caTree.findClashes(2.75, clashes);
     double clash = 0.0;
-    for (unsigned int i = 0; i < sp.sizeAmino() - 2; i++)
-        for (unsigned int j = i + 2; j < sp.sizeAmino(); j++) {
-            if (sp.getAmino(i).getAtom(CA).distance(sp.getAmino(j).getAtom(CA))
-                    < 2.75)
-                clash++;
-        }
+    for (unsigned int i = 0; i < clashes.size(); i++)
+        if (clashes[i].distance < 2.75) // the tree also returns pairs at 2.75
+            clash++;
     return clash;
 }
 
@@ -19,6 +19,7 @@
 #include <RapdfPotential.h>
 #include <AminoAcidCode.h>
 #include <Spacer.h>
+#include <NeighborGrid.h>
 #include <cstring>
 
 using namespace Victor;
@@ -28,6 +29,36 @@ using namespace Victor::Biopool;
 using namespace Victor::Energy;
 // Global constants, typedefs, etc. (to avoid):
 
+// atom pairs at 20 A or more do not contribute (see calculateEnergy(Atom&...))
+static const double RAPDF_CUTOFF = 20.0;
+
+/**
+ *  Sums the energy of the pairs reported by NeighborGrid::forEachPairWithin(),
+ *  skipping pairs of atoms of the same residue.
+ */
+class RapdfPairSum : public NeighborGrid::PairVisitor {
+public:
+
+    RapdfPairSum(RapdfPotential& pot, const NeighborGrid& grid, Spacer& sp) :
+    pot(pot), grid(grid), en(0.0) {
+        for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+            types.push_back(sp.getAmino(i).getType());
+    }
+
+    virtual void visit(unsigned int i, unsigned int j, double dist) {
+        unsigned int ri = grid.getResidue(i);
+        unsigned int rj = grid.getResidue(j);
+        if (ri != rj)
+            en += pot.calculateEnergy(grid.getAtom(i), grid.getAtom(j),
+                types[ri], types[rj]);
+    }
+
+    RapdfPotential& pot;
+    const NeighborGrid& grid;
+    vector<string> types;
+    long double en;
+};
+
 
 // CONSTRUCTORS/DESTRUCTOR:
 
@@ -65,21 +96,11 @@ RapdfPotential::RapdfPotential() {
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp) {
-    long double en = 0.0;
-    unsigned int size = sp.sizeAmino();
-    for (unsigned int i = 0; i < size - 1; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < size; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
-        }
-    }
+    NeighborGrid grid(sp, RAPDF_CUTOFF, NeighborGrid::ALL_ATOMS);
+    RapdfPairSum sum(*this, grid, sp);
+    grid.forEachPairWithin(RAPDF_CUTOFF, sum);
 
-    return en;
+    return sum.en;
 }
 
 /**
@@ -88,16 +109,19 @@ long double RapdfPotential::calculateEnergy(Spacer& sp) {
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp, unsigned int index1, unsigned int index2) {
+    NeighborGrid grid(sp, RAPDF_CUTOFF, NeighborGrid::ALL_ATOMS);
+    vector<unsigned int> ngb;
     long double en = 0.0;
     for (unsigned int i = index1; i < index2; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < index2; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
+        string aaType = sp.getAmino(i).getType();
+        for (unsigned int a = grid.getResidueStart(i); a < grid.getResidueEnd(i); a++) {
+            grid.neighborsOf(grid.getCoords(a), RAPDF_CUTOFF, ngb);
+            for (unsigned int k = 0; k < ngb.size(); k++) {
+                unsigned int ii = grid.getResidue(ngb[k]);
+                if ((ii > i) && (ii < index2))
+                    en += calculateEnergy(grid.getAtom(a), grid.getAtom(ngb[k]),
+                        aaType, sp.getAmino(ii).getType());
+            }
         }
     }
     return en;
@@ -85,10 +85,7 @@ SolvationPotential::SolvationPotential(unsigned int _resol) : sum(), binResoluti
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateSolvation(Spacer& sp) {
-    long double solv = 0.0;
-    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
-        solv += calculateSolvation(sp.getAmino(i), sp);
-    return solv;
+    return pCalculateSolvation(sp, 0, sp.sizeAmino());
 }
 
 /**
@@ -97,10 +94,7 @@ long double SolvationPotential::calculateSolvation(Spacer& sp) {
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateEnergy(Spacer& sp, unsigned int index1, unsigned int index2) {
-    long double solv = 0.0;
-    for (unsigned int i = index1; i < index2; i++)
-        solv += calculateSolvation(sp.getAmino(i), sp);
-    return solv;
+    return pCalculateSolvation(sp, index1, index2);
 }
 
 /**
@@ -176,6 +170,46 @@ long double SolvationPotential::calculateSolvation(AminoAcid& resid, AminoAcidCo
     return -propCoeff() * log(caf / ctf);
 }
 
+/**
+ *     solvation potential of the residues index1 to index2 - 1, each one with
+ *     respect to the whole spacer. The CB atoms of the spacer are put in a
+ *     NeighborGrid once, so that each residue only visits its neighbourhood.
+ *@param   reference of a Spacer(Spacer&), index for the beginning and ending position of the residues portion(unsigned int)
+ *@return    value of the total solvation potential(long double)
+ */
+long double SolvationPotential::pCalculateSolvation(Spacer& sp, unsigned int index1,
+        unsigned int index2) {
+    NeighborGrid grid(sp, SOLVATION_CUTOFF_DISTANCE, NeighborGrid::CB_ATOMS);
+    vector<unsigned int> ngb;
+    long double solv = 0.0;
+    for (unsigned int i = index1; i < index2; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        if ((aa.getCode() == GLY) || (!aa.getSideChain().isMember(CB)))
+            continue;
+        vgVector3<double> cb = aa.getSideChain()[CB].getCoords();
+        grid.neighborsOf(cb, SOLVATION_CUTOFF_DISTANCE, ngb);
+        unsigned int count = 0;
+        for (unsigned int k = 0; k < ngb.size(); k++)
+            if ((grid.getCoords(ngb[k]) - cb).square() > 0.0) // check not identical
+                count++;
+        solv += pGetSolvation(static_cast<AminoAcidCode> (aa.getCode()), count);
+    }
+    return solv;
+}
+
+/**
+ *     solvation potential of a residue type with count CB atoms around.
+ *@param  amino acid type (AminoAcidCode), count (unsigned int)
+ *@return    value of the solvation potential(long double)
+ */
+long double SolvationPotential::pGetSolvation(const AminoAcidCode type, unsigned int count) const {
+    // adapt to binResolution:
+    count /= binResolution;
+    if (count >= (MAX_BINS / binResolution))
+        count = (MAX_BINS / binResolution) - 1;
+    return -propCoeff() * log(pGetPropensity(type, count));
+}
+
 /**
  *     obtains the propensity value
  *@param  amino acid type (AminoAcidCode), count (unsigned int)
@@ -23,6 +23,7 @@
 // Includes:
 #include <vector>
 #include <Spacer.h>
+#include <NeighborGrid.h>
 #include <Potential.h>
 
 // Global constants, typedefs, etc. (to avoid):
@@ -90,6 +91,10 @@ namespace Victor { namespace Energy {
     private:
 
         // PREDICATES
+        long double pCalculateSolvation(Spacer& sp, unsigned int index1,
+                unsigned int index2);
+        long double pGetSolvation(const AminoAcidCode type,
+                unsigned int count) const;
         long double pGetPropensity(const AminoAcidCode type,
                 unsigned int count) const;
         long double pGetMaxPropensity(const AminoAcidCode type) const;
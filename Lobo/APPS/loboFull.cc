@@ -23,7 +23,7 @@
 #include <LoopTableEntry.h>
 #include <Spacer.h>
 #include <PdbLoader.h>
-#include <PdbSaver.h>
+#include <FastPdbSaver.h>
 #include <IntCoordConverter.h>
 #include <VectorTransformation.h>
 #include <StatTools.h>
@@ -271,7 +271,7 @@ int main(int nArgs, char* argv[]) {
                 ofstream outFile(tmpStr.c_str());
                 if (!outFile)
                     ERROR("Could not create file.", exception);
-                PdbSaver ps(outFile);
+                FastPdbSaver ps(outFile);
 
                 lm.setStructure(*sp2, vsp[i], index1, index2);
                 sp2->save(ps);
@@ -26,6 +26,7 @@
 #include <GetArg.h>
 #include <PdbLoader.h>
 #include <PdbSaver.h>
+#include <FastPdbSaver.h>
 #include <iostream>
 using namespace Victor;
 using namespace Victor::Lobo;
@@ -371,7 +372,7 @@ inline void saveLoopEnsemble(unsigned int index1, unsigned int index2,
         ofstream outFile(tmpStr.c_str());
         if (!outFile)
             ERROR("Could not create file.", exception);
-        PdbSaver ps(outFile);
+        FastPdbSaver ps(outFile);
         ps.setWriteAtomOnly();
 
         if (!noFullModel) {
@@ -18,6 +18,7 @@
 #include <LoopModel.h>
 #include <LoopTableEntry.h>
 #include <IntCoordConverter.h>
+#include <SpacerSnapshot.h>
 #include <String2Number.h>
 #include <queue>
 //#include <EnergyCalculatorImpl.h>
@@ -58,6 +59,9 @@ static double sDistance(vgVector3<double> xv, vgVector3<double> yv) {
     return sqrt(sqr(xv.x - yv.x) + sqr(xv.y - yv.y) + sqr(xv.z - yv.z));
 }
 
+// CA-CA distance below which loop_spacer_vdw() checks two amino acids
+static const double VDW_CHECK_THRESHOLD = 6.0;
+
 
 // CONSTRUCTORS/DESTRUCTOR:
 
@@ -107,10 +111,13 @@ LoopModel::vdwValues(Spacer& sp, unsigned int index1, unsigned int index2,
         vector<Spacer>& solVec) {
     vector<int> ret_vector;
     int count = 0; // contains the total vdw_forces of a loop (put into vector
+    BoundingVolumeTree caTree(NeighborGrid::CA_ATOMS);
+    caTree.build(sp);
 
     for (unsigned int loop = 0; loop < solVec.size(); loop++) {
         count = loop_loop_vdw(solVec[loop], index1 + 1);
-        count += loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp);
+        count += loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp,
+                caTree);
 
         ret_vector.push_back(count);
     }
@@ -130,11 +137,14 @@ vector<int>
 LoopModel::consistencyValues(Spacer& sp, unsigned int index1,
         unsigned int index2, vector<Spacer>& solVec) {
     vector<int> ret_vector;
+    BoundingVolumeTree caTree(NeighborGrid::CA_ATOMS);
+    caTree.build(sp);
     for (unsigned int loop = 0; loop < solVec.size(); loop++)
         ret_vector.push_back(calculateConsistency(sp, index1, index2,
             solVec[loop])
             + 100 * loop_loop_vdw(solVec[loop], index1 + 1)
-            + 100 * loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp)
+            + 100 * loop_spacer_vdw(solVec[loop], index1 + 1, index2 + 1, sp,
+            caTree)
             );
     return ret_vector;
 }
@@ -321,11 +331,16 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
             cout << "Attempting local optimization:\n";
         }
 
-        Spacer bestSp = solVec[svOffset];
+        // trial moves are done in place and rolled back, instead of copying
+        // the whole spacer for every attempt
+        Spacer& tmpSp = solVec[svOffset];
+        SpacerSnapshot snapshot(tmpSp);
+        SpacerSnapshot::Delta best;
+        bool improved = false;
 
         for (unsigned int i = 0; i < OPT_MAX1; i++)
             for (unsigned int j = 0; j < OPT_MAX2; j++) {
-                Spacer tmpSp = solVec[svOffset];
+                snapshot.rollback();
                 minScore = getENDRMS_WEIGHT() * calculateRms(sp, index1, index2,
                         solVec[svOffset], false)
                         + ENERGY_WEIGTH * calculateEnergy(sp, index1, index2,
@@ -344,6 +359,8 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
                 disp[2] += sRandom(curr, max - 1);
                 //  	cout << "\t" << disp[0] << "\t" << disp[1] << "\t" << disp[2] << "\n";
 
+                snapshot.touch((curr > 1) ? curr - 1 : curr);
+
                 tmpSp.getAmino(curr)[N].setCoords(
                         tmpSp.getAmino(curr)[N].getCoords() + disp);
                 tmpSp.getAmino(curr)[CA].setCoords(
@@ -383,16 +400,20 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
 
                     if (actScore < bestScore) {
                         bestScore = actScore;
-                        bestSp = tmpSp;
+                        best = snapshot.getDelta();
+                        improved = true;
                     }
                 }
             }
-        solVec[svOffset] = bestSp;
+        if (improved)
+            snapshot.apply(best);
+        else
+            snapshot.rollback();
         if (verbose) {
             cout << "-----------------------------------------\n";
-            cout << "selected = " << calculateEnergy(sp, index1, index2, bestSp)
+            cout << "selected = " << calculateEnergy(sp, index1, index2, tmpSp)
                     << "\t";
-            calculateRms(sp, index1, index2, bestSp);
+            calculateRms(sp, index1, index2, tmpSp);
         }
     }
     if (verbose) {
@@ -708,12 +729,14 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
 
     //******  
     vector<double> tmpScore;
+    BoundingVolumeTree caTree(NeighborGrid::CA_ATOMS);
+    caTree.build(sp);
     for (unsigned int i = 0; i < solVec.size(); i++) {
         solutionQueueElem sqe;
         sqe.dev = calculateConsistency(sp, index1, index2, solVec[i])
                 + 100 * loop_loop_vdw(solVec[i], index1 + 1)
                 + 100 * loop_spacer_vdw(solVec[i], index1 + 1,
-                index2 + 1, sp);
+                index2 + 1, sp, caTree);
 
         sqe.index1 = i;
         solutionQueue.push(sqe);
@@ -1927,22 +1950,45 @@ int LoopModel::loop_loop_vdw(Spacer& sp, unsigned int index1) {
  */
 int LoopModel::loop_spacer_vdw(Spacer& loop, unsigned int index1,
         unsigned int index2, Spacer& proteine) {
+    BoundingVolumeTree caTree(NeighborGrid::CA_ATOMS);
+    caTree.build(proteine);
+    return loop_spacer_vdw(loop, index1, index2, proteine, caTree);
+}
+
+/**
+ * Same as above, with the CA atoms of proteine already in a 
+ * BoundingVolumeTree. The CA atoms of the loop are put in a second tree
+ * and only the pairs of amino acids found by descending both trees are 
+ * checked. The tree can be reused for all the loops modelled on the same 
+ * proteine, and refitted with update() when a segment of it moves.
+ * 
+ * @param loop
+ * @param index1
+ * @param index2
+ * @param proteine
+ * @param caTree BoundingVolumeTree of proteine with the CA_ATOMS filter
+ * @return 
+ */
+int LoopModel::loop_spacer_vdw(Spacer& loop, unsigned int index1,
+        unsigned int index2, Spacer& proteine,
+        const BoundingVolumeTree& caTree) {
     int ret_value = 0; // used to store the resulting vdw-forces
-    const double CHECK_THRESHOLD = 6.0;
+    BoundingVolumeTree loopTree(NeighborGrid::CA_ATOMS);
+    loopTree.build(loop);
+
     // all amino acids with a distance lower than that are checked
+    vector<BoundingVolumeTree::Clash> pairs;
+    loopTree.findClashes(caTree, VDW_CHECK_THRESHOLD, pairs);
 
-    for (unsigned int i = 0; i < proteine.size(); i++) {
+    for (unsigned int k = 0; k < pairs.size(); k++) {
+        unsigned int j = loopTree.getResidue(pairs[k].atom1);
+        unsigned int i = caTree.getResidue(pairs[k].atom2);
         if (i + 2 > index1 && i < index2 + 1)
             // we are currently in the loop section of the proteine
             continue; // or at the edge of the proteine to the loop
 
-        for (unsigned int j = 0; j < loop.size(); j++) {
-            double dist = sDistance(proteine.getAmino(i)[CA].getCoords(),
-                    loop.getAmino(j)[CA].getCoords());
-            if (dist <= CHECK_THRESHOLD)
-                ret_value += amino_amino_collision(proteine.getAmino(i),
-                    loop.getAmino(j), i + 1, index1 + j + 1, 2.0);
-        }
+        ret_value += amino_amino_collision(proteine.getAmino(i),
+                loop.getAmino(j), i + 1, index1 + j + 1, 2.0);
     }
     return ret_value;
 }
@@ -23,6 +23,7 @@
 #include <LoopTable.h>
 #include <VectorTransformation.h>
 #include <Spacer.h>
+#include <BoundingVolumeTree.h>
 #include <SeqConstructor.h>
 #include <set>
 #include <ranking_helper.h>
@@ -223,6 +224,8 @@ namespace Victor { namespace Lobo {
         int loop_loop_vdw(Spacer& sp, unsigned int index1);
         int loop_spacer_vdw(Spacer& loop, unsigned int index1, unsigned int index2,
                 Spacer& proteine);
+        int loop_spacer_vdw(Spacer& loop, unsigned int index1, unsigned int index2,
+                Spacer& proteine, const BoundingVolumeTree& caTree);
 
         double sCalcEn(AminoAcid& aa, AminoAcid& aa2);
         double sICalcEn(AminoAcid& aa, AminoAcid& aa2);
@@ -325,7 +325,9 @@ namespace Phylo {
 
         for (char r1 : residues) {
             for (char r2 : residues) {
-                (*scores_map)[r1][r2] = submatrix.score[r1][r2];
+                (*scores_map)[r1][r2] = submatrix.getScore(
+                        Align2::EncodedSequence::encode(r1),
+                        Align2::EncodedSequence::encode(r2));
             }
         }
 
@@ -0,0 +1,243 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @Description:        Runs a job per input item (e.g. per file) on a 
+ *                      ThreadPool, writing the results in input order.
+ */
+
+#include <BatchRunner.h>
+#include <algorithm>
+#include <sstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace Victor;
+
+/**
+ *  Runs the job of one item on a pool worker.
+ */
+class BatchRunner::RunTask : public ThreadPool::Task {
+public:
+
+    RunTask(BatchRunner& _runner, unsigned int _index) : runner(_runner),
+    index(_index) {
+    }
+
+    virtual void run() {
+        BatchJob* job = runner.slots[index].job;
+        ostringstream os;
+        bool ok = true;
+        try {
+            job->run(os);
+        } catch (...) {
+            ok = false;
+        }
+        delete job;
+        runner.pFinish(index, os.str(), ok);
+    }
+
+private:
+    BatchRunner& runner;
+    unsigned int index;
+};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Starts the worker threads.
+ *@param threads workers running jobs, 0 = one per available CPU
+ *@param ioThreads threads loading items
+ *@param window largest number of items loaded and not yet written
+ */
+BatchRunner::BatchRunner(unsigned int threads, unsigned int ioThreads,
+        unsigned int window) : pool(threads),
+ioThreads(ioThreads > 0 ? ioThreads : 1), window(window), items(NULL),
+factory(NULL), nextLoad(0), written(0) {
+    if (this->window == 0)
+        this->window = 4 * (pool.size() + this->ioThreads);
+}
+
+// PREDICATES:
+
+/**
+ *  Reads a list of items, e.g. file names: the first word of each line.
+ *  Blank lines and lines starting with '#' are skipped.
+ *@param is input stream
+ *@return items in file order
+ */
+vector<string>
+BatchRunner::readList(istream& is) {
+    vector<string> res;
+    string line;
+    while (getline(is, line)) {
+        istringstream words(line);
+        string item;
+        if ((words >> item) && (item[0] != '#'))
+            res.push_back(item);
+    }
+    return res;
+}
+
+/**
+ *  Lists the regular files of a directory whose name ends with suffix,
+ *  in alphabetical order. Hidden files are skipped.
+ *@param dir directory
+ *@param suffix file name suffix (e.g. ".pdb"), empty for all files
+ *@return paths of the files
+ */
+vector<string>
+BatchRunner::readDirectory(const string& dir, const string& suffix) {
+    DIR* d = opendir(dir.c_str());
+    if (d == NULL)
+        ERROR("BatchRunner: cannot read directory " + dir, exception);
+
+    string prefix = dir;
+    if ((prefix.size() > 0) && (prefix[prefix.size() - 1] != '/'))
+        prefix += '/';
+    vector<string> res;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL) {
+        string name = entry->d_name;
+        if ((name.size() == 0) || (name[0] == '.') || (name.size() < suffix.size())
+                || (name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0))
+            continue;
+        struct stat st;
+        if ((stat((prefix + name).c_str(), &st) == 0) && S_ISREG(st.st_mode))
+            res.push_back(prefix + name);
+    }
+    closedir(d);
+    sort(res.begin(), res.end());
+    return res;
+}
+
+// MODIFIERS:
+
+/**
+ *  Runs the job of every item and writes their output to os in the order
+ *  of items. Items that fail are listed by getFailed() afterwards.
+ *@param items items, e.g. file names
+ *@param factory creates the job of an item
+ *@param os output stream
+ *@return void
+ */
+void
+BatchRunner::run(const vector<string>& items, BatchJobFactory& factory,
+        ostream& os) {
+    unsigned int n = items.size();
+    this->items = &items;
+    this->factory = &factory;
+    Slot empty = {NULL, "", false, true};
+    slots.assign(n, empty);
+    tasks.assign(n, static_cast<RunTask*> (NULL));
+    failed.clear();
+    nextLoad = written = 0;
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&changed, NULL);
+
+    vector<pthread_t> loaders(min(ioThreads, n));
+    unsigned int started = 0;
+    while ((started < loaders.size())
+            && (pthread_create(&loaders[started], NULL, pLoader, this) == 0))
+        started++;
+    if ((started == 0) && (n > 0)) { // no thread: load everything first
+        unsigned int oldWindow = window;
+        window = n;
+        pLoad();
+        window = oldWindow;
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        pthread_mutex_lock(&mutex);
+        while (!slots[i].finished)
+            pthread_cond_wait(&changed, &mutex);
+        string output;
+        output.swap(slots[i].output);
+        bool ok = slots[i].ok;
+        written++;
+        pthread_cond_broadcast(&changed);
+        pthread_mutex_unlock(&mutex);
+
+        os << output;
+        if (!ok)
+            failed.push_back(items[i]);
+    }
+
+    for (unsigned int t = 0; t < started; t++)
+        pthread_join(loaders[t], NULL);
+    pool.wait();
+    for (unsigned int i = 0; i < n; i++)
+        delete tasks[i];
+    tasks.clear();
+    slots.clear();
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&mutex);
+}
+
+// HELPERS:
+
+void*
+BatchRunner::pLoader(void* arg) {
+    static_cast<BatchRunner*> (arg)->pLoad();
+    return NULL;
+}
+
+/**
+ *  Loads items in order and hands them to the pool, until all items are
+ *  taken. Jobs are created under the lock, so factories need no locking.
+ */
+void
+BatchRunner::pLoad() {
+    for (;;) {
+        pthread_mutex_lock(&mutex);
+        while ((nextLoad < items->size()) && (nextLoad - written >= window))
+            pthread_cond_wait(&changed, &mutex);
+        if (nextLoad >= items->size()) {
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        unsigned int i = nextLoad++;
+        BatchJob* job = factory->create((*items)[i]);
+        tasks[i] = new RunTask(*this, i);
+        slots[i].job = job;
+        pthread_mutex_unlock(&mutex);
+
+        bool ok = false;
+        try {
+            ok = (job != NULL) && job->load();
+        } catch (...) {
+            ok = false;
+        }
+        if (ok)
+            pool.submit(tasks[i]);
+        else {
+            delete job;
+            pFinish(i, "", false);
+        }
+    }
+}
+
+/**
+ *  Stores the output of item i and wakes up the writer.
+ */
+void
+BatchRunner::pFinish(unsigned int i, const string& output, bool ok) {
+    pthread_mutex_lock(&mutex);
+    slots[i].output = output;
+    slots[i].ok = ok;
+    slots[i].finished = true;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,132 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @Description:        Runs a job per input item (e.g. per file) on a 
+ *                      ThreadPool, writing the results in input order.
+ */
+
+#ifndef _BATCH_RUNNER_H_
+#define _BATCH_RUNNER_H_
+
+#include <ThreadPool.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Victor {
+
+    /**
+     *  Work on one input item. load() does the I/O and runs on one of the
+     *  I/O threads, run() does the computation and runs on a pool worker.
+     *  Whatever run() writes to its stream is emitted in input order.
+     */
+    class BatchJob {
+    public:
+
+        virtual ~BatchJob() {
+        }
+        virtual bool load() = 0; // false: skip the item, reported as failed
+        virtual void run(ostream& os) = 0;
+    };
+
+    /**
+     *  Creates the job of each item. All jobs share the factory, which 
+     *  is the place to keep parameters and potentials loaded once.
+     */
+    class BatchJobFactory {
+    public:
+
+        virtual ~BatchJobFactory() {
+        }
+        virtual BatchJob* create(const string& item) = 0;
+    };
+
+    /**
+     *  Pipeline over a list of items: I/O threads load the items in order,
+     *  pool workers run them as soon as they are loaded, and the calling 
+     *  thread writes the output of each item once all earlier items are 
+     *  written. At most "window" items are loaded and not yet written, 
+     *  which bounds memory use on long lists.
+     */
+    class BatchRunner {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        BatchRunner(unsigned int threads = 0, unsigned int ioThreads = 2,
+                unsigned int window = 0); // window 0 = 4 items per thread
+
+        virtual ~BatchRunner() {
+        }
+
+        // PREDICATES:
+
+        unsigned int getThreads() const {
+            return pool.size();
+        }
+
+        const vector<string>& getFailed() const {
+            return failed;
+        }
+
+        static vector<string> readList(istream& is);
+        static vector<string> readDirectory(const string& dir,
+                const string& suffix = "");
+
+        // MODIFIERS:
+        void run(const vector<string>& items, BatchJobFactory& factory,
+                ostream& os);
+
+    private:
+
+        /// Item in flight.
+
+        struct Slot {
+            BatchJob* job;
+            string output;
+            bool finished;
+            bool ok; // false if loading or running failed
+        };
+        class RunTask;
+
+        // HELPERS:
+        static void* pLoader(void* arg);
+        void pLoad();
+        void pFinish(unsigned int i, const string& output, bool ok);
+
+        // not copyable: the runner owns its pool
+        BatchRunner(const BatchRunner&);
+        BatchRunner& operator=(const BatchRunner&);
+
+        // ATTRIBUTES:
+        ThreadPool pool;
+        unsigned int ioThreads;
+        unsigned int window;
+        vector<string> failed; // items whose load() failed, in input order
+
+        // state of the current run(), guarded by mutex
+        const vector<string>* items;
+        BatchJobFactory* factory;
+        vector<Slot> slots;
+        vector<RunTask*> tasks;
+        unsigned int nextLoad;
+        unsigned int written;
+        pthread_mutex_t mutex;
+        pthread_cond_t changed;
+    };
+
+} // namespace
+
+#endif
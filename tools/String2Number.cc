@@ -14,6 +14,9 @@
     along with Victor.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "String2Number.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
 /**
  * @Description string to integer
@@ -139,6 +142,73 @@ double stodDEF(const string &s) {
     return d;
 }
 
+/**
+ * @Description fixed width field to integer, e.g. a PDB column. Parses in
+ * place: leading blanks are skipped and the number ends at the first
+ * character that is not a digit.
+ * @param s first character of the field
+ * @param n width of the field
+ */
+int stoiDEF(const char* s, unsigned int n) {
+    unsigned int p = 0;
+    while ((p < n) && isspace(s[p]))
+        p++;
+
+    bool negative = false;
+    if ((p < n) && ((s[p] == '-') || (s[p] == '+'))) {
+        negative = (s[p] == '-');
+        p++;
+    }
+
+    if ((p >= n) || (s[p] < '0') || (s[p] > '9')) {
+        cerr << "\"" << string(s, n) << "\" is no integer!!" << endl;
+        ERROR("Integer expected", exception);
+    }
+
+    int i = 0;
+    for (; (p < n) && (s[p] >= '0') && (s[p] <= '9'); p++)
+        i = 10 * i + (s[p] - '0');
+
+    return negative ? -i : i;
+}
+
+/**
+ * @Description fixed width field to unsigned integer, see stoiDEF()
+ * @param s first character of the field
+ * @param n width of the field
+ */
+unsigned int stouiDEF(const char* s, unsigned int n) {
+    int i = stoiDEF(s, n);
+    if (i < 0) {
+        ERROR("Negative unsigned integer", exception);
+    }
+    return static_cast<unsigned int> (i);
+}
+
+/**
+ * @Description fixed width field to double, e.g. a PDB column. The field is
+ * copied to a small stack buffer for strtod(), which rounds exactly as
+ * stodDEF(const string&) does.
+ * @param s first character of the field
+ * @param n width of the field
+ */
+double stodDEF(const char* s, unsigned int n) {
+    char buffer[64];
+    if (n >= sizeof (buffer))
+        return stodDEF(string(s, n));
+
+    memcpy(buffer, s, n);
+    buffer[n] = '\0';
+
+    char *end;
+    double d = strtod(buffer, &end);
+    if (end == buffer) {
+        cerr << "\"" << buffer << "\" is no double!!" << endl;
+        ERROR("Wrong format", exception);
+    }
+    return d;
+}
+
 /** 
  * @name of function sToVectorOfInt
  * @Description 
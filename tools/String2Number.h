@@ -44,6 +44,12 @@ long stolDEF(const string&);
 float stofDEF(const string&);
 // changes string into double:
 double stodDEF(const string&);
+// changes the n characters at s into integer, without copying:
+int stoiDEF(const char* s, unsigned int n);
+// changes the n characters at s into unsigned integer, without copying:
+unsigned int stouiDEF(const char* s, unsigned int n);
+// changes the n characters at s into double, without copying:
+double stodDEF(const char* s, unsigned int n);
 // changes string to vector of integer. Format: n1,n2,n3, ...
 vector<int> sToVectorOfIntDEF(const string&);
 // changes string to vector of unsigned integer. Format: n1,n2,n3, ...
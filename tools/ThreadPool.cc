@@ -0,0 +1,262 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @Description:        Work-stealing pool of worker threads.
+ */
+
+#include <ThreadPool.h>
+#include <unistd.h>
+
+using namespace Victor;
+
+// Worker running on the current thread, if any.
+static pthread_key_t sCurrentWorker;
+static pthread_once_t sKeyOnce = PTHREAD_ONCE_INIT;
+
+static void
+sMakeKey() {
+    pthread_key_create(&sCurrentWorker, NULL);
+}
+
+/**
+ *  One worker of forEach(): runs items until the shared counter passes n.
+ */
+class ThreadPool::LoopTask : public ThreadPool::Task {
+public:
+
+    LoopTask(Loop& body, unsigned int n, unsigned int* next, unsigned int worker)
+    : body(body), n(n), next(next), worker(worker) {
+    }
+
+    virtual void run() {
+        for (;;) {
+            unsigned int i = __sync_fetch_and_add(next, 1);
+            if (i >= n)
+                break;
+            body.run(i, worker);
+        }
+    }
+
+private:
+    Loop& body;
+    unsigned int n;
+    unsigned int* next;
+    unsigned int worker;
+};
+
+/**
+ *  Starts the workers.
+ *@param threads number of worker threads, 0 = one per available CPU
+ */
+ThreadPool::ThreadPool(unsigned int threads) : queued(0), pending(0),
+nextWorker(0), stopping(false) {
+    pthread_once(&sKeyOnce, sMakeKey);
+    threads = getThreads(threads);
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&work, NULL);
+    pthread_cond_init(&done, NULL);
+
+    // all queues exist before any thread looks at them
+    for (unsigned int i = 0; i < threads; i++) {
+        Worker* w = new Worker;
+        w->pool = this;
+        w->id = i;
+        w->started = false;
+        pthread_mutex_init(&w->mutex, NULL);
+        workers.push_back(w);
+    }
+    // tasks dealt to a worker that could not start are stolen by the others
+    bool any = false;
+    for (unsigned int i = 0; i < threads; i++) {
+        workers[i]->started = (pthread_create(&workers[i]->thread, NULL, pRun,
+                workers[i]) == 0);
+        any = any || workers[i]->started;
+    }
+    if (!any)
+        ERROR("ThreadPool: could not start any thread.", exception);
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&work);
+    pthread_mutex_unlock(&mutex);
+    for (unsigned int i = 0; i < workers.size(); i++)
+        if (workers[i]->started)
+            pthread_join(workers[i]->thread, NULL);
+    // only now: a worker still running may look into any queue
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        pthread_mutex_destroy(&workers[i]->mutex);
+        delete workers[i];
+    }
+    pthread_cond_destroy(&done);
+    pthread_cond_destroy(&work);
+    pthread_mutex_destroy(&mutex);
+}
+
+/**
+ *  Resolves a number of threads.
+ *@param threads number of threads, 0 = one per available CPU
+ *@return threads, or the number of available CPUs if 0
+ */
+unsigned int
+ThreadPool::getThreads(unsigned int threads) {
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? static_cast<unsigned int> (cpus) : 1;
+    }
+    return threads;
+}
+
+/**
+ *  Queues a task. Called from a worker of this pool, the task goes to the
+ *  worker's own queue.
+ *@param task task to run, must live until it has run
+ *@return void
+ */
+void
+ThreadPool::submit(Task* task) {
+    PRECOND(task != NULL, exception);
+    Worker* self = static_cast<Worker*> (pthread_getspecific(sCurrentWorker));
+    unsigned int id;
+    if ((self != NULL) && (self->pool == this))
+        id = self->id;
+    else {
+        pthread_mutex_lock(&mutex);
+        id = nextWorker;
+        nextWorker = (nextWorker + 1) % workers.size();
+        pthread_mutex_unlock(&mutex);
+    }
+
+    // counted before pTake() can decrement: it needs mutex to do so
+    pthread_mutex_lock(&mutex);
+    pthread_mutex_lock(&workers[id]->mutex);
+    workers[id]->tasks.push_back(task);
+    pthread_mutex_unlock(&workers[id]->mutex);
+    queued++;
+    pending++;
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&mutex);
+}
+
+/**
+ *  Blocks until every task submitted so far has run. Must not be called
+ *  from a task.
+ *@return void
+ */
+void
+ThreadPool::wait() {
+    pthread_mutex_lock(&mutex);
+    while (pending > 0)
+        pthread_cond_wait(&done, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+/**
+ *  Runs body for items 0 to n - 1 on up to threads threads and returns 
+ *  when all have run. Items are taken in order from a shared counter, so
+ *  uneven items balance out. With one thread (or item) the loop runs on
+ *  the calling thread as worker 0.
+ *@param n number of items
+ *@param body loop body
+ *@param threads number of threads, 0 = one per available CPU
+ *@return void
+ */
+void
+ThreadPool::forEach(unsigned int n, Loop& body, unsigned int threads) {
+    threads = getThreads(threads);
+    if (threads > n)
+        threads = n;
+    if (threads <= 1) {
+        for (unsigned int i = 0; i < n; i++)
+            body.run(i, 0);
+        return;
+    }
+
+    unsigned int next = 0;
+    vector<LoopTask*> tasks;
+    ThreadPool pool(threads);
+    for (unsigned int w = 0; w < threads; w++) {
+        tasks.push_back(new LoopTask(body, n, &next, w));
+        pool.submit(tasks.back());
+    }
+    pool.wait();
+    for (unsigned int w = 0; w < threads; w++)
+        delete tasks[w];
+}
+
+/**
+ *  Main loop of a worker thread.
+ */
+void*
+ThreadPool::pRun(void* arg) {
+    Worker* self = static_cast<Worker*> (arg);
+    ThreadPool& pool = *self->pool;
+    pthread_setspecific(sCurrentWorker, self);
+
+    for (;;) {
+        Task* task = NULL;
+        if (pool.pTake(self->id, task)) {
+            task->run();
+            pthread_mutex_lock(&pool.mutex);
+            if (--pool.pending == 0)
+                pthread_cond_broadcast(&pool.done);
+            pthread_mutex_unlock(&pool.mutex);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool.mutex);
+        while ((pool.queued == 0) && !pool.stopping)
+            pthread_cond_wait(&pool.work, &pool.mutex);
+        bool finished = pool.stopping && (pool.queued == 0);
+        pthread_mutex_unlock(&pool.mutex);
+        if (finished)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ *  Takes the newest task of worker id or, if there is none, the oldest
+ *  task of another worker.
+ */
+bool
+ThreadPool::pTake(unsigned int id, Task*& task) {
+    task = NULL;
+    unsigned int n = workers.size();
+    for (unsigned int k = 0; (k < n) && (task == NULL); k++) {
+        Worker* w = workers[(id + k) % n];
+        pthread_mutex_lock(&w->mutex);
+        if (!w->tasks.empty()) {
+            if (k == 0) {
+                task = w->tasks.back();
+                w->tasks.pop_back();
+            } else {
+                task = w->tasks.front();
+                w->tasks.pop_front();
+            }
+        }
+        pthread_mutex_unlock(&w->mutex);
+    }
+    if (task == NULL)
+        return false;
+
+    pthread_mutex_lock(&mutex);
+    queued--;
+    pthread_mutex_unlock(&mutex);
+    return true;
+}
@@ -0,0 +1,119 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @Description:        Work-stealing pool of worker threads.
+ */
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <Debug.h>
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+namespace Victor {
+
+    /**
+     *  Runs Tasks on a fixed set of worker threads. Each worker owns a 
+     *  queue: tasks submitted by a worker (e.g. subtasks of a task) go to 
+     *  its own queue and are taken back last in first out, tasks submitted
+     *  by other threads are dealt round robin. An idle worker first empties
+     *  its own queue, then steals the oldest task of another worker, so 
+     *  uneven tasks (structures of very different size) keep all threads 
+     *  busy. Tasks are not owned by the pool.
+     *  forEach() runs the items of a loop on a temporary pool, each worker
+     *  taking the next item from a shared counter.
+     */
+    class ThreadPool {
+    public:
+
+        /// Unit of work run by the pool.
+
+        class Task {
+        public:
+
+            virtual ~Task() {
+            }
+            virtual void run() = 0;
+        };
+
+        /// Body of a parallel loop, see forEach().
+
+        class Loop {
+        public:
+
+            virtual ~Loop() {
+            }
+            // worker (0 <= worker < threads) identifies per-thread state
+            virtual void run(unsigned int i, unsigned int worker) = 0;
+        };
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        ThreadPool(unsigned int threads = 0); // 0 = one per available CPU
+        virtual ~ThreadPool(); // waits for all tasks
+
+        // PREDICATES:
+
+        unsigned int size() const {
+            return workers.size();
+        }
+
+        static unsigned int getThreads(unsigned int threads); // 0 = one per CPU
+
+        // MODIFIERS:
+        void submit(Task* task);
+        void wait(); // until all submitted tasks have run
+
+        static void forEach(unsigned int n, Loop& body, unsigned int threads = 0);
+
+    private:
+
+        /// Worker thread with its own task queue.
+
+        struct Worker {
+            ThreadPool* pool;
+            unsigned int id;
+            pthread_t thread;
+            bool started;
+            pthread_mutex_t mutex; // guards tasks
+            deque<Task*> tasks;
+        };
+
+        class LoopTask;
+
+        // HELPERS:
+        static void* pRun(void* arg);
+        bool pTake(unsigned int id, Task*& task);
+
+        // not copyable: the pool owns its threads
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        // ATTRIBUTES:
+        vector<Worker*> workers;
+        pthread_mutex_t mutex; // guards the counters below
+        pthread_cond_t work; // signalled when a task is queued
+        pthread_cond_t done; // signalled when pending drops to 0
+        unsigned long queued; // tasks in the worker queues
+        unsigned long pending; // tasks submitted and not finished
+        unsigned int nextWorker; // round robin for external submits
+        bool stopping;
+    };
+
+} // namespace
+
+#endif